@@ -0,0 +1,58 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+
+#include "core/NextTensor.h"
+#include "utils/NextOps.h"
+
+namespace NextBench {
+    /**
+     *  @brief Heap allocations made by the whole process so far (global operator new, see bench_main.cpp)
+     * **/
+    size_t AllocationCount();
+
+    /**
+     *  @brief Reports allocations per iteration as the allocs_per_iter counter when it goes out of scope
+     * **/
+    class AllocationCounter {
+    private:
+        benchmark::State& m_State;
+        size_t m_Start;
+
+    public:
+        explicit AllocationCounter(benchmark::State& state) : m_State(state), m_Start(AllocationCount()) {}
+
+        ~AllocationCounter() {
+            m_State.counters["allocs_per_iter"] = benchmark::Counter(
+                static_cast<double>(AllocationCount() - m_Start), benchmark::Counter::kAvgIterations);
+        }
+    };
+
+    /**
+     *  @brief Tensor of the given shape with reproducible values in [1, 2)
+     * **/
+    template<typename T>
+    Next::NextTensor<T> MakeTensor(const Next::Dims& shape, uint32_t seed = 42) {
+        Next::NextTensor<T> tensor{shape};
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> dist(1.0, 2.0);
+        for (size_t i = 0; i < tensor.Size(); i++) {
+            tensor[i] = static_cast<T>(dist(rng));
+        }
+        return tensor;
+    }
+
+    /**
+     *  @brief Common throughput counters for an op touching bytes per iteration
+     * **/
+    inline void SetThroughput(benchmark::State& state, size_t elements, size_t bytes) {
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * elements));
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    }
+}
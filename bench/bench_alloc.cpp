@@ -0,0 +1,48 @@
+//
+// Created by eren on 10/17/26.
+//
+
+// Cost of creating (zero-initialized) tensors of growing size with each storage allocator.
+
+#include "BenchCommon.h"
+
+namespace {
+    enum class Source {
+        Caching,
+        System,
+        Arena
+    };
+
+    template<typename T, Source S>
+    void BM_Allocate(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto previous = Next::GetAllocator();
+        if constexpr (S == Source::System) Next::SetAllocator(std::make_shared<Next::SystemAllocator>());
+        else Next::SetAllocator(std::make_shared<Next::CachingAllocator>());
+
+        for (auto _ : state) {
+            if constexpr (S == Source::Arena) {
+                Next::ArenaScope arena;
+                Next::NextTensor<T> tensor{{n}};
+                benchmark::DoNotOptimize(tensor.Data());
+            } else {
+                Next::NextTensor<T> tensor{{n}};
+                benchmark::DoNotOptimize(tensor.Data());
+            }
+        }
+
+        Next::SetAllocator(previous);
+        NextBench::SetThroughput(state, n, n * sizeof(T));
+    }
+
+    void Sizes(benchmark::internal::Benchmark* b) {
+        b->ArgName("elements")->RangeMultiplier(16)->Range(16, 16 << 20);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_Allocate, float, Source::Caching)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Allocate, float, Source::System)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Allocate, float, Source::Arena)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Allocate, double, Source::Caching)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Allocate, int64_t, Source::Caching)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Allocate, uint8_t, Source::Caching)->Apply(Sizes);
@@ -0,0 +1,250 @@
+//
+// Created by eren on 10/17/26.
+//
+
+// Element-wise ops on n x n operands read through four layouts: contiguous, transposed views (every inner
+// step strided), column slices of a 2n-wide tensor (contiguous rows, gaps between them) and 8 x n x n/8
+// views of a transposed 3-D tensor (short strided rows, where walking the outer dimensions is the cost).
+
+#include "BenchCommon.h"
+
+namespace {
+    enum class Layout {
+        Contiguous,
+        Transposed,
+        Sliced,
+        Transposed3D
+    };
+
+    template<typename T>
+    Next::NextTensor<T> MakeOperand(Layout layout, size_t n, uint32_t seed) {
+        switch (layout) {
+            case Layout::Transposed: return NextBench::MakeTensor<T>({n, n}, seed).transpose(0, 1);
+            case Layout::Sliced: return NextBench::MakeTensor<T>({n, 2 * n}, seed).slice(1, 0, n);
+            case Layout::Transposed3D: return NextBench::MakeTensor<T>({n / 8, n, 8}, seed).transpose(0, 2);
+            default: return NextBench::MakeTensor<T>({n, n}, seed);
+        }
+    }
+
+    template<typename T, Layout L>
+    void BM_Add(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = MakeOperand<T>(L, n, 1);
+        auto b = MakeOperand<T>(L, n, 2);
+        for (auto _ : state) {
+            auto c = a.add(b);
+            benchmark::DoNotOptimize(c.Data());
+        }
+        NextBench::SetThroughput(state, n * n, 3 * n * n * sizeof(T));
+    }
+
+    template<typename T, Layout L>
+    void BM_AddInPlace(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = MakeOperand<T>(L, n, 1);
+        auto b = MakeOperand<T>(L, n, 2);
+        for (auto _ : state) {
+            a += b;
+            benchmark::ClobberMemory();
+        }
+        NextBench::SetThroughput(state, n * n, 3 * n * n * sizeof(T));
+    }
+
+    // Same traffic as BM_Add into a reused destination, allocs_per_iter should read zero
+    template<typename T, Layout L>
+    void BM_AddOut(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = MakeOperand<T>(L, n, 1);
+        auto b = MakeOperand<T>(L, n, 2);
+        Next::NextTensor<T> out(a.Shape());
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            a.add(b, out);
+            benchmark::ClobberMemory();
+        }
+        NextBench::SetThroughput(state, n * n, 3 * n * n * sizeof(T));
+    }
+
+    // Materializing a transposed / sliced view, the copy kernels behind contiguous() and reshape()
+    template<typename T, Layout L>
+    void BM_Contiguous(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = MakeOperand<T>(L, n, 1);
+        for (auto _ : state) {
+            auto c = a.clone();
+            benchmark::DoNotOptimize(c.Data());
+        }
+        NextBench::SetThroughput(state, n * n, 2 * n * n * sizeof(T));
+    }
+
+    template<typename Src, typename Dst>
+    void BM_Convert(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<Src>({n, n}, 1);
+        for (auto _ : state) {
+            auto c = a.template to<Dst>();
+            benchmark::DoNotOptimize(c.Data());
+        }
+        NextBench::SetThroughput(state, n * n, n * n * (sizeof(Src) + sizeof(Dst)));
+    }
+
+    template<typename T, Layout L>
+    void BM_Fill(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = MakeOperand<T>(L, n, 1);
+        for (auto _ : state) {
+            a.fill(T{3});
+            benchmark::ClobberMemory();
+        }
+        NextBench::SetThroughput(state, n * n, n * n * sizeof(T));
+    }
+
+    // a * b + a evaluated eagerly (two temporaries) and as one fused expression
+    template<typename T>
+    void BM_MulAddEager(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        auto b = NextBench::MakeTensor<T>({n, n}, 2);
+        for (auto _ : state) {
+            auto c = a.mult(b).add(a);
+            benchmark::DoNotOptimize(c.Data());
+        }
+        NextBench::SetThroughput(state, n * n, 3 * n * n * sizeof(T));
+    }
+
+    template<typename T>
+    void BM_MulAddFused(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        auto b = NextBench::MakeTensor<T>({n, n}, 2);
+        for (auto _ : state) {
+            Next::NextTensor<T> c = a * b + a;
+            benchmark::DoNotOptimize(c.Data());
+        }
+        NextBench::SetThroughput(state, n * n, 3 * n * n * sizeof(T));
+    }
+
+    // a / b eagerly and as a fused expression (a / b + a); divisors are in [1, 2), so never zero
+    template<typename T>
+    void BM_Divide(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        auto b = NextBench::MakeTensor<T>({n, n}, 2);
+        Next::NextTensor<T> out({n, n});
+        for (auto _ : state) {
+            a.divide(b, out);
+            benchmark::ClobberMemory();
+        }
+        NextBench::SetThroughput(state, n * n, 3 * n * n * sizeof(T));
+    }
+
+    template<typename T>
+    void BM_DivideFused(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        auto b = NextBench::MakeTensor<T>({n, n}, 2);
+        for (auto _ : state) {
+            Next::NextTensor<T> c = a / b + a;
+            benchmark::DoNotOptimize(c.Data());
+        }
+        NextBench::SetThroughput(state, n * n, 3 * n * n * sizeof(T));
+    }
+
+    template<typename T, Next::Math::UnaryOp Op>
+    void BM_Unary(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        Next::NextTensor<T> out({n, n});
+        for (auto _ : state) {
+            if constexpr (Op == Next::Math::UnaryOp::EXP) a.exp(out);
+            else if constexpr (Op == Next::Math::UnaryOp::LOG) a.log(out);
+            else if constexpr (Op == Next::Math::UnaryOp::TANH) a.tanh(out);
+            else if constexpr (Op == Next::Math::UnaryOp::SIGMOID) a.sigmoid(out);
+            else a.gelu(out);
+            benchmark::ClobberMemory();
+        }
+        NextBench::SetThroughput(state, n * n, 2 * n * n * sizeof(T));
+    }
+
+    // GELU(x + bias) over n rows with one bias row: add then activate (one temporary) and fused
+    template<typename T>
+    void BM_BiasGeluEager(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        auto bias = NextBench::MakeTensor<T>({n}, 2);
+        for (auto _ : state) {
+            auto c = a.add(bias).gelu();
+            benchmark::DoNotOptimize(c.Data());
+        }
+        NextBench::SetThroughput(state, n * n, 2 * n * n * sizeof(T));
+    }
+
+    template<typename T>
+    void BM_BiasGeluFused(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        auto bias = NextBench::MakeTensor<T>({n}, 2);
+        for (auto _ : state) {
+            auto c = a.bias_activation(bias, Next::Math::UnaryOp::GELU);
+            benchmark::DoNotOptimize(c.Data());
+        }
+        NextBench::SetThroughput(state, n * n, 2 * n * n * sizeof(T));
+    }
+
+    void Sizes(benchmark::internal::Benchmark* b) {
+        b->ArgName("n")->Arg(64)->Arg(256)->Arg(1024)->Arg(2048);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_Add, float, Layout::Contiguous)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Add, float, Layout::Transposed)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Add, float, Layout::Sliced)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Add, float, Layout::Transposed3D)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Add, double, Layout::Contiguous)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Add, int32_t, Layout::Contiguous)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Add, uint8_t, Layout::Contiguous)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Add, Next::Half, Layout::Contiguous)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Add, Next::BFloat16, Layout::Contiguous)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_AddInPlace, float, Layout::Contiguous)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_AddInPlace, float, Layout::Transposed)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_AddInPlace, float, Layout::Sliced)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_AddInPlace, float, Layout::Transposed3D)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_AddOut, float, Layout::Contiguous)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_AddOut, float, Layout::Transposed)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_AddOut, float, Layout::Transposed3D)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_Contiguous, float, Layout::Transposed)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Contiguous, double, Layout::Transposed)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Contiguous, float, Layout::Sliced)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_Convert, float, Next::Half)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Convert, Next::Half, float)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Convert, float, Next::BFloat16)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Convert, Next::BFloat16, float)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_Fill, float, Layout::Contiguous)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Fill, float, Layout::Transposed)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Fill, float, Layout::Sliced)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Fill, double, Layout::Contiguous)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_MulAddEager, float)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_MulAddFused, float)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_Divide, float)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Divide, double)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Divide, int32_t)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_DivideFused, float)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_DivideFused, int32_t)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_Unary, float, Next::Math::UnaryOp::EXP)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Unary, float, Next::Math::UnaryOp::LOG)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Unary, float, Next::Math::UnaryOp::TANH)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Unary, float, Next::Math::UnaryOp::SIGMOID)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Unary, float, Next::Math::UnaryOp::GELU)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Unary, double, Next::Math::UnaryOp::GELU)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Unary, Next::Half, Next::Math::UnaryOp::GELU)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_BiasGeluEager, float)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_BiasGeluFused, float)->Apply(Sizes);
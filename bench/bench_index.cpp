@@ -0,0 +1,133 @@
+//
+// Created by eren on 10/17/26.
+//
+
+// Indexing kernels: embedding-style row lookups, element gathers, scatter_add as a histogram (many updates,
+// few bins) and as an embedding gradient (whole rows into a large table), and boolean mask selection.
+
+#include "BenchCommon.h"
+
+namespace {
+    Next::NextTensor<int64_t> MakeIndices(const Next::Dims& shape, size_t bound, uint32_t seed) {
+        Next::NextTensor<int64_t> index{shape};
+        std::mt19937 rng(seed);
+        for (size_t i = 0; i < index.Size(); i++) {
+            index[i] = static_cast<int64_t>(rng() % bound);
+        }
+        return index;
+    }
+
+    constexpr size_t TableRows = 50000;
+    constexpr size_t Lookups = 4096;
+
+    // Lookups random rows of a TableRows x d table
+    void BM_IndexSelectRows(benchmark::State& state) {
+        const auto d = static_cast<size_t>(state.range(0));
+        const auto table = NextBench::MakeTensor<float>({TableRows, d}, 1);
+        const auto ids = MakeIndices({Lookups}, TableRows, 2);
+        for (auto _ : state) {
+            auto rows = table.index_select(0, ids);
+            benchmark::DoNotOptimize(rows.Data());
+        }
+        NextBench::SetThroughput(state, Lookups * d, 2 * Lookups * d * sizeof(float));
+    }
+
+    // The same lookup written element by element through operator(), what index_select replaces
+    void BM_IndexSelectScalarLoop(benchmark::State& state) {
+        const auto d = static_cast<size_t>(state.range(0));
+        const auto table = NextBench::MakeTensor<float>({TableRows, d}, 1);
+        const auto ids = MakeIndices({Lookups}, TableRows, 2);
+        for (auto _ : state) {
+            Next::NextTensor<float> rows({Lookups, d});
+            for (size_t i = 0; i < Lookups; i++) {
+                for (size_t j = 0; j < d; j++) {
+                    rows(i, j) = table(static_cast<size_t>(ids(i)), j);
+                }
+            }
+            benchmark::DoNotOptimize(rows.Data());
+        }
+        NextBench::SetThroughput(state, Lookups * d, 2 * Lookups * d * sizeof(float));
+    }
+
+    // The scalar loop through accessors taken once, which leaves a plain multiply-add per element
+    void BM_IndexSelectAccessorLoop(benchmark::State& state) {
+        const auto d = static_cast<size_t>(state.range(0));
+        const auto table = NextBench::MakeTensor<float>({TableRows, d}, 1);
+        const auto ids = MakeIndices({Lookups}, TableRows, 2);
+        for (auto _ : state) {
+            Next::NextTensor<float> rows({Lookups, d});
+            const auto in = table.accessor<2>();
+            const auto ix = ids.accessor<1>();
+            auto out = rows.accessor<2>();
+            for (size_t i = 0; i < Lookups; i++) {
+                for (size_t j = 0; j < d; j++) {
+                    out(i, j) = in(static_cast<size_t>(ix[i]), j);
+                }
+            }
+            benchmark::DoNotOptimize(rows.Data());
+        }
+        NextBench::SetThroughput(state, Lookups * d, 2 * Lookups * d * sizeof(float));
+    }
+
+    // n x n gather along the rows with random column indices
+    void BM_Gather(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto src = NextBench::MakeTensor<float>({n, n}, 1);
+        const auto index = MakeIndices({n, n}, n, 2);
+        for (auto _ : state) {
+            auto out = src.gather(1, index);
+            benchmark::DoNotOptimize(out.Data());
+        }
+        NextBench::SetThroughput(state, n * n, n * n * (2 * sizeof(float) + sizeof(int64_t)));
+    }
+
+    // n values added into 256 bins, the partial-buffer path
+    void BM_ScatterAddHistogram(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto values = NextBench::MakeTensor<float>({n}, 1);
+        const auto bins = MakeIndices({n}, 256, 2);
+        Next::NextTensor<float> histogram({256});
+        for (auto _ : state) {
+            histogram.zeros();
+            histogram.scatter_add(0, bins, values);
+            benchmark::ClobberMemory();
+        }
+        NextBench::SetThroughput(state, n, n * (sizeof(float) + sizeof(int64_t)));
+    }
+
+    // Gradient of BM_IndexSelectRows: Lookups rows of width d added into the table
+    void BM_ScatterAddRows(benchmark::State& state) {
+        const auto d = static_cast<size_t>(state.range(0));
+        const auto grad = NextBench::MakeTensor<float>({Lookups, d}, 1);
+        const auto ids = MakeIndices({Lookups, 1}, TableRows, 2).expand({Lookups, d});
+        Next::NextTensor<float> table({TableRows, d});
+        for (auto _ : state) {
+            table.scatter_add(0, ids, grad);
+            benchmark::ClobberMemory();
+        }
+        NextBench::SetThroughput(state, Lookups * d, 3 * Lookups * d * sizeof(float));
+    }
+
+    void BM_MaskedSelect(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto src = NextBench::MakeTensor<float>({n, n}, 1);
+        Next::NextTensor<bool> mask({n, n});
+        std::mt19937 rng(2);
+        for (size_t i = 0; i < mask.Size(); i++) {
+            mask[i] = (rng() & 1) != 0;
+        }
+        for (auto _ : state) {
+            auto out = src.masked_select(mask);
+            benchmark::DoNotOptimize(out.Data());
+        }
+        NextBench::SetThroughput(state, n * n, n * n * (sizeof(float) + sizeof(bool)));
+    }
+}
+
+BENCHMARK(BM_IndexSelectRows)->ArgName("d")->Arg(16)->Arg(128)->Arg(512);
+BENCHMARK(BM_IndexSelectScalarLoop)->ArgName("d")->Arg(16)->Arg(128)->Arg(512);
+BENCHMARK(BM_IndexSelectAccessorLoop)->ArgName("d")->Arg(16)->Arg(128)->Arg(512);
+BENCHMARK(BM_Gather)->ArgName("n")->Arg(256)->Arg(1024);
+BENCHMARK(BM_ScatterAddHistogram)->ArgName("n")->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_ScatterAddRows)->ArgName("d")->Arg(16)->Arg(128)->Arg(512);
+BENCHMARK(BM_MaskedSelect)->ArgName("n")->Arg(256)->Arg(1024);
@@ -0,0 +1,100 @@
+//
+// Created by eren on 10/17/26.
+//
+
+// Matrix products and reductions, the compute-bound kernels whose regressions elementwise numbers miss.
+
+#include "BenchCommon.h"
+#include "core/QuantizedTensor.h"
+
+namespace {
+    template<typename T>
+    void BM_Matmul(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        auto b = NextBench::MakeTensor<T>({n, n}, 2);
+        for (auto _ : state) {
+            auto c = a.matmul(b);
+            benchmark::DoNotOptimize(c.Data());
+        }
+        state.counters["flops"] = benchmark::Counter(static_cast<double>(2 * n * n * n),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    template<typename T>
+    void BM_MatmulOut(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        auto b = NextBench::MakeTensor<T>({n, n}, 2);
+        Next::NextTensor<T> c({n, n});
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            a.matmul(b, c);
+            benchmark::ClobberMemory();
+        }
+        state.counters["flops"] = benchmark::Counter(static_cast<double>(2 * n * n * n),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    template<typename T>
+    void BM_MatmulTransposedB(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        auto b = NextBench::MakeTensor<T>({n, n}, 2).transpose(0, 1);
+        for (auto _ : state) {
+            auto c = a.matmul(b);
+            benchmark::DoNotOptimize(c.Data());
+        }
+        state.counters["flops"] = benchmark::Counter(static_cast<double>(2 * n * n * n),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    // Quantized product of float operands quantized once outside the loop, requantization included
+    void BM_MatmulQuantized(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto a = Next::Quantize(NextBench::MakeTensor<float>({n, n}, 1));
+        const auto b = Next::Quantize(NextBench::MakeTensor<float>({n, n}, 2), size_t{1}, true);
+        const auto output = Next::QuantParams::PerTensor(static_cast<float>(n) / 64.0f);
+        for (auto _ : state) {
+            auto c = a.matmul(b, output);
+            benchmark::DoNotOptimize(c.Values().Data());
+        }
+        state.counters["flops"] = benchmark::Counter(static_cast<double>(2 * n * n * n),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    // range(1) selects the reduced axes: 0 = every axis, 1 = rows (axis 1), 2 = columns (axis 0)
+    template<typename T>
+    void BM_Sum(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n});
+        const Next::Dims axes = state.range(1) == 0 ? Next::Dims{} : state.range(1) == 1 ? Next::Dims{1} : Next::Dims{0};
+        for (auto _ : state) {
+            auto s = a.sum(axes);
+            benchmark::DoNotOptimize(s.Data());
+        }
+        NextBench::SetThroughput(state, n * n, n * n * sizeof(T));
+    }
+
+    template<typename T>
+    void BM_ArgMax(benchmark::State& state) {
+        const auto n = static_cast<size_t>(state.range(0));
+        auto a = NextBench::MakeTensor<T>({n, n});
+        const auto axis = static_cast<size_t>(state.range(1));
+        for (auto _ : state) {
+            auto s = a.argmax(axis);
+            benchmark::DoNotOptimize(s.Data());
+        }
+        NextBench::SetThroughput(state, n * n, n * n * sizeof(T));
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_Matmul, float)->ArgName("n")->RangeMultiplier(2)->Range(64, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Matmul, double)->ArgName("n")->RangeMultiplier(2)->Range(64, 512)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MatmulOut, float)->ArgName("n")->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MatmulQuantized)->ArgName("n")->RangeMultiplier(2)->Range(64, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MatmulTransposedB, float)->ArgName("n")->Arg(256)->Arg(512)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_Sum, float)->ArgNames({"n", "axes"})->ArgsProduct({{256, 2048}, {0, 1, 2}});
+BENCHMARK_TEMPLATE(BM_Sum, double)->ArgNames({"n", "axes"})->ArgsProduct({{2048}, {0, 1, 2}});
+BENCHMARK_TEMPLATE(BM_ArgMax, float)->ArgNames({"n", "axis"})->ArgsProduct({{2048}, {0, 1}});
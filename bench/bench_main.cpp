@@ -0,0 +1,55 @@
+//
+// Created by eren on 10/17/26.
+//
+
+// Entry point of nexttensor_bench. Every benchmark binary flag works, e.g.
+//   nexttensor_bench --benchmark_filter=Add --benchmark_out=results.json --benchmark_out_format=json
+// NEXT_BENCH_THREADS=<n> sets the intra-op thread count before anything runs.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "BenchCommon.h"
+
+namespace {
+    std::atomic<size_t> g_Allocations{0};
+
+    const char* IsaName(Next::Simd::ISA isa) {
+        switch (isa) {
+            case Next::Simd::ISA::AVX512: return "avx512";
+            case Next::Simd::ISA::AVX2: return "avx2";
+            case Next::Simd::ISA::SSE41: return "sse4.1";
+            default: return "scalar";
+        }
+    }
+}
+
+size_t NextBench::AllocationCount() {
+    return g_Allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t bytes) {
+    g_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(bytes > 0 ? bytes : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+int main(int argc, char** argv) {
+    if (const char* threads = std::getenv("NEXT_BENCH_THREADS")) {
+        Next::SetNumThreads(std::stoul(threads));
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::AddCustomContext("nexttensor_isa", IsaName(Next::Simd::GetISA()));
+    benchmark::AddCustomContext("nexttensor_threads", std::to_string(Next::GetNumThreads()));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,117 @@
+//
+// Created by eren on 10/17/26.
+//
+
+// Thread scaling of the parallel kernels: each op runs at every intra-op thread count from 1 to the hardware
+// concurrency (the threads argument, set with SetNumThreads) and reports its speedup over a serial run of the
+// same op, timed once per benchmark. Timings are wall clock, the only meaningful measure once work is spread
+// over threads.
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "BenchCommon.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const int MaxThreads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+
+    /**
+     *  @brief Sets the intra-op thread count for one benchmark run and restores the previous one afterwards
+     * **/
+    class ThreadCount {
+    private:
+        size_t m_Previous;
+
+    public:
+        explicit ThreadCount(size_t threads) : m_Previous(Next::GetNumThreads()) { Next::SetNumThreads(threads); }
+
+        ~ThreadCount() { Next::SetNumThreads(m_Previous); }
+    };
+
+    /**
+     *  @brief Wall-clock seconds per call of fn with one thread
+     * **/
+    template<typename Fn>
+    double SerialSeconds(Fn&& fn) {
+        ThreadCount serial{1};
+        fn();
+        const auto start = Clock::now();
+        size_t calls = 0;
+        std::chrono::duration<double> elapsed{};
+        do {
+            fn();
+            calls++;
+            elapsed = Clock::now() - start;
+        } while (elapsed.count() < 0.2);
+        return elapsed.count() / static_cast<double>(calls);
+    }
+
+    /**
+     *  @brief speedup counter: serial seconds per call over the wall-clock seconds per iteration of the loop
+     *  that started at start
+     * **/
+    void SetSpeedup(benchmark::State& state, double serialSeconds, Clock::time_point start) {
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        state.counters["speedup"] = serialSeconds * static_cast<double>(state.iterations()) / elapsed.count();
+    }
+
+    template<typename T>
+    void BM_AddThreads(benchmark::State& state) {
+        constexpr size_t n = 2048;
+        const auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        const auto b = NextBench::MakeTensor<T>({n, n}, 2);
+        Next::NextTensor<T> out({n, n});
+        const auto run = [&] { a.add(b, out); };
+        static const double serial = SerialSeconds(run); // Shared by every thread count
+        ThreadCount threads{static_cast<size_t>(state.range(0))};
+        const auto start = Clock::now();
+        for (auto _ : state) {
+            run();
+            benchmark::ClobberMemory();
+        }
+        SetSpeedup(state, serial, start);
+        NextBench::SetThroughput(state, n * n, 3 * n * n * sizeof(T));
+    }
+
+    template<typename T>
+    void BM_SumThreads(benchmark::State& state) {
+        constexpr size_t n = 2048;
+        const auto a = NextBench::MakeTensor<T>({n, n});
+        const auto run = [&] { benchmark::DoNotOptimize(a.sum().Data()); };
+        static const double serial = SerialSeconds(run); // Shared by every thread count
+        ThreadCount threads{static_cast<size_t>(state.range(0))};
+        const auto start = Clock::now();
+        for (auto _ : state) {
+            run();
+        }
+        SetSpeedup(state, serial, start);
+        NextBench::SetThroughput(state, n * n, n * n * sizeof(T));
+    }
+
+    template<typename T>
+    void BM_MatmulThreads(benchmark::State& state) {
+        constexpr size_t n = 512;
+        const auto a = NextBench::MakeTensor<T>({n, n}, 1);
+        const auto b = NextBench::MakeTensor<T>({n, n}, 2);
+        Next::NextTensor<T> c({n, n});
+        const auto run = [&] { a.matmul(b, c); };
+        static const double serial = SerialSeconds(run); // Shared by every thread count
+        ThreadCount threads{static_cast<size_t>(state.range(0))};
+        const auto start = Clock::now();
+        for (auto _ : state) {
+            run();
+            benchmark::ClobberMemory();
+        }
+        SetSpeedup(state, serial, start);
+        state.counters["flops"] = benchmark::Counter(static_cast<double>(2 * n * n * n),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_AddThreads, float)->ArgName("threads")->DenseRange(1, MaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SumThreads, float)->ArgName("threads")->DenseRange(1, MaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MatmulThreads, float)->ArgName("threads")->DenseRange(1, MaxThreads)->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,152 @@
+//
+// Created by eren on 10/17/26.
+//
+
+// View creation and small-tensor ops, where metadata handling rather than arithmetic is the cost. Shapes
+// live inline in NextMetadata, so views should report zero allocations and a small result tensor two (the
+// control block of its storage and its copy-on-write StorageCell).
+
+#include <utility>
+
+#include "BenchCommon.h"
+
+namespace {
+    void BM_TransposeView(benchmark::State& state) {
+        auto x = NextBench::MakeTensor<float>({8, 16, 32, 4});
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto view = x.transpose(1, 3);
+            benchmark::DoNotOptimize(view.Data());
+        }
+    }
+
+    void BM_SliceView(benchmark::State& state) {
+        auto x = NextBench::MakeTensor<float>({8, 16, 32, 4});
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto view = x.slice(2, 4, 20);
+            benchmark::DoNotOptimize(view.Data());
+        }
+    }
+
+    void BM_PermuteView(benchmark::State& state) {
+        auto x = NextBench::MakeTensor<float>({8, 16, 32, 4});
+        const Next::Dims dims{3, 1, 0, 2};
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto view = x.permute(dims);
+            benchmark::DoNotOptimize(view.Data());
+        }
+    }
+
+    void BM_StepSliceView(benchmark::State& state) {
+        auto x = NextBench::MakeTensor<float>({8, 16, 32, 4});
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto view = x.slice(2, 1, 32, 2);
+            benchmark::DoNotOptimize(view.Data());
+        }
+    }
+
+    void BM_SqueezeView(benchmark::State& state) {
+        auto x = NextBench::MakeTensor<float>({8, 1, 32, 4});
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto view = x.squeeze(1).unsqueeze(3);
+            benchmark::DoNotOptimize(view.Data());
+        }
+    }
+
+    void BM_FlattenView(benchmark::State& state) {
+        auto x = NextBench::MakeTensor<float>({8, 16, 32, 4});
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto view = x.flatten(1, 2);
+            benchmark::DoNotOptimize(view.Data());
+        }
+    }
+
+    void BM_ReshapeView(benchmark::State& state) {
+        auto x = NextBench::MakeTensor<float>({8, 16, 32, 4});
+        const Next::Dims shape{128, 128};
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto view = x.reshape(shape);
+            benchmark::DoNotOptimize(view.Data());
+        }
+    }
+
+    void BM_ExpandView(benchmark::State& state) {
+        auto x = NextBench::MakeTensor<float>({4, 4});
+        const Next::Dims shape{16, 4, 4};
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto view = x.expand(shape);
+            benchmark::DoNotOptimize(view.Data());
+        }
+    }
+
+    void BM_MetadataCopy(benchmark::State& state) {
+        auto x = NextBench::MakeTensor<float>({8, 16, 32, 4});
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            Next::NextMetadata metadata{x.Shape(), x.Strides(), x.GetDType(), x.Offset()};
+            benchmark::DoNotOptimize(metadata.Size());
+        }
+    }
+
+    // A tensor copy shares the elements: one StorageCell allocation and no element traffic
+    void BM_TensorCopy(benchmark::State& state) {
+        auto x = NextBench::MakeTensor<float>({8, 16, 32, 4});
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto copy = x;
+            benchmark::DoNotOptimize(std::as_const(copy).Data());
+        }
+    }
+
+    void BM_SmallAdd(benchmark::State& state) {
+        auto a = NextBench::MakeTensor<float>({4, 4}, 1);
+        auto b = NextBench::MakeTensor<float>({4, 4}, 2);
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto c = a.add(b);
+            benchmark::DoNotOptimize(c.Data());
+        }
+    }
+
+    // a * b + a through the eager methods, the baseline for BM_SmallFusedExpression
+    void BM_SmallEagerExpression(benchmark::State& state) {
+        auto a = NextBench::MakeTensor<float>({4, 4}, 1);
+        auto b = NextBench::MakeTensor<float>({4, 4}, 2);
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            auto c = a.mult(b).add(a);
+            benchmark::DoNotOptimize(c.Data());
+        }
+    }
+
+    void BM_SmallFusedExpression(benchmark::State& state) {
+        auto a = NextBench::MakeTensor<float>({4, 4}, 1);
+        auto b = NextBench::MakeTensor<float>({4, 4}, 2);
+        NextBench::AllocationCounter allocations{state};
+        for (auto _ : state) {
+            Next::NextTensor<float> c = a * b + a;
+            benchmark::DoNotOptimize(c.Data());
+        }
+    }
+}
+
+BENCHMARK(BM_TransposeView);
+BENCHMARK(BM_PermuteView);
+BENCHMARK(BM_SliceView);
+BENCHMARK(BM_StepSliceView);
+BENCHMARK(BM_SqueezeView);
+BENCHMARK(BM_FlattenView);
+BENCHMARK(BM_ReshapeView);
+BENCHMARK(BM_ExpandView);
+BENCHMARK(BM_MetadataCopy);
+BENCHMARK(BM_TensorCopy);
+BENCHMARK(BM_SmallAdd);
+BENCHMARK(BM_SmallEagerExpression);
+BENCHMARK(BM_SmallFusedExpression);
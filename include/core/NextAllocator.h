@@ -0,0 +1,314 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils/NextProfile.h"
+
+namespace Next {
+    inline constexpr size_t StorageAlignment = 64;   // Cache line / AVX-512 register width
+
+    //*
+    //@brief Counters every allocator keeps; all sizes are in bytes.
+    //*/
+    struct AllocatorStats {
+        size_t Allocations{0};      // Calls to Allocate
+        size_t Hits{0};             // Allocations served without asking the system (cache or arena chunk)
+        size_t Misses{0};           // Allocations that went to the system allocator
+        size_t BytesInUse{0};       // Bytes handed out and not yet returned
+        size_t BytesHeld{0};        // Bytes owned by the allocator but not in use (cache, free arena space)
+        size_t PeakBytesInUse{0};
+    };
+
+    //*
+    //@brief Storage allocator interface behind NextTensor; blocks are always StorageAlignment aligned.
+    //*/
+    class Allocator {
+    public:
+        virtual ~Allocator() = default;
+
+        virtual void* Allocate(size_t bytes) = 0;
+
+        virtual void Deallocate(void* ptr, size_t bytes) = 0;
+
+        [[nodiscard]] virtual AllocatorStats Stats() const = 0;
+    };
+
+    /**
+     *  @brief Aligned operator new/delete, no caching
+     * **/
+    class SystemAllocator : public Allocator {
+    private:
+        mutable std::mutex m_Mutex;
+        AllocatorStats m_Stats;
+
+    public:
+        void* Allocate(size_t bytes) override {
+            void* ptr = ::operator new(std::max<size_t>(bytes, 1), std::align_val_t{StorageAlignment});
+            std::lock_guard lock{m_Mutex};
+            m_Stats.Allocations++;
+            m_Stats.Misses++;
+            m_Stats.BytesInUse += bytes;
+            m_Stats.PeakBytesInUse = std::max(m_Stats.PeakBytesInUse, m_Stats.BytesInUse);
+            return ptr;
+        }
+
+        void Deallocate(void* ptr, size_t bytes) override {
+            ::operator delete(ptr, std::align_val_t{StorageAlignment});
+            std::lock_guard lock{m_Mutex};
+            m_Stats.BytesInUse -= bytes;
+        }
+
+        [[nodiscard]] AllocatorStats Stats() const override {
+            std::lock_guard lock{m_Mutex};
+            return m_Stats;
+        }
+    };
+
+    /**
+     *  @brief Keeps freed blocks in size buckets and hands them back to later requests of the same bucket
+     *
+     *  Buckets are a quarter of a power of two wide (e.g. 1024, 1280, 1536, 1792, 2048, ...), so a request
+     *  never wastes more than 25% and steady-state loops that allocate the same shapes never reach malloc.
+     *  At most cacheLimit bytes are kept; blocks freed past that go back to the system.
+     * **/
+    class CachingAllocator : public Allocator {
+    private:
+        mutable std::mutex m_Mutex;
+        std::unordered_map<size_t, std::vector<void*>> m_Buckets;
+        AllocatorStats m_Stats;
+        size_t m_CacheLimit;
+
+        static size_t BucketSize(size_t bytes) {
+            if (bytes <= StorageAlignment) return StorageAlignment;
+            const size_t step = std::max(std::bit_floor(bytes - 1) / 4, StorageAlignment);
+            return (bytes + step - 1) / step * step;
+        }
+
+    public:
+        explicit CachingAllocator(size_t cacheLimit = size_t{1} << 30) : m_CacheLimit(cacheLimit) {}
+
+        ~CachingAllocator() override {
+            EmptyCache();
+        }
+
+        void* Allocate(size_t bytes) override {
+            const size_t bucket = BucketSize(bytes);
+            {
+                std::lock_guard lock{m_Mutex};
+                m_Stats.Allocations++;
+                m_Stats.BytesInUse += bucket;
+                m_Stats.PeakBytesInUse = std::max(m_Stats.PeakBytesInUse, m_Stats.BytesInUse);
+                auto it = m_Buckets.find(bucket);
+                if (it != m_Buckets.end() && !it->second.empty()) {
+                    void* ptr = it->second.back();
+                    it->second.pop_back();
+                    m_Stats.Hits++;
+                    m_Stats.BytesHeld -= bucket;
+                    return ptr;
+                }
+                m_Stats.Misses++;
+            }
+            return ::operator new(bucket, std::align_val_t{StorageAlignment});
+        }
+
+        void Deallocate(void* ptr, size_t bytes) override {
+            const size_t bucket = BucketSize(bytes);
+            {
+                std::lock_guard lock{m_Mutex};
+                m_Stats.BytesInUse -= bucket;
+                if (m_Stats.BytesHeld + bucket <= m_CacheLimit) {
+                    m_Buckets[bucket].push_back(ptr);
+                    m_Stats.BytesHeld += bucket;
+                    return;
+                }
+            }
+            ::operator delete(ptr, std::align_val_t{StorageAlignment});
+        }
+
+        [[nodiscard]] AllocatorStats Stats() const override {
+            std::lock_guard lock{m_Mutex};
+            return m_Stats;
+        }
+
+        /**
+         *  @brief Return every cached block to the system
+         * **/
+        void EmptyCache() {
+            std::lock_guard lock{m_Mutex};
+            for (auto& [bucket, blocks] : m_Buckets) {
+                for (void* ptr : blocks) {
+                    ::operator delete(ptr, std::align_val_t{StorageAlignment});
+                }
+            }
+            m_Buckets.clear();
+            m_Stats.BytesHeld = 0;
+        }
+    };
+
+    /**
+     *  @brief Bump allocator: blocks are carved out of large chunks and only released with the arena
+     *
+     *  Individual frees are no-ops. Tensors keep the arena alive through their storage, so the chunks go away
+     *  once the arena's scope has ended and the last tensor allocated from it is destroyed.
+     * **/
+    class ArenaAllocator : public Allocator {
+    private:
+        struct Chunk {
+            std::byte* m_Data;
+            size_t m_Size;
+        };
+
+        mutable std::mutex m_Mutex;
+        std::vector<Chunk> m_Chunks;
+        size_t m_ChunkSize;
+        size_t m_Used{0};       // Bytes used in the last chunk
+        AllocatorStats m_Stats;
+
+    public:
+        explicit ArenaAllocator(size_t chunkSize = size_t{4} << 20) : m_ChunkSize(chunkSize) {}
+
+        ArenaAllocator(const ArenaAllocator&) = delete;
+        ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+        ~ArenaAllocator() override {
+            for (auto& chunk : m_Chunks) {
+                ::operator delete(chunk.m_Data, std::align_val_t{StorageAlignment});
+            }
+        }
+
+        void* Allocate(size_t bytes) override {
+            const size_t size = (std::max<size_t>(bytes, 1) + StorageAlignment - 1) / StorageAlignment * StorageAlignment;
+            std::lock_guard lock{m_Mutex};
+            m_Stats.Allocations++;
+            m_Stats.BytesInUse += size;
+            m_Stats.PeakBytesInUse = std::max(m_Stats.PeakBytesInUse, m_Stats.BytesInUse);
+            if (m_Chunks.empty() || m_Used + size > m_Chunks.back().m_Size) {
+                const size_t chunkSize = std::max(size, m_ChunkSize);
+                m_Chunks.push_back({static_cast<std::byte*>(::operator new(chunkSize, std::align_val_t{StorageAlignment})),
+                                    chunkSize});
+                m_Used = 0;
+                m_Stats.Misses++;
+                m_Stats.BytesHeld += chunkSize;
+            } else {
+                m_Stats.Hits++;
+            }
+            void* ptr = m_Chunks.back().m_Data + m_Used;
+            m_Used += size;
+            m_Stats.BytesHeld -= size;
+            return ptr;
+        }
+
+        void Deallocate(void*, size_t bytes) override {
+            const size_t size = (std::max<size_t>(bytes, 1) + StorageAlignment - 1) / StorageAlignment * StorageAlignment;
+            std::lock_guard lock{m_Mutex};
+            m_Stats.BytesInUse -= size;
+        }
+
+        [[nodiscard]] AllocatorStats Stats() const override {
+            std::lock_guard lock{m_Mutex};
+            return m_Stats;
+        }
+    };
+
+    namespace Detail {
+        struct AllocatorState {
+            std::mutex m_Mutex;
+            std::shared_ptr<Allocator> m_Default{std::make_shared<CachingAllocator>()};
+        };
+
+        inline AllocatorState& Allocators() {
+            static AllocatorState state;
+            return state;
+        }
+
+        inline thread_local std::shared_ptr<Allocator> t_ScopedAllocator;
+    }
+
+    /**
+     *  @brief Allocator new tensor storage comes from on this thread: the innermost ArenaScope, else the global one
+     * **/
+    inline std::shared_ptr<Allocator> GetAllocator() {
+        if (Detail::t_ScopedAllocator) return Detail::t_ScopedAllocator;
+        auto& state = Detail::Allocators();
+        std::lock_guard lock{state.m_Mutex};
+        return state.m_Default;
+    }
+
+    /**
+     *  @brief Replace the global allocator (default: CachingAllocator). Existing storage is returned to the
+     *  allocator it came from.
+     * **/
+    inline void SetAllocator(std::shared_ptr<Allocator> allocator) {
+        auto& state = Detail::Allocators();
+        std::lock_guard lock{state.m_Mutex};
+        state.m_Default = allocator ? std::move(allocator) : std::make_shared<SystemAllocator>();
+    }
+
+    /**
+     *  @brief Routes every tensor allocation of the current thread to a fresh arena while in scope
+     *
+     *  Meant for one request of an inference loop: intermediates are bump-allocated and the whole arena is
+     *  dropped at once. Tensors that outlive the scope stay valid, they just keep the arena's memory alive.
+     * **/
+    class ArenaScope {
+    private:
+        std::shared_ptr<ArenaAllocator> m_Arena;
+        std::shared_ptr<Allocator> m_Previous;
+
+    public:
+        explicit ArenaScope(size_t chunkSize = size_t{4} << 20)
+            : m_Arena(std::make_shared<ArenaAllocator>(chunkSize)), m_Previous(Detail::t_ScopedAllocator) {
+            Detail::t_ScopedAllocator = m_Arena;
+        }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+        ~ArenaScope() {
+            Detail::t_ScopedAllocator = std::move(m_Previous);
+        }
+
+        [[nodiscard]] const ArenaAllocator& Arena() const { return *m_Arena; }
+    };
+
+    /**
+     *  @brief Storage for count elements of T from the current allocator
+     *
+     *  With initialize == false trivially constructible types are left uninitialized; use it only when the
+     *  caller overwrites every element.
+     * **/
+    template<typename T>
+    std::shared_ptr<T[]> AllocateStorage(size_t count, bool initialize = true) {
+        static_assert(alignof(T) <= StorageAlignment, "Element type is over-aligned for tensor storage");
+        auto allocator = GetAllocator();
+        const size_t bytes = count * sizeof(T);
+        T* data = static_cast<T*>(allocator->Allocate(bytes));
+        NEXT_PROFILE_ALLOCATION();
+
+        if (initialize || !std::is_trivially_default_constructible_v<T>) {
+            try {
+                if (initialize) std::uninitialized_value_construct_n(data, count);
+                else std::uninitialized_default_construct_n(data, count);
+            } catch (...) {
+                allocator->Deallocate(data, bytes);
+                throw;
+            }
+        }
+
+        return std::shared_ptr<T[]>(data, [allocator, count, bytes](T* ptr) {
+            std::destroy_n(ptr, count);
+            allocator->Deallocate(ptr, bytes);
+        });
+    }
+}
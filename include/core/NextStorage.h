@@ -0,0 +1,59 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Next {
+    //*
+    //@brief Storage of one tensor value and all of its views, copied on write across values.
+    //
+    // Views (reshape, transpose, slice, expand, alias, Tensor::As, ...) share the cell of the tensor they are
+    // taken from, so a write through either is visible through both. Copying a tensor creates a new cell
+    // over the same element block: the copy itself is cheap, and the first write through any handle of
+    // either value moves that value, views included, onto a private clone of the block, so the other value
+    // never observes the write.
+    //
+    // Version counts the write accesses handed out through the cell (non-const element access and Data(),
+    // every op writing into the tensor); caches remember it and compare to detect mutation. Both checks run
+    // when a handle first asks to write: the cell is then Writable, and further writes skip them until the
+    // value is copied or its Version() is read again, so element-by-element writes cost a flag test. Pointers
+    // taken from the const Data() bypass both mechanisms. A value must not be copied or have its Version()
+    // read on one thread while it is written on another.
+    //*/
+    struct StorageCell {
+        std::shared_ptr<void> Data;       // Element block, shared with the cells of copies until one writes
+        size_t Bytes{0};                  // Extent of the block, what a detaching write clones
+        std::atomic<uint64_t> Version{0};
+        std::atomic<bool> Writable{false}; // Block private to this cell and Version bumped since last observed
+
+        StorageCell(std::shared_ptr<void> data, size_t bytes, uint64_t version = 0)
+            : Data(std::move(data)), Bytes(bytes), Version(version) {}
+
+        /**
+         *  @brief Cell of a copy of the value stored in cell: same block, same version
+         * **/
+        [[nodiscard]] static std::shared_ptr<StorageCell> Share(const std::shared_ptr<StorageCell>& cell) {
+            if (!cell) return nullptr;
+            cell->Writable.store(false, std::memory_order_relaxed);
+            return std::make_shared<StorageCell>(cell->Data, cell->Bytes, cell->Version.load(std::memory_order_relaxed));
+        }
+
+        /**
+         *  @brief Whether another value still reads the block, so the next write has to clone it first
+         * **/
+        [[nodiscard]] bool IsShared() const { return Data.use_count() > 1; }
+
+        /**
+         *  @brief Current version; the next write through the cell counts as a new one
+         * **/
+        [[nodiscard]] uint64_t ObserveVersion() {
+            Writable.store(false, std::memory_order_relaxed);
+            return Version.load(std::memory_order_relaxed);
+        }
+    };
+}
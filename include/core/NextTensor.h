@@ -4,199 +4,284 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <string>
+#include "NextAllocator.h"
 #include "NextMetadata.h"
+#include "NextStorage.h"
+#include "TensorAccessor.h"
+#include "../utils/BroadcastUtils.h"
+#include "../utils/NextCopy.h"
+#include "../utils/NextGemm.h"
+#include "../utils/NextIndex.h"
+#include "../utils/NextMath.h"
+#include "../utils/NextProfile.h"
+#include "../utils/NextExpr.h"
+#include "../utils/NextReduce.h"
+#include "../utils/NextView.h"
+#include "../utils/SimdKernels.h"
+#include "../utils/StridedIterator.h"
 
 namespace Next {
+    class Tensor;
+
+    //*
+    //@brief Strided tensor of element type T.
+    //
+    // Copies are values: a copied tensor shares its elements until either side writes, and the write then
+    // clones them (see StorageCell). Views returned by reshape, transpose, permute, slice, narrow, expand,
+    // squeeze, unsqueeze, flatten, as_strided and alias keep pointing at the same elements as the tensor they
+    // come from. Reading through a non-const handle counts as a write, so read shared tensors through const
+    // references to avoid the clone.
+    //*/
     template<typename T>
     class NextTensor {
     private:
-        NextMetadata m_Metadata;
-        std::shared_ptr<T[]> m_Data;
-
-        NextTensor(std::shared_ptr<T[]> data, NextMetadata metadata)
-            : m_Metadata(std::move(metadata)), m_Data(std::move(data)) {}
-    public:
-        explicit NextTensor(const std::vector<size_t>& shape)
-            : m_Metadata(shape, Next::TypeToDType<T>::value) {
-            if (m_Metadata.Size() > 0) {
-                m_Data = std::make_shared<T[]>(m_Metadata.Size());
-            }
-        }
-
-        explicit NextTensor(const std::vector<size_t>& shape, const std::vector<size_t>& strides, size_t offset = 0)
-            : m_Metadata(shape, strides, Next::TypeToDType<T>::value, offset) {
-            if (m_Metadata.Size() > 0) {
-                m_Data = std::make_shared<T[]>(m_Metadata.Size());
-            }
-        }
-
-        [[nodiscard]] DType GetDType() const { return m_Metadata.GetDType(); }
-
-        [[nodiscard]] const std::vector<size_t>& Shape() const { return m_Metadata.Shape(); }
+        template<typename> friend class NextTensor;
+        friend class Tensor;
 
-        [[nodiscard]] const std::vector<size_t>& Strides() const { return m_Metadata.Strides(); }
-
-        [[nodiscard]] size_t Offset() const { return m_Metadata.Offset(); }
-
-        [[nodiscard]] size_t Size() const { return m_Metadata.Size(); }
+        NextMetadata m_Metadata;
+        std::shared_ptr<StorageCell> m_Storage;
 
-        [[nodiscard]] size_t Rank() const { return m_Metadata.Rank(); }
+        struct Uninitialized {};
 
-        [[nodiscard]] bool IsContiguous() const { return  m_Metadata.IsContiguous(); }
+        /**
+         *  @brief Contiguous tensor whose elements are left uninitialized, for results that overwrite everything
+         * **/
+        NextTensor(const Dims& shape, Uninitialized)
+            : m_Metadata(shape, Next::TypeToDType<T>::value),
+              m_Storage(MakeStorage(m_Metadata.Size() > 0 ? Next::AllocateStorage<T>(m_Metadata.Size(), false) : nullptr,
+                                    m_Metadata.Size())) {}
 
-        [[nodiscard]] T* Data() const { return m_Data.get(); }
+        /**
+         *  @brief View: another handle on the storage cell of an existing tensor
+         * **/
+        NextTensor(std::shared_ptr<StorageCell> storage, NextMetadata metadata)
+            : m_Metadata(std::move(metadata)), m_Storage(std::move(storage)) {}
 
-        T* Data() { return m_Data.get(); }
+        static std::shared_ptr<StorageCell> MakeStorage(std::shared_ptr<T[]> data, size_t count) {
+            return std::make_shared<StorageCell>(std::move(data), count * sizeof(T));
+        }
 
         /**
-         *  @brief Safe data access with bound check
-         *
+         *  @brief Element block for writing; only the first write after a copy or a Version() read pays for
+         *  AcquireWrite
          * **/
-        template<typename... Args>
-        T& at(Args... args) {
-            static_assert(sizeof...(args) > 0, "Attempt to access Tensor with wrong index count");
+        T* MutableData() {
+            if (!m_Storage) return nullptr;
+            if (!m_Storage->Writable.load(std::memory_order_relaxed)) [[unlikely]] AcquireWrite();
+            return static_cast<T*>(m_Storage->Data.get());
+        }
 
-            if (m_Metadata.Rank() == 1 && sizeof...(args) == 1) {
-                const auto idx = static_cast<size_t>(std::get<0>(std::tuple{args...}));
-                if (idx >= m_Metadata.Shape()[0]) {
-                    throw std::invalid_argument("Index out of range");
-                }
-                return m_Data.get()[m_Metadata.Offset() + idx];
+        /**
+         *  @brief Clone the block while another value shares it, bump the version and mark the cell Writable
+         * **/
+        void AcquireWrite() {
+            if (m_Storage->IsShared()) {
+                const size_t count = m_Storage->Bytes / sizeof(T);
+                auto clone = Next::AllocateStorage<T>(count, false);
+                std::copy_n(static_cast<const T*>(m_Storage->Data.get()), count, clone.get());
+                m_Storage->Data = std::move(clone);
             }
+            m_Storage->Version.fetch_add(1, std::memory_order_relaxed);
+            m_Storage->Writable.store(true, std::memory_order_relaxed);
+        }
+    public:
+        using ValueType = T;
 
-            if (sizeof...(args) != m_Metadata.Rank()) {
-                throw std::invalid_argument("Error: 'at()' function" +
-                                            std::to_string(m_Metadata.Rank()) + "expected but" +
-                                            std::to_string(sizeof...(args)) + " got ");
+        /**
+         *  @brief Tensor over existing storage (a view, or memory owned elsewhere such as a file mapping)
+         *
+         *  The deleter of data decides how the storage is released; metadata must describe elements that lie
+         *  inside it.
+         * **/
+        NextTensor(std::shared_ptr<T[]> data, NextMetadata metadata)
+            : m_Metadata(std::move(metadata)) {
+            if (m_Metadata.GetDType() != Next::TypeToDType<T>::value) {
+                throw std::runtime_error("Storage DType does not match tensor element type");
             }
+            const auto span = Next::MemorySpan(m_Metadata.Shape(), m_Metadata.Strides(), m_Metadata.Offset());
+            m_Storage = MakeStorage(std::move(data), span[1]);
+        }
 
-            static_assert((std::is_convertible_v<Args, size_t> && ...),
-                      "All Indices must be convertible to size_t");
+        explicit NextTensor(const Dims& shape)
+            : m_Metadata(shape, Next::TypeToDType<T>::value),
+              m_Storage(MakeStorage(m_Metadata.Size() > 0 ? Next::AllocateStorage<T>(m_Metadata.Size()) : nullptr,
+                                    m_Metadata.Size())) {}
 
-            std::array<size_t, sizeof...(Args)> indices = { static_cast<size_t>(args)... };
+        explicit NextTensor(const Dims& shape, const Dims& strides, size_t offset = 0)
+            : m_Metadata(shape, strides, Next::TypeToDType<T>::value, offset),
+              m_Storage(MakeStorage(m_Metadata.Size() > 0 ? Next::AllocateStorage<T>(m_Metadata.Size()) : nullptr,
+                                    m_Metadata.Size())) {}
 
-            size_t finalIndex = m_Metadata.Offset();
-            const auto& shape = m_Metadata.Shape();
-            const auto& strides = m_Metadata.Strides();
+        /**
+         *  @brief Copy: shares the elements of other until one of the two is written
+         * **/
+        NextTensor(const NextTensor& other)
+            : m_Metadata(other.m_Metadata), m_Storage(StorageCell::Share(other.m_Storage)) {}
 
-            for (size_t i = 0; i < indices.size(); i++) {
-                if (indices[i] >= shape[i]) {
-                    throw std::out_of_range("Index out of range");
-                }
+        NextTensor(NextTensor&& other) noexcept = default;
 
-                finalIndex += indices[i] * strides[i];
+        NextTensor& operator=(const NextTensor& other) {
+            if (this != &other) {
+                m_Metadata = other.m_Metadata;
+                m_Storage = StorageCell::Share(other.m_Storage);
             }
+            return *this;
+        }
 
-            return m_Data.get()[finalIndex];
+        NextTensor& operator=(NextTensor&& other) noexcept = default;
+
+        /**
+         *  @brief Materialize a lazy expression built by the operators in NextOps.h
+         * **/
+        template<TensorExpression E>
+        NextTensor(const E& expr) : NextTensor(expr.Shape(), Uninitialized{}) {
+            Next::Evaluate(*this, expr);
         }
 
         /**
-         *  @brief Safe data access with a bound check read-only version
+         *  @brief Evaluate an expression into this tensor's existing storage (which may be a view)
          *
+         *  The expression may read this tensor itself as long as every read is of the element being written,
+         *  e.g. a.assign(a * b + c); reading other elements of the destination gives unspecified results.
          * **/
-        template<typename... Args>
-        const T& at(Args... args) const {
-            static_assert(sizeof...(args) > 0, "Attempt to access Tensor with wrong index count");
+        template<TensorExpression E>
+        NextTensor<T>& assign(const E& expr) {
+            Next::Evaluate(*this, expr);
+            return *this;
+        }
 
-            if (m_Metadata.Rank() == 1 && sizeof...(args) == 1) {
-                const auto idx = static_cast<size_t>(std::get<0>(std::tuple{args...}));
-                if (idx >= m_Metadata.Shape()[0]) {
-                    throw std::invalid_argument("Index out of range");
-                }
-                return m_Data.get()[m_Metadata.Offset() + idx];
-            }
+        [[nodiscard]] DType GetDType() const { return m_Metadata.GetDType(); }
 
-            if (sizeof...(args) != m_Metadata.Rank()) {
-                throw std::invalid_argument("Error: 'at()' function" +
-                                            std::to_string(m_Metadata.Rank()) + "expected but" +
-                                            std::to_string(sizeof...(args)) + " got ");
-            }
+        [[nodiscard]] const Dims& Shape() const { return m_Metadata.Shape(); }
 
-            static_assert((std::is_convertible_v<Args, size_t> && ...),
-                      "All Indices must be convertible to size_t");
+        [[nodiscard]] const Dims& Strides() const { return m_Metadata.Strides(); }
 
-            std::array<size_t, sizeof...(Args)> indices = { static_cast<size_t>(args)... };
+        [[nodiscard]] size_t Offset() const { return m_Metadata.Offset(); }
 
-            size_t finalIndex = m_Metadata.Offset();
-            const auto& shape = m_Metadata.Shape();
-            const auto& strides = m_Metadata.Strides();
+        [[nodiscard]] size_t Size() const { return m_Metadata.Size(); }
 
-            for (size_t i = 0; i < indices.size(); i++) {
-                if (indices[i] >= shape[i]) {
-                    throw std::out_of_range("Index out of range");
-                }
+        [[nodiscard]] size_t Rank() const { return m_Metadata.Rank(); }
 
-                finalIndex += indices[i] * strides[i];
-            }
+        [[nodiscard]] bool IsContiguous() const { return  m_Metadata.IsContiguous(); }
+
+        /**
+         *  @brief Start of the storage for reading; writing through it bypasses copy-on-write
+         * **/
+        [[nodiscard]] T* Data() const { return m_Storage ? static_cast<T*>(m_Storage->Data.get()) : nullptr; }
+
+        /**
+         *  @brief Start of the storage for writing, after the copy-on-write clone if the elements are shared
+         * **/
+        T* Data() { return MutableData(); }
 
-            return m_Data.get()[finalIndex];
+        /**
+         *  @brief Shared storage block (element Offset() is the first element of this tensor)
+         * **/
+        [[nodiscard]] std::shared_ptr<T[]> Storage() const {
+            return m_Storage ? std::static_pointer_cast<T[]>(m_Storage->Data) : nullptr;
         }
 
         /**
-         *  @brief Fast access to data without bound check
+         *  @brief Write accesses handed out so far for these elements; a change means they may have been written
          *
+         *  Reading it makes the next write access count again, so writes made after this call change it
+         *  (writes through pointers or accessors taken before it do not).
          * **/
+        [[nodiscard]] uint64_t Version() const {
+            return m_Storage ? m_Storage->ObserveVersion() : 0;
+        }
 
-        template<typename... Args>
-        T& operator()(Args... args) {
-            std::array<size_t, sizeof...(Args)> indices = { static_cast<size_t>(args)... };
-            size_t finalIndex = m_Metadata.Offset();
-            const auto& strides = m_Metadata.Strides();
+        /**
+         *  @brief Whether the elements are still shared with a copy, i.e. the next write clones them
+         * **/
+        [[nodiscard]] bool IsShared() const { return m_Storage && m_Storage->IsShared(); }
 
-            //TODO: add bound check for debug mode
-            for (size_t i = 0; i < indices.size(); i++) {
-                finalIndex += indices[i] * strides[i];
-            }
+        /**
+         *  @brief View of all elements with this tensor's shape: writes through either handle reach both
+         * **/
+        [[nodiscard]] NextTensor<T> alias() const { return NextTensor<T>{m_Storage, m_Metadata}; }
+
+        /**
+         *  @brief Element at the given indices, always checked: a wrong index count throws
+         *  std::invalid_argument, an index past its dimension std::out_of_range
+         * **/
+        template<typename... Args>
+        T& at(Args... args) {
+            static_assert(sizeof...(args) > 0, "Attempt to access Tensor with wrong index count");
+            return Data()[ElementIndex<true>(args...)];
+        }
 
-            return m_Data.get()[finalIndex];
+        template<typename... Args>
+        const T& at(Args... args) const {
+            static_assert(sizeof...(args) > 0, "Attempt to access Tensor with wrong index count");
+            return Data()[ElementIndex<true>(args...)];
         }
 
         /**
-         *  @brief Fast access to data without bound check read-only
+         *  @brief Element at the given indices, checked like at() only when NEXT_TENSOR_CHECKS >= 1 (debug
+         *  builds); otherwise nothing but Data() and a multiply-add of indices and strides
          *
+         *  A non-const access is a write access through Data(): after the first one, the copy-on-write
+         *  bookkeeping is a single flag test.
          * **/
+        template<typename... Args>
+        T& operator()(Args... args) {
+            if constexpr (NEXT_TENSOR_CHECKS == 0) {
+                return Data()[ElementIndex<false>(args...)];
+            } else {
+                if constexpr (NEXT_TENSOR_CHECKS >= 2) CheckDestination(*this, Shape());
+                const size_t index = ElementIndex<true>(args...);
+                return Data()[index];
+            }
+        }
 
         template<typename... Args>
         const T& operator()(Args... args) const {
-            std::array<size_t, sizeof...(Args)> indices = { static_cast<size_t>(args)... };
-            size_t finalIndex = m_Metadata.Offset();
-            const auto& strides = m_Metadata.Strides();
-
-            //TODO: add bound check for debug mode
-            for (size_t i = 0; i < indices.size(); i++) {
-                finalIndex += indices[i] * strides[i];
+            if constexpr (NEXT_TENSOR_CHECKS == 0) {
+                return Data()[ElementIndex<false>(args...)];
+            } else {
+                return Data()[ElementIndex<true>(args...)];
             }
-
-            return m_Data.get()[finalIndex];
         }
 
-        // TODO: Make these operator[] overload again when finished slice and view
         /**
-         *  @brief Data access with scalar and bound check
-         *
+         *  @brief Element idx in row-major order; the tensor must be contiguous (a contiguous view is fine),
+         *  always checked
          * **/
         T& operator[](size_t idx) {
-            if (!IsContiguous()) {
-                throw std::invalid_argument("Tensor is not contiguous");
-            }
-            if (idx >= m_Metadata.Size()) {
-                throw std::invalid_argument("Index out of range");
-            }
-            return m_Data.get()[idx];
+            CheckFlatIndex(idx);
+            return Data()[m_Metadata.Offset() + idx];
         }
+
+        const T& operator[](size_t idx) const {
+            CheckFlatIndex(idx);
+            return Data()[m_Metadata.Offset() + idx];
+        }
+
         /**
-         *  @brief Data access with scalar and bound check read-only version
+         *  @brief Raw view of the elements for inner loops (see TensorAccessor); Rank must equal Rank()
          *
+         *  Taking it counts as one write: the elements are detached from copies here, and accesses through it
+         *  are plain loads and stores from then on. Like the pointer from Data() it bypasses copy-on-write, so
+         *  a copy of this tensor taken while the accessor is in use sees its writes.
          * **/
-        const T& operator[](size_t idx) const {
-            if (!IsContiguous()) {
-                throw std::invalid_argument("Tensor is not contiguous");
-            }
-            if (idx >= m_Metadata.Size()) {
-                throw std::invalid_argument("Index out of range");
-            }
-            return m_Data.get()[idx];
+        template<size_t Rank>
+        TensorAccessor<T, Rank> accessor() {
+            CheckAccessorRank(Rank);
+            if constexpr (NEXT_TENSOR_CHECKS >= 2) CheckDestination(*this, Shape());
+            return TensorAccessor<T, Rank>{Data() + Offset(), Shape().data(), Strides().data()};
+        }
+
+        template<size_t Rank>
+        TensorAccessor<const T, Rank> accessor() const {
+            CheckAccessorRank(Rank);
+            return TensorAccessor<const T, Rank>{Data() + Offset(), Shape().data(), Strides().data()};
         }
 
         /**
@@ -204,32 +289,8 @@ namespace Next {
          * **/
 
         void fill(const T& value) {
-            if (Size() == 0) return;
-            T* dataPtr = this->Data();
-
-            if (IsContiguous()) {
-                std::fill(dataPtr + Offset(), dataPtr + Offset() + Size(), value);
-            }
-            else {
-                std::vector<size_t> indices(Rank(), 0);
-                const auto& shape = m_Metadata.Shape();
-                const auto& strides = m_Metadata.Strides();
-
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t finalIndex = Offset();
-                    for (size_t d = 0; d < Rank(); ++d) {
-                        finalIndex += indices[d] * strides[d];
-                    }
-                    dataPtr[finalIndex] = value;
-
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < shape[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
+            NEXT_PROFILE_OP("fill", Size(), 0, Size() * sizeof(T));
+            ApplyInPlace([&value](T&) { return value; });
         }
 
         void zeros() {
@@ -241,521 +302,1293 @@ namespace Next {
             fill(T{1});
         }
 
-        //VIEW operations
-        NextTensor<T> reshape(const std::vector<size_t>& shape) {
-            if (!IsContiguous()) {
-                throw std::runtime_error("Tensor is not contiguous {Reshape}");
-            }
-            if (Size() != Next::ComputeSize(shape)) {
-                throw std::runtime_error("Reshape shape is not compatible with current tensor shape");
+        /**
+         *  @brief Contiguous copy converted to element type U; for U == T this tensor itself is returned
+         *
+         *  Conversions from and to Half / BFloat16 run through the vectorized F16C / AVX2 kernels.
+         * **/
+        template<typename U>
+        NextTensor<U> to() const {
+            if constexpr (std::is_same_v<U, T>) {
+                return alias();
+            } else {
+                NEXT_PROFILE_OP("to", Size(), Size() * sizeof(T), Size() * sizeof(U));
+                NextTensor<U> result{Shape(), typename NextTensor<U>::Uninitialized{}};
+                ConvertInto(result);
+                return result;
             }
-            NextMetadata n_Metadata{shape, Next::ComputeStrides(shape), this->GetDType(), this->Offset()};
+        }
 
-            return NextTensor<T>{this->m_Data, n_Metadata};
+        /**
+         *  @brief Write this tensor converted to U into out, which must have the same shape
+         * **/
+        template<typename U>
+        NextTensor<U>& to(NextTensor<U>& out) const {
+            CheckDestination(out, Shape());
+            CheckAlias(out, *this, Strides());
+            ConvertInto(out);
+            return out;
         }
 
-        NextTensor<T> transpose(const size_t& dim1, const size_t& dim2) {
-            if (dim1 >= Rank() || dim2 >= Rank()) {
-                throw std::runtime_error("Transpose dimensions are out of range");
+        /**
+         *  @brief This tensor if it is already contiguous, otherwise a contiguous copy (see clone)
+         * **/
+        NextTensor<T> contiguous() const {
+            if (IsContiguous()) {
+                return alias();
             }
-            auto n_Shape = Shape();
-            auto n_Strides = Strides();
-            std::swap(n_Shape[dim1], n_Shape[dim2]);
-            std::swap(n_Strides[dim1], n_Strides[dim2]);
-            NextMetadata n_Metadata{n_Shape, n_Strides, this->GetDType(), this->Offset()};
+            return clone();
+        }
 
-            return NextTensor<T>{this->m_Data, n_Metadata};
+        /**
+         *  @brief Contiguous copy with its own storage
+         *
+         *  Transposed and permuted layouts are copied with a cache-blocked transpose rather than a strided
+         *  gather, see Copy::CopyStrided.
+         * **/
+        NextTensor<T> clone() const {
+            NEXT_PROFILE_OP("clone", Size(), Size() * sizeof(T), Size() * sizeof(T));
+            NextTensor<T> result{Shape(), Uninitialized{}};
+            Copy::CopyStrided(Shape(), result.Data(), result.Strides(), 0, Data(), Strides(), Offset());
+            return result;
         }
 
-        NextTensor<T> slice(const size_t& dim = 0, const size_t& start = 0, const size_t& end = 0) {
-            if (dim >= Rank()) {
-                throw std::out_of_range("Slice error: Dimension index (" + std::to_string(dim) +
-                                         ") is out of range for tensor with rank " + std::to_string(Rank()));
+        /**
+         *  @brief Copy src, broadcast to this tensor's shape, into this tensor's elements (which may be a view)
+         *
+         *  A source of another element type is converted on the way. The aliasing rule of the element-wise
+         *  ops applies: src may be this very view, any other overlap is rejected.
+         * **/
+        template<typename U>
+        NextTensor<T>& copy_from(const NextTensor<U>& src) {
+            NEXT_PROFILE_OP("copy_from", Size(), src.Size() * sizeof(U), Size() * sizeof(T));
+            CheckDestination(*this, Shape());
+            const auto srcStrides = Next::BroadcastStrides(src.Shape(), src.Strides(), Shape());
+            CheckAlias(*this, src, srcStrides);
+            if constexpr (std::is_same_v<U, T>) {
+                Copy::CopyStrided(Shape(), Data(), Strides(), Offset(), src.Data(), srcStrides, src.Offset());
+            } else {
+                src.expand(Shape()).ConvertInto(*this);
             }
+            return *this;
+        }
 
-            if (start > end) {
-                throw std::runtime_error("Slice error: 'start' index (" + std::to_string(start) +
-                                         ") cannot be greater than 'end' index (" + std::to_string(end) + ").");
+        //VIEW operations
+        /**
+         *  @brief Tensor of the same elements with a new shape
+         *
+         *  A view sharing this tensor's storage whenever the layout allows it (always for contiguous tensors,
+         *  and for any split or merge of dimensions that are contiguous with each other); otherwise the
+         *  elements are first copied into a contiguous tensor.
+         * **/
+        NextTensor<T> reshape(const Dims& shape) const {
+            if (Size() != Next::ComputeSize(shape)) {
+                throw std::runtime_error("Reshape shape is not compatible with current tensor shape");
             }
-
-            if (end > Shape()[dim]) {
-                throw std::out_of_range("Slice error: 'end' index (" + std::to_string(end) +
-                                         ") is out of bounds for dimension " + std::to_string(dim) +
-                                         " (size is " + std::to_string(Shape()[dim]) + ").");
+            if (const auto n_Strides = Next::ViewStrides(Shape(), Strides(), shape)) {
+                NextMetadata n_Metadata{shape, *n_Strides, this->GetDType(), this->Offset()};
+                return NextTensor<T>{this->m_Storage, n_Metadata};
             }
+            return clone().reshape(shape);
+        }
+
+        NextTensor<T> transpose(const size_t& dim1, const size_t& dim2) const {
+            return NextTensor<T>{this->m_Storage, View::Transpose(m_Metadata, dim1, dim2)};
+        }
+
+        /**
+         *  @brief View with the dimensions reordered: dimension d of the view is dimension dims[d] of this tensor
+         * **/
+        NextTensor<T> permute(const Dims& dims) const {
+            return NextTensor<T>{this->m_Storage, View::Permute(m_Metadata, dims)};
+        }
+
+        /**
+         *  @brief View of indices start, start + step, ... below end along dim
+         * **/
+        NextTensor<T> slice(const size_t& dim = 0, const size_t& start = 0, const size_t& end = 0,
+                            const size_t& step = 1) const {
+            return NextTensor<T>{this->m_Storage, View::Slice(m_Metadata, dim, start, end, step)};
+        }
+
+        /**
+         *  @brief View of length indices from start along dim, slice(dim, start, start + length)
+         * **/
+        NextTensor<T> narrow(size_t dim, size_t start, size_t length) const {
+            return slice(dim, start, start + length);
+        }
+
+        /**
+         *  @brief Broadcast view: size-1 and missing leading dimensions are repeated with a zero stride
+         * **/
+        NextTensor<T> expand(const Dims& shape) const {
+            return NextTensor<T>{this->m_Storage, View::Expand(m_Metadata, shape)};
+        }
+
+        /**
+         *  @brief View without the dimensions of size one
+         * **/
+        NextTensor<T> squeeze() const {
+            return NextTensor<T>{this->m_Storage, View::Squeeze(m_Metadata)};
+        }
+
+        /**
+         *  @brief View without dimension dim, which must have size one
+         * **/
+        NextTensor<T> squeeze(size_t dim) const {
+            return NextTensor<T>{this->m_Storage, View::Squeeze(m_Metadata, dim)};
+        }
+
+        /**
+         *  @brief View with a dimension of size one inserted before dim (dim == Rank() appends it)
+         * **/
+        NextTensor<T> unsqueeze(size_t dim) const {
+            return NextTensor<T>{this->m_Storage, View::Unsqueeze(m_Metadata, dim)};
+        }
 
-            auto n_Shape = Shape();
-            n_Shape[dim] = end - start;
+        /**
+         *  @brief Dimensions startDim..endDim (inclusive) merged into one, see reshape
+         *
+         *  A view when the merged dimensions are contiguous with each other, e.g. any range of a contiguous
+         *  tensor; merging across a gap (a transposed pair) has to copy.
+         * **/
+        NextTensor<T> flatten(size_t startDim = 0, size_t endDim = SIZE_MAX) const {
+            return reshape(View::FlattenShape(Shape(), startDim, endDim));
+        }
 
-            auto n_Offset = Offset() + start * Strides()[dim];
+        /**
+         *  @brief View with explicit shape, strides and storage offset (Offset() by default)
+         *
+         *  Checked only to stay inside the storage. Strides that repeat or overlap elements make a view that
+         *  can be read but not used as a destination.
+         * **/
+        NextTensor<T> as_strided(const Dims& shape, const Dims& strides, size_t offset) const {
+            const size_t storageSize = m_Storage ? m_Storage->Bytes / sizeof(T) : 0;
+            return NextTensor<T>{this->m_Storage, View::AsStrided(m_Metadata, shape, strides, offset, storageSize)};
+        }
 
-            NextMetadata n_Metadata{n_Shape, Strides(), this->GetDType(), n_Offset};
-            return NextTensor<T>{this->m_Data, n_Metadata};
+        NextTensor<T> as_strided(const Dims& shape, const Dims& strides) const {
+            return as_strided(shape, strides, Offset());
         }
 
         //Tensor element-wise operations
         NextTensor<T>& operator+=(const NextTensor<T>& other) {
-            if (this->Shape() != other.Shape()) {
-                throw std::runtime_error("Tensor shapes are not compatible for InPlace addition");
-            }
-            if (this->IsContiguous() && other.IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    this->Data()[i + this->Offset()] += other.Data()[i + other.Offset()];
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                const auto& shape = this->Shape();
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    size_t indexB = other.Offset() + Next::FlattenIndex(other.Strides(), indices);
-                    this->Data()[indexA] += other.Data()[indexB];
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < shape[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
+            ApplyInPlace(other, Simd::Arith<Simd::BinaryOp::ADD>{});
             return *this;
         }
 
         NextTensor<T>& operator+=(const T& other) {
-            if (this->IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    this->Data()[i + this->Offset()] += other;
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    this->Data()[indexA] += other;
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < Shape()[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
+            ApplyInPlace(other, Simd::Arith<Simd::BinaryOp::ADD>{});
             return *this;
         }
 
         NextTensor<T>& operator-=(const NextTensor<T>& other) {
-            if (this->Shape() != other.Shape()) {
-                throw std::runtime_error("Tensor shapes are not compatible for InPlace addition");
-            }
-            if (this->IsContiguous() && other.IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    this->Data()[i + this->Offset()] -= other.Data()[i + other.Offset()];
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                const auto& shape = this->Shape();
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    size_t indexB = other.Offset() + Next::FlattenIndex(other.Strides(), indices);
-                    this->Data()[indexA] -= other.Data()[indexB];
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < shape[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
+            ApplyInPlace(other, Simd::Arith<Simd::BinaryOp::SUB>{});
             return *this;
         }
 
         NextTensor<T>& operator-=(const T& other) {
-            if (this->IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    this->Data()[i + this->Offset()] -= other;
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    this->Data()[indexA] -= other;
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < Shape()[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
+            ApplyInPlace(other, Simd::Arith<Simd::BinaryOp::SUB>{});
             return *this;
         }
 
         NextTensor<T>& operator*=(const NextTensor<T>& other) {
-            if (this->Shape() != other.Shape()) {
-                throw std::runtime_error("Tensor shapes are not compatible for InPlace addition");
-            }
-            if (this->IsContiguous() && other.IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    this->Data()[i + this->Offset()] *= other.Data()[i + other.Offset()];
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                const auto& shape = this->Shape();
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    size_t indexB = other.Offset() + Next::FlattenIndex(other.Strides(), indices);
-                    this->Data()[indexA] *= other.Data()[indexB];
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < shape[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
+            ApplyInPlace(other, Simd::Arith<Simd::BinaryOp::MUL>{});
             return *this;
         }
 
         NextTensor<T>& operator*=(const T& other) {
-            if (this->IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    this->Data()[i + this->Offset()] *= other;
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    this->Data()[indexA] *= other;
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < Shape()[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
+            ApplyInPlace(other, Simd::Arith<Simd::BinaryOp::MUL>{});
             return *this;
         }
 
         NextTensor<T>& operator/=(const NextTensor<T>& other) {
-            if (this->Shape() != other.Shape()) {
-                throw std::runtime_error("Tensor shapes are not compatible for InPlace addition");
-            }
-            if (this->IsContiguous() && other.IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    if (other.Data()[i + other.Offset()] == 0) {
-                        throw std::runtime_error("Division by zero");
-                    }
-                    this->Data()[i + this->Offset()] /= other.Data()[i + other.Offset()];
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                const auto& shape = this->Shape();
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    size_t indexB = other.Offset() + Next::FlattenIndex(other.Strides(), indices);
-                    if (other.Data()[indexB] == 0) {
-                        throw std::runtime_error("Division by zero");
-                    }
-                    this->Data()[indexA] /= other.Data()[indexB];
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < shape[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
+            CheckNonZero(other);
+            ApplyInPlace(other, Simd::Arith<Simd::BinaryOp::DIV>{});
             return *this;
         }
 
         NextTensor<T>& operator/=(const T& other) {
-            if (this->IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    if (other == 0) {
-                        throw std::runtime_error("Division by zero");
-                    }
-                    this->Data()[i + this->Offset()] /= other;
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                for (size_t i = 0; i < Size(); i++) {
-                    if (other == 0) {
-                        throw std::runtime_error("Division by zero");
-                    }
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    this->Data()[indexA] /= other;
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < Shape()[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
+            CheckNonZero(other);
+            ApplyInPlace(other, Simd::Arith<Simd::BinaryOp::DIV>{});
             return *this;
         }
 
         // Element-wise Operations
+        //
+        // Every op also has an output-parameter form, e.g. a.add(b, out), that writes the result into out and
+        // returns it. out must already have the result shape (it is never broadcast) and must not be a view
+        // that repeats elements, such as an expanded tensor. Nothing is allocated, so a loop that reuses its
+        // destinations runs allocation-free after the first iteration.
+        //
+        // Aliasing rule: the destination (out, or this tensor for the compound operators) may be the very
+        // same view as an operand, same storage, offset and strides, as in a.add(b, a); every element is
+        // then read before it is overwritten. Any other overlap between the destination and an operand
+        // (a shifted or transposed view of the same storage, or a broadcast operand) is rejected with
+        // std::runtime_error, because the result would depend on the traversal order. matmul and the
+        // reductions read each operand element several times, so their destination must not overlap an
+        // operand at all.
+
         // Tensor plus Tensor
         NextTensor<T> add(const NextTensor<T>& other) const {
-            if (this->Shape() != other.Shape()) {
-                //TODO: Add broadcasting
-                throw std::runtime_error("Tensor shapes are not compatible for element-wise addition");
-            }
-            NextTensor<T> resultTensor{this->Shape()}; // Result Tensor
-            if (this->IsContiguous() && other.IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    resultTensor.Data()[i] = this->Data()[i + this->Offset()] + other.Data()[i + other.Offset()];
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                const auto& shape = this->Shape();
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    size_t indexB = other.Offset() + Next::FlattenIndex(other.Strides(), indices);
-                    resultTensor.Data()[i] = this->Data()[indexA] + other.Data()[indexB];
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < shape[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
-            return resultTensor;
+            return Apply(other, Simd::Arith<Simd::BinaryOp::ADD>{});
         }
 
         NextTensor<T> add(const T& scalar) const {
-            NextTensor<T> resultTensor{this->Shape()};
-            if (this->IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    resultTensor.Data()[i] = this->Data()[i + this->Offset()] + scalar;
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    resultTensor.Data()[i] = this->Data()[indexA] + scalar;
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < Shape()[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
-            return resultTensor;
+            return Apply(scalar, Simd::Arith<Simd::BinaryOp::ADD>{});
         }
 
         NextTensor<T> sub(const NextTensor<T>& other) const {
-            if (this->Shape() != other.Shape()) {
-                //TODO: Add broadcasting
-                throw std::runtime_error("Tensor shapes are not compatible for element-wise addition");
-            }
-            NextTensor<T> resultTensor{this->Shape()}; // Result Tensor
-            if (this->IsContiguous() && other.IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    resultTensor.Data()[i] = this->Data()[i + this->Offset()] - other.Data()[i + other.Offset()];
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                const auto& shape = this->Shape();
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    size_t indexB = other.Offset() + Next::FlattenIndex(other.Strides(), indices);
-                    resultTensor.Data()[i] = this->Data()[indexA] - other.Data()[indexB];
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < shape[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
-            return resultTensor;
+            return Apply(other, Simd::Arith<Simd::BinaryOp::SUB>{});
         }
 
         NextTensor<T> sub(const T& scalar) const {
-            NextTensor<T> resultTensor{this->Shape()};
-            if (this->IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    resultTensor.Data()[i] = this->Data()[i + this->Offset()] - scalar;
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    resultTensor.Data()[i] = this->Data()[indexA] - scalar;
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < Shape()[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
-                }
-            }
-            return resultTensor;
+            return Apply(scalar, Simd::Arith<Simd::BinaryOp::SUB>{});
         }
 
         NextTensor<T> rsub(const T& scalar) const {
-            NextTensor<T> resultTensor{this->Shape()};
-            if (this->IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    resultTensor.Data()[i] = scalar - this->Data()[i + this->Offset()];
-                }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    resultTensor.Data()[i] = scalar - this->Data()[indexA];
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < Shape()[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
+            return Apply(scalar, Simd::Arith<Simd::BinaryOp::SUB>{}, true);
+        }
+
+        NextTensor<T> mult(const NextTensor<T>& other) const {
+            return Apply(other, Simd::Arith<Simd::BinaryOp::MUL>{});
+        }
+
+        NextTensor<T> mult(const T& scalar) const {
+            return Apply(scalar, Simd::Arith<Simd::BinaryOp::MUL>{});
+        }
+
+        /**
+         *  @brief Element-wise quotient; an integer zero divisor throws before anything is written, floating
+         *  point follows IEEE 754 (inf / NaN, no check)
+         * **/
+        NextTensor<T> divide(const NextTensor<T>& other) const {
+            CheckNonZero(other);
+            return Apply(other, Simd::Arith<Simd::BinaryOp::DIV>{});
+        }
+
+        NextTensor<T> divide(const T& scalar) const {
+            CheckNonZero(scalar);
+            return Apply(scalar, Simd::Arith<Simd::BinaryOp::DIV>{});
+        }
+
+        NextTensor<T> rdivide(const T& scalar) const {
+            CheckNonZero(*this);
+            return Apply(scalar, Simd::Arith<Simd::BinaryOp::DIV>{}, true);
+        }
+
+        // Output-parameter forms, see the aliasing rule above
+        NextTensor<T>& add(const NextTensor<T>& other, NextTensor<T>& out) const {
+            ApplyInto(out, other, Simd::Arith<Simd::BinaryOp::ADD>{});
+            return out;
+        }
+
+        NextTensor<T>& add(const T& scalar, NextTensor<T>& out) const {
+            ApplyInto(out, scalar, Simd::Arith<Simd::BinaryOp::ADD>{});
+            return out;
+        }
+
+        NextTensor<T>& sub(const NextTensor<T>& other, NextTensor<T>& out) const {
+            ApplyInto(out, other, Simd::Arith<Simd::BinaryOp::SUB>{});
+            return out;
+        }
+
+        NextTensor<T>& sub(const T& scalar, NextTensor<T>& out) const {
+            ApplyInto(out, scalar, Simd::Arith<Simd::BinaryOp::SUB>{});
+            return out;
+        }
+
+        NextTensor<T>& rsub(const T& scalar, NextTensor<T>& out) const {
+            ApplyInto(out, scalar, Simd::Arith<Simd::BinaryOp::SUB>{}, true);
+            return out;
+        }
+
+        NextTensor<T>& mult(const NextTensor<T>& other, NextTensor<T>& out) const {
+            ApplyInto(out, other, Simd::Arith<Simd::BinaryOp::MUL>{});
+            return out;
+        }
+
+        NextTensor<T>& mult(const T& scalar, NextTensor<T>& out) const {
+            ApplyInto(out, scalar, Simd::Arith<Simd::BinaryOp::MUL>{});
+            return out;
+        }
+
+        NextTensor<T>& divide(const NextTensor<T>& other, NextTensor<T>& out) const {
+            CheckNonZero(other);
+            ApplyInto(out, other, Simd::Arith<Simd::BinaryOp::DIV>{});
+            return out;
+        }
+
+        NextTensor<T>& divide(const T& scalar, NextTensor<T>& out) const {
+            CheckNonZero(scalar);
+            ApplyInto(out, scalar, Simd::Arith<Simd::BinaryOp::DIV>{});
+            return out;
+        }
+
+        NextTensor<T>& rdivide(const T& scalar, NextTensor<T>& out) const {
+            CheckNonZero(*this);
+            ApplyInto(out, scalar, Simd::Arith<Simd::BinaryOp::DIV>{}, true);
+            return out;
+        }
+
+        // Math and activations (floating point element types), see Math::UnaryOp for the accuracy of the
+        // vectorized float kernels
+        NextTensor<T> exp() const { return Unary(Math::UnaryOp::EXP); }
+
+        NextTensor<T> log() const { return Unary(Math::UnaryOp::LOG); }
+
+        NextTensor<T> tanh() const { return Unary(Math::UnaryOp::TANH); }
+
+        NextTensor<T> sigmoid() const { return Unary(Math::UnaryOp::SIGMOID); }
+
+        NextTensor<T> gelu() const { return Unary(Math::UnaryOp::GELU); }
+
+        NextTensor<T> relu() const { return Unary(Math::UnaryOp::RELU); }
+
+        NextTensor<T>& exp(NextTensor<T>& out) const { return UnaryInto(out, Math::UnaryOp::EXP); }
+
+        NextTensor<T>& log(NextTensor<T>& out) const { return UnaryInto(out, Math::UnaryOp::LOG); }
+
+        NextTensor<T>& tanh(NextTensor<T>& out) const { return UnaryInto(out, Math::UnaryOp::TANH); }
+
+        NextTensor<T>& sigmoid(NextTensor<T>& out) const { return UnaryInto(out, Math::UnaryOp::SIGMOID); }
+
+        NextTensor<T>& gelu(NextTensor<T>& out) const { return UnaryInto(out, Math::UnaryOp::GELU); }
+
+        NextTensor<T>& relu(NextTensor<T>& out) const { return UnaryInto(out, Math::UnaryOp::RELU); }
+
+        /**
+         *  @brief act(this + bias) in a single pass, bias broadcast against this tensor (e.g. one value per
+         *  feature over a batch of rows)
+         *
+         *  The sum is never stored: each block of a row is added and activated while it is in registers,
+         *  instead of add() writing a whole intermediate tensor that the activation reads back.
+         * **/
+        NextTensor<T> bias_activation(const NextTensor<T>& bias, Math::UnaryOp act) const {
+            return Unary(act, &bias);
+        }
+
+        NextTensor<T>& bias_activation(const NextTensor<T>& bias, Math::UnaryOp act, NextTensor<T>& out) const {
+            return UnaryInto(out, act, &bias);
+        }
+
+        // Linear algebra
+        /**
+         *  @brief Matrix product with NumPy matmul semantics
+         *
+         *  Rank-1 operands are treated as a row (lhs) or column (rhs) vector and that dimension is dropped from
+         *  the result, leading dimensions are broadcast as a batch. Transposed and sliced operands are read
+         *  through their strides while packing, so they are never copied as a whole.
+         * **/
+        NextTensor<T> matmul(const NextTensor<T>& other) const {
+            return promoted_matmul(*this, other);
+        }
+
+        /**
+         *  @brief Matrix product written into out, which must have the result shape and not overlap an operand
+         * **/
+        NextTensor<T>& matmul(const NextTensor<T>& other, NextTensor<T>& out) const {
+            return promoted_matmul(*this, other, out);
+        }
+
+        // Mixed element types, behind the ops of Tensor on operands of different DTypes: A and B promote to T
+        // (see PromoteTypes; for the math ops T is the floating point type they continue to). An operand of
+        // another type is converted as the kernels read it, a block of each row at a time or, for matmul,
+        // while its panels are packed, so no converted copy is made. The checks and the aliasing rule are
+        // those of the output-parameter forms.
+        template<Simd::BinaryOp K, typename A, typename B>
+        static NextTensor<T> promoted_binary(const NextTensor<A>& a, const NextTensor<B>& b) {
+            NextTensor<T> result{Next::BroadcastShapes(a.Shape(), b.Shape()), Uninitialized{}};
+            promoted_binary<K>(a, b, result);
+            return result;
+        }
+
+        template<Simd::BinaryOp K, typename A, typename B>
+        static NextTensor<T>& promoted_binary(const NextTensor<A>& a, const NextTensor<B>& b, NextTensor<T>& out) {
+            if constexpr (K == Simd::BinaryOp::DIV && std::numeric_limits<T>::is_integer) {
+                NextTensor<B>::CheckNonZero(b);
+            }
+            BinaryInto(out, a, b, Simd::Arith<K>{});
+            return out;
+        }
+
+        /**
+         *  @brief act(a + bias), act(a) when bias is null, see bias_activation
+         * **/
+        template<typename A, typename B = A>
+        static NextTensor<T> promoted_activation(const NextTensor<A>& a, Math::UnaryOp act,
+                                                 const NextTensor<B>* bias = nullptr) {
+            const auto shape = bias ? Next::BroadcastShapes(a.Shape(), bias->Shape()) : a.Shape();
+            NEXT_PROFILE_OP(bias ? "bias_activation" : Math::OpName(act), ComputeSize(shape),
+                            a.Size() * sizeof(A) + (bias ? bias->Size() * sizeof(B) : 0), ComputeSize(shape) * sizeof(T));
+            NextTensor<T> result{shape, Uninitialized{}};
+            UnaryWrite(result, a, act, bias);
+            return result;
+        }
+
+        template<typename A, typename B = A>
+        static NextTensor<T>& promoted_activation(const NextTensor<A>& a, Math::UnaryOp act, const NextTensor<B>* bias,
+                                                  NextTensor<T>& out) {
+            NEXT_PROFILE_OP(bias ? "bias_activation" : Math::OpName(act), out.Size(),
+                            a.Size() * sizeof(A) + (bias ? bias->Size() * sizeof(B) : 0), out.Size() * sizeof(T));
+            const auto shape = bias ? Next::BroadcastShapes(a.Shape(), bias->Shape()) : a.Shape();
+            CheckDestination(out, shape);
+            CheckAlias(out, a, Next::BroadcastStrides(a.Shape(), a.Strides(), shape));
+            if (bias) {
+                CheckAlias(out, *bias, Next::BroadcastStrides(bias->Shape(), bias->Strides(), shape));
+            }
+            UnaryWrite(out, a, act, bias);
+            return out;
+        }
+
+        template<typename A, typename B>
+        static NextTensor<T> promoted_matmul(const NextTensor<A>& a, const NextTensor<B>& b) {
+            const auto shape = MatmulShape(a, b);
+            NEXT_PROFILE_OP("matmul", ComputeSize(shape), a.Size() * sizeof(A) + b.Size() * sizeof(B),
+                            ComputeSize(shape) * sizeof(T));
+            NextTensor<T> result{shape, Uninitialized{}};
+            MatmulInto(a, b, result);
+            return result;
+        }
+
+        template<typename A, typename B>
+        static NextTensor<T>& promoted_matmul(const NextTensor<A>& a, const NextTensor<B>& b, NextTensor<T>& out) {
+            NEXT_PROFILE_OP("matmul", out.Size(), a.Size() * sizeof(A) + b.Size() * sizeof(B), out.Size() * sizeof(T));
+            CheckDestination(out, MatmulShape(a, b));
+            if (out.Overlaps(a) || out.Overlaps(b)) {
+                throw std::runtime_error("Output error: the matmul destination overlaps an operand");
+            }
+            MatmulInto(a, b, out);
+            return out;
+        }
+
+        // Reductions
+        /**
+         *  @brief Sum over axes (every axis when empty); reduced axes stay as size one when keepdim is set
+         *
+         *  Floating point sums are pairwise inside a row and Kahan compensated across rows, so the error does
+         *  not grow with the length of the reduced axes. Integer sums wrap like the element type does.
+         * **/
+        NextTensor<T> sum(const Dims& axes = {}, bool keepdim = false) const {
+            return Reduction<Reduce::Kind::SUM>(axes, keepdim);
+        }
+
+        /**
+         *  @brief Sum over axes written into out
+         *
+         *  out must be contiguous and have either the keepdim or the reduced shape (both share one layout).
+         * **/
+        NextTensor<T>& sum(const Dims& axes, NextTensor<T>& out) const {
+            ReductionInto<Reduce::Kind::SUM>(axes, out);
+            return out;
+        }
+
+        /**
+         *  @brief Arithmetic mean over axes
+         *
+         *  Integer tensors are summed and divided in double and the quotient truncated toward zero; Half and
+         *  BFloat16 in float. The result is rounded into T once, so neither the sum nor the count wraps in T.
+         * **/
+        NextTensor<T> mean(const Dims& axes = {}, bool keepdim = false) const {
+            NEXT_PROFILE_OP("mean", Size(), Size() * sizeof(T), 0);
+            const auto reduced = ReducedAxes(axes);
+            NextTensor<T> result{Reduce::KeepDimShape(Shape(), reduced), Uninitialized{}};
+            MeanInto(axes, result);
+            return keepdim ? result : result.reshape(DroppedShape(reduced));
+        }
+
+        NextTensor<T>& mean(const Dims& axes, NextTensor<T>& out) const {
+            NEXT_PROFILE_OP("mean", Size(), Size() * sizeof(T), out.Size() * sizeof(T));
+            MeanInto(axes, out);
+            return out;
+        }
+
+        NextTensor<T> prod(const Dims& axes = {}, bool keepdim = false) const {
+            return Reduction<Reduce::Kind::PROD>(axes, keepdim);
+        }
+
+        NextTensor<T>& prod(const Dims& axes, NextTensor<T>& out) const {
+            ReductionInto<Reduce::Kind::PROD>(axes, out);
+            return out;
+        }
+
+        NextTensor<T> max(const Dims& axes = {}, bool keepdim = false) const {
+            return Reduction<Reduce::Kind::MAX>(axes, keepdim);
+        }
+
+        NextTensor<T>& max(const Dims& axes, NextTensor<T>& out) const {
+            ReductionInto<Reduce::Kind::MAX>(axes, out);
+            return out;
+        }
+
+        NextTensor<T> min(const Dims& axes = {}, bool keepdim = false) const {
+            return Reduction<Reduce::Kind::MIN>(axes, keepdim);
+        }
+
+        NextTensor<T>& min(const Dims& axes, NextTensor<T>& out) const {
+            ReductionInto<Reduce::Kind::MIN>(axes, out);
+            return out;
+        }
+
+        /**
+         *  @brief Index of the first maximum along axis
+         * **/
+        NextTensor<int64_t> argmax(size_t axis, bool keepdim = false) const {
+            return ArgReduction<true>(axis, keepdim);
+        }
+
+        NextTensor<int64_t>& argmax(size_t axis, NextTensor<int64_t>& out) const {
+            ArgReductionInto<true>(axis, out);
+            return out;
+        }
+
+        /**
+         *  @brief Index of the first minimum along axis
+         * **/
+        NextTensor<int64_t> argmin(size_t axis, bool keepdim = false) const {
+            return ArgReduction<false>(axis, keepdim);
+        }
+
+        NextTensor<int64_t>& argmin(size_t axis, NextTensor<int64_t>& out) const {
+            ArgReductionInto<false>(axis, out);
+            return out;
+        }
+
+        // Indexing
+        //
+        // Indices are int64 tensors (what argmax returns) and are checked to lie in [0, size of the indexed
+        // dimension) before any element moves; negative indices are rejected. See Index:: for the kernels.
+
+        /**
+         *  @brief Entries index[0], index[1], ... of dimension dim, selected by a 1-D index
+         *
+         *  The result is contiguous; rows after dim that are contiguous in this tensor are copied whole.
+         * **/
+        NextTensor<T> index_select(size_t dim, const NextTensor<int64_t>& index) const {
+            CheckIndexDim(dim);
+            NEXT_PROFILE_OP("index_select", Size() / std::max<size_t>(Shape()[dim], 1) * index.Size(),
+                            Size() / std::max<size_t>(Shape()[dim], 1) * index.Size() * sizeof(T) +
+                            index.Size() * sizeof(int64_t),
+                            Size() / std::max<size_t>(Shape()[dim], 1) * index.Size() * sizeof(T));
+            if (index.Rank() != 1) {
+                throw std::runtime_error("Index error: index_select needs a 1-D index, got shape " +
+                                         ShapeToString(index.Shape()));
+            }
+            Index::CheckIndices(index.Data(), index.Shape(), index.Strides(), index.Offset(), Shape()[dim], dim);
+            auto shape = Shape();
+            shape[dim] = index.Size();
+            NextTensor<T> result{shape, Uninitialized{}};
+            Index::IndexSelect(result.Data(), Data(), Shape(), Strides(), Offset(), dim,
+                               index.Data(), index.Strides()[0], index.Offset(), index.Size());
+            return result;
+        }
+
+        /**
+         *  @brief result[i...] = this[i with dimension dim replaced by index[i...]]
+         *
+         *  index has this tensor's rank and no dimension other than dim larger than this tensor's; the result
+         *  has index's shape.
+         * **/
+        NextTensor<T> gather(size_t dim, const NextTensor<int64_t>& index) const {
+            CheckIndexDim(dim);
+            NEXT_PROFILE_OP("gather", index.Size(), index.Size() * (sizeof(T) + sizeof(int64_t)),
+                            index.Size() * sizeof(T));
+            Index::CheckIndexShape(index.Shape(), Shape(), dim, "the tensor");
+            Index::CheckIndices(index.Data(), index.Shape(), index.Strides(), index.Offset(), Shape()[dim], dim);
+            NextTensor<T> result{index.Shape(), Uninitialized{}};
+            auto n_Strides = Strides();
+            n_Strides[dim] = 0;
+            Index::Gather(result.Data(), result.Strides(), 0, index.Data(), index.Shape(), index.Strides(),
+                          index.Offset(), Data(), n_Strides, Offset(), Strides()[dim]);
+            return result;
+        }
+
+        /**
+         *  @brief this[i with dimension dim replaced by index[i...]] = src[i...] for every position i of index
+         *
+         *  The inverse of gather, written into this tensor. index must fit src in every dimension and this
+         *  tensor outside dim; when an index repeats, the last position along dim wins.
+         * **/
+        NextTensor<T>& scatter(size_t dim, const NextTensor<int64_t>& index, const NextTensor<T>& src) {
+            ScatterInto<false>(dim, index, src);
+            return *this;
+        }
+
+        /**
+         *  @brief scatter that adds src into the indexed elements, so repeated indices accumulate
+         *
+         *  Runs in parallel without atomics (see Index::Scatter); floating point sums split across threads
+         *  may round differently from a serial loop, like the reductions.
+         * **/
+        NextTensor<T>& scatter_add(size_t dim, const NextTensor<int64_t>& index, const NextTensor<T>& src) {
+            ScatterInto<true>(dim, index, src);
+            return *this;
+        }
+
+        /**
+         *  @brief 1-D tensor of the elements whose flag in mask (broadcast to this shape) is set, in row-major order
+         * **/
+        NextTensor<T> masked_select(const NextTensor<bool>& mask) const {
+            NEXT_PROFILE_OP("masked_select", Size(), Size() * (sizeof(T) + sizeof(bool)), 0);
+            const auto values = contiguous();
+            const auto flags = mask.expand(Shape()).contiguous();
+            std::optional<NextTensor<T>> result;
+            Index::MaskedSelect(values.Data() + values.Offset(), flags.Data() + flags.Offset(), Size(),
+                [&](size_t count) {
+                    NEXT_PROFILE_WRITTEN(count * sizeof(T));
+                    result.emplace(NextTensor<T>{Dims{count}, Uninitialized{}});
+                    return result->Data();
+                });
+            return std::move(*result);
+        }
+
+    private:
+        /**
+         *  @brief Storage offset of the element at args; Checked validates the index count and every index
+         * **/
+        template<bool Checked, typename... Args>
+        [[nodiscard]] size_t ElementIndex(Args... args) const {
+            static_assert((std::is_convertible_v<Args, size_t> && ...), "All Indices must be convertible to size_t");
+            const std::array<size_t, sizeof...(Args)> indices{static_cast<size_t>(args)...};
+            const auto& shape = m_Metadata.Shape();
+            const auto& strides = m_Metadata.Strides();
+            if constexpr (Checked) {
+                if (indices.size() != shape.size()) Detail::ThrowRankMismatch(shape.size(), indices.size());
+            }
+            size_t index = m_Metadata.Offset();
+            for (size_t d = 0; d < indices.size(); d++) {
+                if constexpr (Checked) {
+                    if (indices[d] >= shape[d]) Detail::ThrowIndexOutOfRange(indices[d], d, shape[d]);
                 }
+                index += indices[d] * strides[d];
             }
-            return resultTensor;
+            return index;
         }
 
-        NextTensor<T> mult(const NextTensor<T>& other) const {
-            if (this->Shape() != other.Shape()) {
-                //TODO: Add broadcasting
-                throw std::runtime_error("Tensor shapes are not compatible for element-wise addition");
-            }
-            NextTensor<T> resultTensor{this->Shape()}; // Result Tensor
-            if (this->IsContiguous() && other.IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    resultTensor.Data()[i] = this->Data()[i + this->Offset()] * other.Data()[i + other.Offset()];
+        void CheckFlatIndex(size_t idx) const {
+            if (!IsContiguous()) {
+                throw std::invalid_argument("Tensor is not contiguous");
+            }
+            if (idx >= m_Metadata.Size()) {
+                throw std::out_of_range("Index error: flat index " + std::to_string(idx) +
+                                        " is out of range for tensor of size " + std::to_string(m_Metadata.Size()));
+            }
+        }
+
+        void CheckAccessorRank(size_t rank) const {
+            if (rank != Rank()) {
+                throw std::invalid_argument("Index error: accessor of rank " + std::to_string(rank) +
+                                            " taken from tensor of rank " + std::to_string(Rank()));
+            }
+        }
+
+        void CheckIndexDim(size_t dim) const {
+            if (dim >= Rank()) {
+                throw std::out_of_range("Index error: dimension (" + std::to_string(dim) +
+                                        ") is out of range for tensor with rank " + std::to_string(Rank()));
+            }
+        }
+
+        template<bool Accumulate>
+        void ScatterInto(size_t dim, const NextTensor<int64_t>& index, const NextTensor<T>& src) {
+            CheckIndexDim(dim);
+            NEXT_PROFILE_OP(Accumulate ? "scatter_add" : "scatter", index.Size(),
+                            index.Size() * ((Accumulate ? 2 : 1) * sizeof(T) + sizeof(int64_t)),
+                            index.Size() * sizeof(T));
+            CheckDestination(*this, Shape());
+            Index::CheckIndexShape(index.Shape(), Shape(), dim, "the tensor");
+            Index::CheckIndexShape(index.Shape(), src.Shape(), src.Rank(), "the source");
+            Index::CheckIndices(index.Data(), index.Shape(), index.Strides(), index.Offset(), Shape()[dim], dim);
+            // Detaches this value from copies first, so only a real view of src or index counts as overlap
+            T* dst = Data();
+            if (Overlaps(src) || Overlaps(index)) {
+                throw std::runtime_error("Output error: scatter destination overlaps its source or index");
+            }
+            auto n_Strides = Strides();
+            n_Strides[dim] = 0;
+            Index::Scatter<Accumulate>(dst, Shape(), n_Strides, Offset(), Strides()[dim], index.Data(), index.Shape(),
+                                       index.Strides(), index.Offset(), src.Data(), src.Strides(), src.Offset(), dim);
+        }
+
+        /**
+         *  @brief Flags of the dimensions named by axes, every dimension when axes is empty
+         * **/
+        [[nodiscard]] AxisMask ReducedAxes(const Dims& axes) const {
+            AxisMask reduced(Rank(), axes.empty());
+            for (const size_t axis : axes) {
+                if (axis >= Rank()) {
+                    throw std::out_of_range("Reduction error: axis (" + std::to_string(axis) +
+                                            ") is out of range for tensor with rank " + std::to_string(Rank()));
                 }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                const auto& shape = this->Shape();
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    size_t indexB = other.Offset() + Next::FlattenIndex(other.Strides(), indices);
-                    resultTensor.Data()[i] = this->Data()[indexA] * other.Data()[indexB];
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < shape[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
+                if (reduced[axis]) {
+                    throw std::runtime_error("Reduction error: axis (" + std::to_string(axis) + ") is repeated");
                 }
+                reduced[axis] = true;
             }
-            return resultTensor;
+            return reduced;
         }
 
-        NextTensor<T> mult(const T& scalar) const {
-            NextTensor<T> resultTensor{this->Shape()};
-            if (this->IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    resultTensor.Data()[i] = this->Data()[i + this->Offset()] * scalar;
-                }
+        /**
+         *  @brief Shape without the reduced dimensions
+         * **/
+        [[nodiscard]] Dims DroppedShape(const AxisMask& reduced) const {
+            Dims shape;
+            for (size_t d = 0; d < Rank(); d++) {
+                if (!reduced[d]) shape.push_back(Shape()[d]);
+            }
+            return shape;
+        }
+
+        /**
+         *  @brief Type mean accumulates and divides in: double for integers, float for 16-bit floats, else T
+         * **/
+        using MeanType = std::conditional_t<std::numeric_limits<T>::is_integer, double,
+                                            std::conditional_t<IsReducedFloat<T>, float, T>>;
+
+        [[nodiscard]] size_t MeanCount(const AxisMask& reduced) const {
+            size_t count = 1;
+            for (size_t d = 0; d < Rank(); d++) {
+                if (reduced[d]) count *= Shape()[d];
+            }
+            if (count == 0) {
+                throw std::runtime_error("Reduction error: mean of an empty selection");
+            }
+            return count;
+        }
+
+        void MeanInto(const Dims& axes, NextTensor<T>& out) const {
+            const auto reduced = ReducedAxes(axes);
+            const size_t count = MeanCount(reduced);
+            if constexpr (std::is_same_v<MeanType, T>) {
+                ReductionInto<Reduce::Kind::SUM>(axes, out);
+                out /= static_cast<T>(count);
             } else {
-                std::vector<size_t> indices(Rank(), 0);
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    resultTensor.Data()[i] = this->Data()[indexA] * scalar;
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < Shape()[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
+                CheckReductionDestination(out, reduced);
+                WidenedReductionInto<Reduce::Kind::SUM, MeanType>(reduced, out, count);
+            }
+        }
+
+        /**
+         *  @brief Reduction accumulated in Acc, which the rows of this tensor are widened to a block at a time;
+         *  the result is divided by count and rounded into out once
+         * **/
+        template<Reduce::Kind K, typename Acc>
+        void WidenedReductionInto(const AxisMask& reduced, NextTensor<T>& out, size_t count = 1) const {
+            if (out.Size() == 0) return;
+            auto result = MakeScratch<Acc>(out.Size());
+            Reduce::ReduceInto<K>(Data(), Shape(), Strides(), Offset(), reduced, result.get());
+            if (count != 1) {
+                for (size_t i = 0; i < out.Size(); i++) result[i] /= static_cast<Acc>(count);
+            }
+            Simd::ConvertRow(result.get(), 1, out.Data() + out.Offset(), 1, out.Size());
+        }
+
+        /**
+         *  @brief Check that out can hold a reduction result: keepdim or dropped shape, contiguous, no overlap
+         * **/
+        template<typename U>
+        void CheckReductionDestination(const NextTensor<U>& out, const AxisMask& reduced) const {
+            const auto keepShape = Reduce::KeepDimShape(Shape(), reduced);
+            if (out.Shape() != keepShape && out.Shape() != DroppedShape(reduced)) {
+                throw std::runtime_error("Output error: destination has shape " + ShapeToString(out.Shape()) +
+                                         ", expected " + ShapeToString(keepShape) + " or " +
+                                         ShapeToString(DroppedShape(reduced)));
+            }
+            if (!out.IsContiguous()) {
+                throw std::runtime_error("Output error: a reduction destination must be contiguous");
+            }
+            if (out.Overlaps(*this)) {
+                throw std::runtime_error("Output error: the reduction destination overlaps its input");
+            }
+        }
+
+        template<Reduce::Kind K>
+        NextTensor<T> Reduction(const Dims& axes, bool keepdim) const {
+            const auto reduced = ReducedAxes(axes);
+            NEXT_PROFILE_OP(Reduce::OpName(K), Size(), Size() * sizeof(T),
+                            ComputeSize(Reduce::KeepDimShape(Shape(), reduced)) * sizeof(T));
+            NextTensor<T> result{Reduce::KeepDimShape(Shape(), reduced), Uninitialized{}};
+            ReductionInto<K>(axes, result);
+            return keepdim ? result : result.reshape(DroppedShape(reduced));
+        }
+
+        template<Reduce::Kind K>
+        void ReductionInto(const Dims& axes, NextTensor<T>& out) const {
+            NEXT_PROFILE_OP(Reduce::OpName(K), Size(), Size() * sizeof(T), out.Size() * sizeof(T));
+            NEXT_PROFILE_WALK(0, !IsContiguous());
+            const auto reduced = ReducedAxes(axes);
+            CheckReductionDestination(out, reduced);
+            if constexpr (K == Reduce::Kind::MAX || K == Reduce::Kind::MIN) {
+                for (size_t d = 0; d < Rank(); d++) {
+                    if (reduced[d] && Shape()[d] == 0) {
+                        throw std::runtime_error("Reduction error: cannot take max/min of an empty dimension");
                     }
                 }
             }
-            return resultTensor;
+            if constexpr (IsReducedFloat<T>) {
+                // Accumulate 16-bit floats in float, a half-precision running sum stalls after ~2048 terms
+                WidenedReductionInto<K, float>(reduced, out);
+            } else if (out.Size() > 0) {
+                Reduce::ReduceInto<K>(Data(), Shape(), Strides(), Offset(), reduced, out.Data() + out.Offset());
+            }
         }
 
-        NextTensor<T> divide(const NextTensor<T>& other) const {
-            if (this->Shape() != other.Shape()) {
-                //TODO: Add broadcasting
-                throw std::runtime_error("Tensor shapes are not compatible for element-wise addition");
-            }
-            NextTensor<T> resultTensor{this->Shape()}; // Result Tensor
-            if (this->IsContiguous() && other.IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    if (other.Data()[i + other.Offset()] == 0) {
-                        throw std::runtime_error("Division by zero");
+        template<bool IsMax>
+        NextTensor<int64_t> ArgReduction(size_t axis, bool keepdim) const {
+            const auto reduced = ReducedAxes({axis});
+            NEXT_PROFILE_OP(IsMax ? "argmax" : "argmin", Size(), Size() * sizeof(T),
+                            Size() / std::max<size_t>(Shape()[axis], 1) * sizeof(int64_t));
+            NextTensor<int64_t> result{Reduce::KeepDimShape(Shape(), reduced), typename NextTensor<int64_t>::Uninitialized{}};
+            ArgReductionInto<IsMax>(axis, result);
+            return keepdim ? result : result.reshape(DroppedShape(reduced));
+        }
+
+        template<bool IsMax>
+        void ArgReductionInto(size_t axis, NextTensor<int64_t>& out) const {
+            NEXT_PROFILE_OP(IsMax ? "argmax" : "argmin", Size(), Size() * sizeof(T), out.Size() * sizeof(int64_t));
+            NEXT_PROFILE_WALK(0, !IsContiguous());
+            const auto reduced = ReducedAxes({axis});
+            CheckReductionDestination(out, reduced);
+            Reduce::ArgReduceInto<IsMax>(Data(), Shape(), Strides(), Offset(), axis, out.Data() + out.Offset());
+        }
+
+        /**
+         *  @brief Validate a matmul and return the shape of its product
+         * **/
+        template<typename A, typename B>
+        [[nodiscard]] static Dims MatmulShape(const NextTensor<A>& a, const NextTensor<B>& b) {
+            if (a.Rank() == 0 || b.Rank() == 0) {
+                throw std::runtime_error("matmul error: operands must have at least one dimension");
+            }
+            const size_t k = a.Shape().back();
+            const size_t bk = b.Rank() == 1 ? b.Shape()[0] : b.Shape()[b.Rank() - 2];
+            if (bk != k) {
+                throw std::runtime_error("matmul error: shapes " + ShapeToString(a.Shape()) + " and " +
+                                         ShapeToString(b.Shape()) + " are not aligned");
+            }
+            const Dims aBatch(a.Shape().begin(), a.Shape().end() - std::min<size_t>(a.Rank(), 2));
+            const Dims bBatch(b.Shape().begin(), b.Shape().end() - std::min<size_t>(b.Rank(), 2));
+            auto shape = Next::BroadcastShapes(aBatch, bBatch);
+            if (a.Rank() != 1) shape.push_back(a.Shape()[a.Rank() - 2]);
+            if (b.Rank() != 1) shape.push_back(b.Shape().back());
+            return shape;
+        }
+
+        struct MatmulBatch;
+
+        /**
+         *  @brief Type a matmul producing T multiplies in: 16-bit floats are a storage format, so their
+         *  product is computed in float and rounded once
+         * **/
+        using MatmulType = std::conditional_t<IsReducedFloat<T>, float, T>;
+
+        /**
+         *  @brief out = a x b, out has MatmulShape(a, b) and arbitrary strides
+         * **/
+        template<typename A, typename B>
+        static void MatmulInto(const NextTensor<A>& a, const NextTensor<B>& b, NextTensor<T>& out) {
+            auto aShape = a.Shape();
+            auto aStrides = a.Strides();
+            auto bShape = b.Shape();
+            auto bStrides = b.Strides();
+            if (a.Rank() == 1) {
+                aShape.insert(aShape.begin(), 1);
+                aStrides.insert(aStrides.begin(), 0);
+            }
+            if (b.Rank() == 1) {
+                bShape.push_back(1);
+                bStrides.push_back(0);
+            }
+
+            const size_t m = aShape[aShape.size() - 2];
+            const size_t k = aShape.back();
+            const size_t n = bShape.back();
+
+            const Dims aBatch(aShape.begin(), aShape.end() - 2);
+            const Dims bBatch(bShape.begin(), bShape.end() - 2);
+            const auto batch = Next::BroadcastShapes(aBatch, bBatch);
+            const auto aBatchStrides = Next::BroadcastStrides(
+                aBatch, Dims(aStrides.begin(), aStrides.end() - 2), batch);
+            const auto bBatchStrides = Next::BroadcastStrides(
+                bBatch, Dims(bStrides.begin(), bStrides.end() - 2), batch);
+
+            // out drops the row / column dimension of a vector operand, its stride is then never used
+            const auto& outStrides = out.Strides();
+            const Dims cBatchStrides(outStrides.begin(), outStrides.begin() + batch.size());
+            const size_t rsC = a.Rank() == 1 ? 0 : outStrides[batch.size()];
+            const size_t csC = b.Rank() == 1 ? 0 : outStrides.back();
+
+            // Offsets of every matrix in the batch, then one GEMM per matrix
+            const size_t batchSize = ComputeSize(batch);
+            auto* matrices = ThreadScratch<MatmulBatch, std::array<size_t, 3>>(batchSize);
+            size_t filled = 0;
+            Next::ForEachStrided<3>(batch, {&aBatchStrides, &bBatchStrides, &cBatchStrides},
+                                    {a.Offset(), b.Offset(), out.Offset()},
+                [&](const std::array<size_t, 3>& offsets, const std::array<size_t, 3>& steps, size_t count) {
+                    for (size_t i = 0; i < count; i++) {
+                        matrices[filled++] = {offsets[0] + i * steps[0], offsets[1] + i * steps[1],
+                                              offsets[2] + i * steps[2]};
                     }
-                    resultTensor.Data()[i] = this->Data()[i + this->Offset()] / other.Data()[i + other.Offset()];
+                });
+
+            const A* aData = a.Data();
+            const B* bData = b.Data();
+            T* cData = out.Data();
+            const size_t rsA = aStrides[aStrides.size() - 2], csA = aStrides.back();
+            const size_t rsB = bStrides[bStrides.size() - 2], csB = bStrides.back();
+            // Gemm packs both operands either way; strided ones are gathered element by element while packing
+            NEXT_PROFILE_WALK(batchSize * m, csA != 1 || csB != 1);
+            const bool single = batchSize == 1;
+            const size_t grain = std::max<size_t>(1, (size_t{1} << 20) / (m * n * k + 1));
+
+            Next::ParallelFor(0, batchSize, grain, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    const auto& off = matrices[i];
+                    Next::Gemm::Gemm<MatmulType>(m, n, k, Next::Gemm::MatrixRef<const A>{aData + off[0], rsA, csA},
+                                                 Next::Gemm::MatrixRef<const B>{bData + off[1], rsB, csB},
+                                                 Next::Gemm::MatrixRef<T>{cData + off[2], rsC, csC}, single);
                 }
-            } else {
-                std::vector<size_t> indices(Rank(), 0);
-                const auto& shape = this->Shape();
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    size_t indexB = other.Offset() + Next::FlattenIndex(other.Strides(), indices);
-                    if (other.Data()[indexB] == 0) {
-                        throw std::runtime_error("Division by zero");
-                    }
-                    resultTensor.Data()[i] = this->Data()[indexA] / other.Data()[indexB];
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < shape[d]) {
-                            break;
-                        }
-                        indices[d] = 0;
-                    }
+            });
+        }
+
+        /**
+         *  @brief out[i] = U(this[i]); shapes already match
+         * **/
+        template<typename U>
+        void ConvertInto(NextTensor<U>& out) const {
+            NEXT_PROFILE_OP("to", Size(), Size() * sizeof(T), Size() * sizeof(U));
+            const T* src = Data();
+            U* dst = out.Data();
+            Next::ParallelForEachStrided<2>(Shape(), {&out.Strides(), &Strides()}, {out.Offset(), Offset()},
+                [&](const std::array<size_t, 2>& offsets, const std::array<size_t, 2>& steps, size_t count) {
+                    Simd::ConvertRow(src + offsets[1], steps[1], dst + offsets[0], steps[0], count);
+                });
+        }
+
+        // Destination checks of the output-parameter forms (see the aliasing rule of the element-wise section)
+
+        /**
+         *  @brief Whether the elements of this view and other share any storage
+         *
+         *  Only views of the same storage cell can: a copy-on-write copy still reads the same block, but
+         *  writing through either value detaches it first, so the two are disjoint.
+         * **/
+        template<typename U>
+        [[nodiscard]] bool Overlaps(const NextTensor<U>& other) const {
+            if (!m_Storage || m_Storage != other.m_Storage) return false;
+            const auto a = MemorySpan(Shape(), Strides(), Offset());
+            const auto b = MemorySpan(other.Shape(), other.Strides(), other.Offset());
+            if (a[0] == a[1] || b[0] == b[1]) return false;
+            return a[0] * sizeof(T) < b[1] * sizeof(U) && b[0] * sizeof(U) < a[1] * sizeof(T);
+        }
+
+        /**
+         *  @brief out must have exactly shape and write every element once (no stride-0 dimension)
+         * **/
+        template<typename U>
+        static void CheckDestination(const NextTensor<U>& out, const Dims& shape) {
+            if (out.Shape() != shape) {
+                throw std::runtime_error("Output error: destination has shape " + ShapeToString(out.Shape()) +
+                                         ", expected " + ShapeToString(shape));
+            }
+            for (size_t d = 0; d < out.Rank(); d++) {
+                if (out.Strides()[d] == 0 && out.Shape()[d] > 1) {
+                    throw std::runtime_error("Output error: destination " + ShapeToString(out.Shape()) +
+                                             " repeats elements along dimension " + std::to_string(d));
                 }
             }
-            return resultTensor;
         }
 
-        NextTensor<T> divide(const T& scalar) const {
-            NextTensor<T> resultTensor{this->Shape()};
-            if (this->IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    if (scalar == 0) {
-                        throw std::runtime_error("Division by zero");
+        /**
+         *  @brief out may be the exact view an element-wise operand is read through (strides broadcast to
+         *  out's shape), any other overlap is rejected
+         * **/
+        template<typename U, typename V>
+        static void CheckAlias(const NextTensor<U>& out, const NextTensor<V>& input, const Dims& inputStrides) {
+            if (!out.Overlaps(input)) return;
+            bool same = std::is_same_v<U, V> && out.Offset() == input.Offset();
+            for (size_t d = 0; same && d < out.Rank(); d++) {
+                same = out.Shape()[d] == 1 || out.Strides()[d] == inputStrides[d];
+            }
+            if (!same) {
+                throw std::runtime_error("Output error: destination partially overlaps an operand");
+            }
+        }
+
+        // Shared element-wise drivers: every op above runs through Next::ParallelForEachStrided, which hands
+        // over one inner row at a time and splits large tensors across the intra-op thread pool. Rows that
+        // are contiguous (or broadcast a single value) go to the SIMD kernel table when the op is one of
+        // Simd::Arith, everything else runs a pointer-bumping loop.
+
+        /**
+         *  @brief Name an element-wise op is profiled under
+         * **/
+        template<typename Op>
+        static constexpr const char* OpName() {
+            if constexpr (requires { Op::Kind; }) return Simd::OpName(Op::Kind);
+            else return "apply";
+        }
+
+        /**
+         *  @brief out[i] = op(a[i], b[i]) for one row, a step of zero repeats a single value
+         *
+         *  Operands of another element type are converted into T a block at a time first.
+         * **/
+        template<typename A, typename B, typename Op>
+        static void BinaryRow(T* out, const A* a, const B* b,
+                              size_t outStep, size_t aStep, size_t bStep, size_t count, Op op) {
+            if constexpr (!std::is_same_v<A, T> || !std::is_same_v<B, T>) {
+                constexpr size_t Block = 256;
+                T ta[Block], tb[Block];
+                for (size_t i = 0; i < count; i += Block) {
+                    const size_t n = std::min(Block, count - i);
+                    const T* pa = RowAs(a + i * aStep, aStep, n, ta);
+                    const T* pb = RowAs(b + i * bStep, bStep, n, tb);
+                    BinaryRow(out + i * outStep, pa, pb, outStep, RowStep<A>(aStep), RowStep<B>(bStep), n, op);
+                }
+            } else if constexpr (IsReducedFloat<T> && requires { Op::Kind; }) {
+                // Widen a block of each operand to float, run the float kernel and round the result back
+                constexpr size_t Block = 256;
+                constexpr auto idx = static_cast<size_t>(Op::Kind);
+                const auto& kernels = Simd::Kernels<float>();
+                float fa[Block], fb[Block], fo[Block];
+                for (size_t i = 0; i < count; i += Block) {
+                    const size_t n = std::min(Block, count - i);
+                    Simd::ConvertRow(a + i * aStep, aStep, fa, 1, aStep == 0 ? 1 : n);
+                    Simd::ConvertRow(b + i * bStep, bStep, fb, 1, bStep == 0 ? 1 : n);
+                    if (aStep == 0 && bStep == 0) {
+                        std::fill(fo, fo + n, Simd::ScalarApply<Op::Kind>(fa[0], fb[0]));
+                    } else if (bStep == 0) {
+                        kernels.Scalar[idx](fo, fa, fb[0], n);
+                    } else if (aStep == 0) {
+                        kernels.RScalar[idx](fo, fa[0], fb, n);
+                    } else {
+                        kernels.Binary[idx](fo, fa, fb, n);
                     }
-                    resultTensor.Data()[i] = this->Data()[i + this->Offset()] / scalar;
+                    Simd::ConvertRow(fo, 1, out + i * outStep, outStep, n);
                 }
             } else {
-                std::vector<size_t> indices(Rank(), 0);
-                for (size_t i = 0; i < Size(); i++) {
-                    if (scalar == 0) {
-                        throw std::runtime_error("Division by zero");
-                    }
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    resultTensor.Data()[i] = this->Data()[indexA] / scalar;
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < Shape()[d]) {
-                            break;
+                if constexpr (Simd::HasKernels<T> && requires { Op::Kind; }) {
+                    if (outStep == 1) {
+                        const auto& kernels = Simd::Kernels<T>();
+                        constexpr auto idx = static_cast<size_t>(Op::Kind);
+                        if (aStep == 1 && bStep == 1) {
+                            kernels.Binary[idx](out, a, b, count);
+                            return;
+                        }
+                        if (aStep == 1 && bStep == 0) {
+                            kernels.Scalar[idx](out, a, *b, count);
+                            return;
+                        }
+                        if (aStep == 0 && bStep == 1) {
+                            kernels.RScalar[idx](out, *a, b, count);
+                            return;
                         }
-                        indices[d] = 0;
                     }
                 }
+                for (size_t i = 0; i < count; i++, out += outStep, a += aStep, b += bStep) {
+                    *out = op(*a, *b);
+                }
             }
-            return resultTensor;
         }
 
-        NextTensor<T> rdivide(const T& scalar) const {
-            NextTensor<T> resultTensor{this->Shape()};
-            if (this->IsContiguous()) {
-                for (size_t i = 0; i < Size(); i++) {
-                    if (this->Data()[i + this->Offset()] == 0) {
-                        throw std::runtime_error("Division by zero");
-                    }
-                    resultTensor.Data()[i] = scalar / this->Data()[i + this->Offset()];
-                }
+        /**
+         *  @brief n elements of a row as T: the row itself, or converted into buffer when U is another type
+         *  (a single element when step is zero)
+         * **/
+        template<typename U>
+        static const T* RowAs(const U* src, size_t step, size_t n, T* buffer) {
+            if constexpr (std::is_same_v<U, T>) {
+                return src;
             } else {
-                std::vector<size_t> indices(Rank(), 0);
-                for (size_t i = 0; i < Size(); i++) {
-                    size_t indexA = this->Offset() + Next::FlattenIndex(this->Strides(), indices);
-                    if (this->Data()[indexA] == 0) {
-                        throw std::runtime_error("Division by zero");
-                    }
-                    resultTensor.Data()[i] = scalar / this->Data()[indexA];
-                    for (int d = Rank() - 1; d >= 0; --d) {
-                        if (++indices[d] < Shape()[d]) {
-                            break;
+                Simd::ConvertRow(src, step, buffer, 1, step == 0 ? 1 : n);
+                return buffer;
+            }
+        }
+
+        /**
+         *  @brief Step of a row returned by RowAs
+         * **/
+        template<typename U>
+        static size_t RowStep(size_t step) {
+            if constexpr (std::is_same_v<U, T>) return step;
+            else return step == 0 ? 0 : 1;
+        }
+
+        /**
+         *  @brief Integer divisors are checked once up front instead of branching inside the division loop
+         *
+         *  Floating point division is left to IEEE 754 (x / 0 is a signed infinity, 0 / 0 is NaN), so for
+         *  those types there is nothing to check. A row is scanned without an early exit: the comparison
+         *  vectorizes and the division that follows reads the same memory anyway.
+         * **/
+        static void CheckNonZero(const NextTensor<T>& tensor) {
+            if constexpr (std::numeric_limits<T>::is_integer) {
+                const T* src = tensor.Data();
+                Next::ParallelForEachStrided<1>(tensor.Shape(), {&tensor.Strides()}, {tensor.Offset()},
+                    [&](const std::array<size_t, 1>& offsets, const std::array<size_t, 1>& steps, size_t count) {
+                        const T* a = src + offsets[0];
+                        size_t zeros = 0;
+                        if (steps[0] == 1) {
+                            for (size_t i = 0; i < count; i++) zeros += a[i] == 0;
+                        } else {
+                            for (size_t i = 0; i < count; i++) zeros += a[i * steps[0]] == 0;
                         }
-                        indices[d] = 0;
-                    }
+                        if (zeros != 0) {
+                            throw std::runtime_error("Division by zero");
+                        }
+                    });
+            }
+        }
+
+        static void CheckNonZero(const T& scalar) {
+            if constexpr (std::numeric_limits<T>::is_integer) {
+                if (scalar == 0) {
+                    throw std::runtime_error("Division by zero");
                 }
             }
+        }
+
+        /**
+         *  @brief result[i] = op(this[i] + bias[i]) over the broadcast shape, op(this[i]) without a bias
+         * **/
+        NextTensor<T> Unary(Math::UnaryOp op, const NextTensor<T>* bias = nullptr) const {
+            return promoted_activation(*this, op, bias);
+        }
+
+        NextTensor<T>& UnaryInto(NextTensor<T>& out, Math::UnaryOp op, const NextTensor<T>* bias = nullptr) const {
+            return promoted_activation(*this, op, bias, out);
+        }
+
+        template<typename A, typename B>
+        static void UnaryWrite(NextTensor<T>& out, const NextTensor<A>& a, Math::UnaryOp op, const NextTensor<B>* bias) {
+            static_assert(Math::HasMath<T>, "Math ops need a floating point element type");
+            const auto stridesA = Next::BroadcastStrides(a.Shape(), a.Strides(), out.Shape());
+            // Without a bias the input's strides stand in for the unused third operand
+            const auto stridesB = bias ? Next::BroadcastStrides(bias->Shape(), bias->Strides(), out.Shape()) : stridesA;
+            T* dst = out.Data();
+            const A* src = a.Data();
+            const B* srcBias = bias ? bias->Data() : nullptr;
+            Next::ParallelForEachStrided<3>(out.Shape(), {&out.Strides(), &stridesA, &stridesB},
+                                    {out.Offset(), a.Offset(), bias ? bias->Offset() : a.Offset()},
+                [&](const std::array<size_t, 3>& offsets, const std::array<size_t, 3>& steps, size_t count) {
+                    Math::UnaryRow(op, dst + offsets[0], steps[0], src + offsets[1], steps[1],
+                                   srcBias ? srcBias + offsets[2] : nullptr, srcBias ? steps[2] : 0, count);
+                });
+        }
+
+        /**
+         *  @brief this[i] = op(this[i])
+         * **/
+        template<typename Op>
+        void ApplyInPlace(Op op) {
+            T* dst = this->Data();
+            Next::ParallelForEachStrided<1>(Shape(), {&Strides()}, {Offset()},
+                [&](const std::array<size_t, 1>& offsets, const std::array<size_t, 1>& steps, size_t count) {
+                    T* a = dst + offsets[0];
+                    if (steps[0] == 1) {
+                        for (size_t i = 0; i < count; i++) {
+                            a[i] = op(a[i]);
+                        }
+                    } else {
+                        for (size_t i = 0; i < count; i++, a += steps[0]) {
+                            *a = op(*a);
+                        }
+                    }
+                });
+        }
+
+        /**
+         *  @brief this[i] = op(this[i], other[i]), other is broadcast to this tensor's shape
+         * **/
+        template<typename Op>
+        void ApplyInPlace(const NextTensor<T>& other, Op op) {
+            ApplyInto(*this, other, op);
+        }
+
+        /**
+         *  @brief this[i] = op(this[i], scalar)
+         * **/
+        template<typename Op>
+        void ApplyInPlace(const T& scalar, Op op) {
+            ApplyInto(*this, scalar, op);
+        }
+
+        /**
+         *  @brief result[i] = op(this[i], other[i]) over the broadcast shape of both operands
+         * **/
+        template<typename Op>
+        NextTensor<T> Apply(const NextTensor<T>& other, Op op) const {
+            NextTensor<T> resultTensor{Next::BroadcastShapes(this->Shape(), other.Shape()), Uninitialized{}};
+            BinaryInto(resultTensor, *this, other, op);
+            return resultTensor;
+        }
+
+        /**
+         *  @brief result[i] = op(this[i], scalar), or op(scalar, this[i]) when scalarFirst is set
+         * **/
+        template<typename Op>
+        NextTensor<T> Apply(const T& scalar, Op op, bool scalarFirst = false) const {
+            NEXT_PROFILE_OP(OpName<Op>(), Size(), Size() * sizeof(T), Size() * sizeof(T));
+            NextTensor<T> resultTensor{this->Shape(), Uninitialized{}};
+            ScalarInto(resultTensor, scalar, op, scalarFirst);
             return resultTensor;
         }
+
+        /**
+         *  @brief Apply(other, op) written into a caller-provided destination
+         * **/
+        template<typename Op>
+        void ApplyInto(NextTensor<T>& out, const NextTensor<T>& other, Op op) const {
+            BinaryInto(out, *this, other, op);
+        }
+
+        /**
+         *  @brief Apply(scalar, op, scalarFirst) written into a caller-provided destination
+         * **/
+        template<typename Op>
+        void ApplyInto(NextTensor<T>& out, const T& scalar, Op op, bool scalarFirst = false) const {
+            NEXT_PROFILE_OP(OpName<Op>(), out.Size(), Size() * sizeof(T), out.Size() * sizeof(T));
+            CheckDestination(out, Shape());
+            CheckAlias(out, *this, Strides());
+            ScalarInto(out, scalar, op, scalarFirst);
+        }
+
+        /**
+         *  @brief out[i] = op(a[i], b[i]) over the broadcast shape of a and b, which out must have
+         * **/
+        template<typename A, typename B, typename Op>
+        static void BinaryInto(NextTensor<T>& out, const NextTensor<A>& a, const NextTensor<B>& b, Op op) {
+            NEXT_PROFILE_OP(OpName<Op>(), out.Size(), a.Size() * sizeof(A) + b.Size() * sizeof(B), out.Size() * sizeof(T));
+            const auto shape = Next::BroadcastShapes(a.Shape(), b.Shape());
+            CheckDestination(out, shape);
+            const auto stridesA = Next::BroadcastStrides(a.Shape(), a.Strides(), shape);
+            const auto stridesB = Next::BroadcastStrides(b.Shape(), b.Strides(), shape);
+            CheckAlias(out, a, stridesA);
+            CheckAlias(out, b, stridesB);
+            T* dst = out.Data();
+            const A* srcA = a.Data();
+            const B* srcB = b.Data();
+            Next::ParallelForEachStrided<3>(out.Shape(), {&out.Strides(), &stridesA, &stridesB},
+                                    {out.Offset(), a.Offset(), b.Offset()},
+                [&](const std::array<size_t, 3>& offsets, const std::array<size_t, 3>& steps, size_t count) {
+                    BinaryRow(dst + offsets[0], srcA + offsets[1], srcB + offsets[2],
+                              steps[0], steps[1], steps[2], count, op);
+                });
+        }
+
+        template<typename Op>
+        void ScalarInto(NextTensor<T>& out, const T& scalar, Op op, bool scalarFirst) const {
+            T* dst = out.Data();
+            const T* src = this->Data();
+            Next::ParallelForEachStrided<2>(Shape(), {&out.Strides(), &Strides()}, {out.Offset(), Offset()},
+                [&](const std::array<size_t, 2>& offsets, const std::array<size_t, 2>& steps, size_t count) {
+                    if (scalarFirst) {
+                        BinaryRow(dst + offsets[0], &scalar, src + offsets[1], steps[0], 0, steps[1], count, op);
+                    } else {
+                        BinaryRow(dst + offsets[0], src + offsets[1], &scalar, steps[0], steps[1], 0, count, op);
+                    }
+                });
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,296 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "NextTensor.h"
+#include "../utils/NextQuant.h"
+
+namespace Next {
+    //*
+    //@brief Scale / zero-point pairs mapping int8 values q to real values (q - zeroPoint) * scale.
+    //
+    // Per-tensor parameters hold a single pair; per-channel parameters one pair per index along Axis.
+    //*/
+    struct QuantParams {
+        std::vector<float> Scales;
+        std::vector<int32_t> ZeroPoints;
+        std::optional<size_t> Axis;     // Unset for per-tensor parameters
+
+        [[nodiscard]] bool IsPerChannel() const { return Axis.has_value(); }
+
+        [[nodiscard]] static QuantParams PerTensor(float scale, int32_t zeroPoint = 0) {
+            return {{scale}, {zeroPoint}, std::nullopt};
+        }
+
+        [[nodiscard]] static QuantParams PerChannel(size_t axis, std::vector<float> scales,
+                                                    std::vector<int32_t> zeroPoints) {
+            return {std::move(scales), std::move(zeroPoints), axis};
+        }
+    };
+
+    namespace Detail {
+        inline void CheckQuantParams(const QuantParams& params, const Dims& shape) {
+            if (params.IsPerChannel() && *params.Axis >= shape.size()) {
+                throw std::out_of_range("Quantization error: axis " + std::to_string(*params.Axis) +
+                                        " out of range for rank " + std::to_string(shape.size()));
+            }
+            const size_t channels = params.IsPerChannel() ? shape[*params.Axis] : 1;
+            if (params.Scales.size() != channels || params.ZeroPoints.size() != channels) {
+                throw std::runtime_error("Quantization error: expected " + std::to_string(channels) +
+                                         " scales and zero points, got " + std::to_string(params.Scales.size()) +
+                                         " and " + std::to_string(params.ZeroPoints.size()));
+            }
+            for (size_t c = 0; c < channels; c++) {
+                if (!(params.Scales[c] > 0.0f) || !std::isfinite(params.Scales[c])) {
+                    throw std::runtime_error("Quantization error: scales must be positive and finite");
+                }
+                if (params.ZeroPoints[c] < Quant::QMin || params.ZeroPoints[c] > Quant::QMax) {
+                    throw std::runtime_error("Quantization error: zero points must lie in [-128, 127]");
+                }
+            }
+        }
+
+        /**
+         *  @brief Call fn(first, count, channel, channelStep) over rows of a contiguous tensor of shape
+         *
+         *  Row i element j uses the parameters of channel + j * channelStep: one channel per row when the
+         *  channel axis is not innermost, one per element (channelStep 1) when it is.
+         * **/
+        template<typename Fn>
+        void ForEachQuantRow(const Dims& shape, const std::optional<size_t>& axis, Fn&& fn) {
+            const size_t size = Next::ComputeSize(shape);
+            if (!axis) {
+                Next::ParallelFor(0, size, DefaultGrainSize, [&](size_t begin, size_t end) {
+                    fn(begin, end - begin, 0, 0);
+                });
+                return;
+            }
+            const size_t channels = shape[*axis];
+            size_t inner = 1;
+            for (size_t d = *axis + 1; d < shape.size(); d++) inner *= shape[d];
+            if (size == 0) return;
+
+            if (inner == 1) {
+                Next::ParallelFor(0, size / channels, std::max<size_t>(1, DefaultGrainSize / channels),
+                    [&](size_t begin, size_t end) {
+                        for (size_t r = begin; r < end; r++) fn(r * channels, channels, 0, 1);
+                    });
+            } else {
+                Next::ParallelFor(0, size / inner, std::max<size_t>(1, DefaultGrainSize / inner),
+                    [&](size_t begin, size_t end) {
+                        for (size_t r = begin; r < end; r++) fn(r * inner, inner, r % channels, 0);
+                    });
+            }
+        }
+    }
+
+    /**
+     *  @brief Parameters covering the value range of tensor, per tensor or per channel along axis
+     *
+     *  Asymmetric parameters map [min(x, 0), max(x, 0)] onto [-128, 127]; symmetric ones use zero point 0
+     *  and max|x| / 127 as scale (the usual choice for weights). An all-zero range gets scale 1.
+     * **/
+    inline QuantParams ChooseQuantParams(const NextTensor<float>& tensor, std::optional<size_t> axis = std::nullopt,
+                                         bool symmetric = false) {
+        if (axis && *axis >= tensor.Rank()) {
+            throw std::out_of_range("Quantization error: axis " + std::to_string(*axis) + " out of range for rank " +
+                                    std::to_string(tensor.Rank()));
+        }
+        const size_t channels = axis ? tensor.Shape()[*axis] : 1;
+        QuantParams params{std::vector<float>(channels, 1.0f), std::vector<int32_t>(channels, 0), axis};
+        if (tensor.Size() == 0) return params;
+
+        Dims others;
+        for (size_t d = 0; d < tensor.Rank(); d++) {
+            if (!axis || d != *axis) others.push_back(d);
+        }
+        // Reducing over no axes would reduce over all of them, a rank-1 per-channel tensor is its own range
+        const bool whole = axis && others.empty();
+        const auto lo = whole ? tensor : tensor.min(others);
+        const auto hi = whole ? tensor : tensor.max(others);
+        auto at = [](const NextTensor<float>& t, size_t c) {
+            return t.Data()[t.Offset() + (t.Rank() == 0 ? 0 : c * t.Strides()[0])];
+        };
+
+        for (size_t c = 0; c < channels; c++) {
+            const float low = std::min(at(lo, c), 0.0f);
+            const float high = std::max(at(hi, c), 0.0f);
+            if (symmetric) {
+                const float scale = std::max(-low, high) / static_cast<float>(Quant::QMax);
+                params.Scales[c] = scale > 0.0f ? scale : 1.0f;
+            } else {
+                const float scale = (high - low) / static_cast<float>(Quant::QMax - Quant::QMin);
+                params.Scales[c] = scale > 0.0f ? scale : 1.0f;
+                const float zero = std::nearbyint(static_cast<float>(Quant::QMin) - low / params.Scales[c]);
+                params.ZeroPoints[c] = static_cast<int32_t>(
+                    std::clamp(zero, static_cast<float>(Quant::QMin), static_cast<float>(Quant::QMax)));
+            }
+        }
+        Detail::CheckQuantParams(params, tensor.Shape());
+        return params;
+    }
+
+    /**
+     *  @brief int8 x int8 matrix product accumulated exactly in int32 (zero points are not applied)
+     *
+     *  Both operands must be matrices; transposed and sliced operands are read through their strides.
+     * **/
+    inline NextTensor<int32_t> MatmulInt32(const NextTensor<int8_t>& a, const NextTensor<int8_t>& b) {
+        if (a.Rank() != 2 || b.Rank() != 2) {
+            throw std::runtime_error("matmul error: int8 matmul needs two matrices");
+        }
+        const size_t m = a.Shape()[0], k = a.Shape()[1], n = b.Shape()[1];
+        if (b.Shape()[0] != k) {
+            throw std::runtime_error("matmul error: shapes " + ShapeToString(a.Shape()) + " and " +
+                                     ShapeToString(b.Shape()) + " are not aligned");
+        }
+        NextTensor<int32_t> result{Next::AllocateStorage<int32_t>(m * n, false), NextMetadata{Dims{m, n}, DType::INT32}};
+        Quant::GemmInt8(m, n, k, {a.Data() + a.Offset(), a.Strides()[0], a.Strides()[1]},
+                        {b.Data() + b.Offset(), b.Strides()[0], b.Strides()[1]}, {result.Data(), n, 1});
+        return result;
+    }
+
+    //*
+    //@brief int8 tensor with its quantization parameters.
+    //*/
+    class QuantizedTensor {
+    private:
+        NextTensor<int8_t> m_Values;
+        QuantParams m_Params;
+
+    public:
+        QuantizedTensor(NextTensor<int8_t> values, QuantParams params)
+            : m_Values(std::move(values)), m_Params(std::move(params)) {
+            Detail::CheckQuantParams(m_Params, m_Values.Shape());
+        }
+
+        [[nodiscard]] const NextTensor<int8_t>& Values() const { return m_Values; }
+
+        [[nodiscard]] const QuantParams& Params() const { return m_Params; }
+
+        [[nodiscard]] const Dims& Shape() const { return m_Values.Shape(); }
+
+        [[nodiscard]] size_t Rank() const { return m_Values.Rank(); }
+
+        [[nodiscard]] size_t Size() const { return m_Values.Size(); }
+
+        /**
+         *  @brief Real values (q - zeroPoint) * scale as a contiguous float tensor
+         * **/
+        [[nodiscard]] NextTensor<float> dequantize() const {
+            const auto values = m_Values.contiguous();
+            NextTensor<float> result{Next::AllocateStorage<float>(Size(), false), NextMetadata{Shape(), DType::FLOAT32}};
+            const std::vector<float> zeroPoints(m_Params.ZeroPoints.begin(), m_Params.ZeroPoints.end());
+            const int8_t* src = values.Data() + values.Offset();
+            float* dst = result.Data();
+            Detail::ForEachQuantRow(Shape(), m_Params.Axis, [&](size_t first, size_t count, size_t c, size_t step) {
+                Quant::DequantizeRow(src + first, dst + first, count, m_Params.Scales.data() + c,
+                                     zeroPoints.data() + c, step);
+            });
+            return result;
+        }
+
+        /**
+         *  @brief Quantized matrix product, requantized to the per-tensor output parameters
+         *
+         *  The lhs must be quantized per tensor; the rhs per tensor or per output column (axis 1). Products
+         *  accumulate exactly in int32 and are rescaled by lhsScale * rhsScale / outputScale in float.
+         * **/
+        [[nodiscard]] QuantizedTensor matmul(const QuantizedTensor& other, const QuantParams& output) const {
+            if (m_Params.IsPerChannel() || output.IsPerChannel()) {
+                throw std::runtime_error("Quantization error: matmul needs per-tensor lhs and output parameters");
+            }
+            if (other.m_Params.IsPerChannel() && *other.m_Params.Axis != 1) {
+                throw std::runtime_error("Quantization error: matmul rhs can only be quantized per column (axis 1)");
+            }
+            auto acc = MatmulInt32(m_Values, other.m_Values);
+            const size_t m = acc.Shape()[0], n = acc.Shape()[1], k = Shape()[1];
+            Detail::CheckQuantParams(output, acc.Shape());
+
+            const bool rhsPerChannel = other.m_Params.IsPerChannel();
+            const int64_t zeroA = m_Params.ZeroPoints[0];
+            std::vector<int64_t> zeroB(n), colTerm(n, 0), rowSum(m, 0);
+            std::vector<float> multiplier(n);
+            bool anyZeroB = false;
+            for (size_t j = 0; j < n; j++) {
+                const size_t c = rhsPerChannel ? j : 0;
+                zeroB[j] = other.m_Params.ZeroPoints[c];
+                anyZeroB = anyZeroB || zeroB[j] != 0;
+                multiplier[j] = static_cast<float>(static_cast<double>(m_Params.Scales[0]) * other.m_Params.Scales[c] /
+                                                   output.Scales[0]);
+            }
+
+            // sum_k (a - za)(b - zb) = sum_k ab - zb * sum_k a - za * sum_k b + k * za * zb
+            const auto& a = m_Values;
+            const auto& b = other.m_Values;
+            if (zeroA != 0) {
+                for (size_t p = 0; p < k; p++) {
+                    const int8_t* row = b.Data() + b.Offset() + p * b.Strides()[0];
+                    for (size_t j = 0; j < n; j++) colTerm[j] += row[j * b.Strides()[1]];
+                }
+                for (size_t j = 0; j < n; j++) {
+                    colTerm[j] = zeroA * colTerm[j] - static_cast<int64_t>(k) * zeroA * zeroB[j];
+                }
+            }
+            if (anyZeroB) {
+                for (size_t i = 0; i < m; i++) {
+                    const int8_t* row = a.Data() + a.Offset() + i * a.Strides()[0];
+                    for (size_t p = 0; p < k; p++) rowSum[i] += row[p * a.Strides()[1]];
+                }
+            }
+
+            NextTensor<int8_t> result{Next::AllocateStorage<int8_t>(m * n, false), NextMetadata{Dims{m, n}, DType::INT8}};
+            const std::vector<float> zeroOut(n, static_cast<float>(output.ZeroPoints[0]));
+            const bool correct = zeroA != 0 || anyZeroB;
+            Next::ParallelFor(0, m, std::max<size_t>(1, DefaultGrainSize / std::max<size_t>(n, 1)),
+                [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        int32_t* row = acc.Data() + i * n;
+                        if (correct) {
+                            for (size_t j = 0; j < n; j++) {
+                                row[j] = static_cast<int32_t>(row[j] - zeroB[j] * rowSum[i] - colTerm[j]);
+                            }
+                        }
+                        Quant::QuantizeRow(row, result.Data() + i * n, n, multiplier.data(), zeroOut.data(), 1);
+                    }
+                });
+            return {std::move(result), output};
+        }
+    };
+
+    /**
+     *  @brief Quantize tensor with params; values outside the representable range saturate
+     * **/
+    inline QuantizedTensor Quantize(const NextTensor<float>& tensor, const QuantParams& params) {
+        Detail::CheckQuantParams(params, tensor.Shape());
+        const auto source = tensor.contiguous();
+        NextTensor<int8_t> values{Next::AllocateStorage<int8_t>(tensor.Size(), false),
+                                  NextMetadata{tensor.Shape(), DType::INT8}};
+        std::vector<float> invScales(params.Scales.size());
+        for (size_t c = 0; c < invScales.size(); c++) invScales[c] = 1.0f / params.Scales[c];
+        const std::vector<float> zeroPoints(params.ZeroPoints.begin(), params.ZeroPoints.end());
+        const float* src = source.Data() + source.Offset();
+        int8_t* dst = values.Data();
+        Detail::ForEachQuantRow(tensor.Shape(), params.Axis, [&](size_t first, size_t count, size_t c, size_t step) {
+            Quant::QuantizeRow(src + first, dst + first, count, invScales.data() + c, zeroPoints.data() + c, step);
+        });
+        return {std::move(values), params};
+    }
+
+    /**
+     *  @brief Quantize with parameters chosen from the value range, see ChooseQuantParams
+     * **/
+    inline QuantizedTensor Quantize(const NextTensor<float>& tensor, std::optional<size_t> axis = std::nullopt,
+                                    bool symmetric = false) {
+        return Quantize(tensor, ChooseQuantParams(tensor, axis, symmetric));
+    }
+}
@@ -0,0 +1,466 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "NextMetadata.h"
+#include "NextTensor.h"
+#include "../utils/NextMath.h"
+#include "../utils/NextReduce.h"
+#include "../utils/NextView.h"
+#include "../utils/SimdKernels.h"
+
+namespace Next {
+    class Tensor;
+
+    //*
+    //@brief Typed implementations of every Tensor op for one DType.
+    //
+    // One table per DType is instantiated in src/core/Tensor.cpp, so code using Tensor never instantiates the
+    // NextTensor<T> templates itself; the kernels behind the table are the same specialized (SIMD, GEMM,
+    // reduction) paths NextTensor<T> uses. The binary, matmul and math kernels also take operands of other
+    // DTypes that compute in the table's DType (see PromoteTypes) and convert them as they read them.
+    //*/
+    struct TensorKernels {
+        Tensor (*Zeros)(const Dims& shape);
+        std::array<Tensor (*)(const Tensor&, const Tensor&), static_cast<size_t>(Simd::BinaryOp::COUNT)> Binary;
+        std::array<Tensor (*)(const Tensor&, double, bool scalarFirst), static_cast<size_t>(Simd::BinaryOp::COUNT)> Scalar;
+        std::array<void (*)(Tensor&, const Tensor&), static_cast<size_t>(Simd::BinaryOp::COUNT)> BinaryInPlace;
+        std::array<void (*)(const Tensor&, const Tensor&, Tensor& out), static_cast<size_t>(Simd::BinaryOp::COUNT)> BinaryOut;
+        void (*Fill)(Tensor&, double value);
+        std::array<Tensor (*)(const Tensor&, const Dims& axes, bool keepdim), 4> Reduce;    // Indexed by Reduce::Kind
+        Tensor (*Mean)(const Tensor&, const Dims& axes, bool keepdim);
+        std::array<Tensor (*)(const Tensor&, size_t axis, bool keepdim), 2> ArgReduce;      // [0] argmin, [1] argmax
+        // Indexing, index is INT64 and mask BOOL
+        Tensor (*IndexSelect)(const Tensor&, size_t dim, const Tensor& index);
+        Tensor (*Gather)(const Tensor&, size_t dim, const Tensor& index);
+        std::array<void (*)(Tensor&, size_t dim, const Tensor& index, const Tensor& src), 2> Scatter; // [1] accumulates
+        Tensor (*MaskedSelect)(const Tensor&, const Tensor& mask);
+        Tensor (*Matmul)(const Tensor&, const Tensor&);
+        void (*MatmulOut)(const Tensor&, const Tensor&, Tensor& out);
+        // Math::UnaryOp on a floating point DType, after adding bias when it is not null; out may be null
+        Tensor (*Unary)(const Tensor&, Math::UnaryOp op, const Tensor* bias, Tensor* out);
+        Tensor (*Reshape)(const Tensor&, const Dims& shape);
+        Tensor (*Clone)(const Tensor&);
+        void (*CopyFrom)(Tensor& dst, const Tensor& src);
+        double (*Item)(const Tensor&);
+        Tensor (*To)(const Tensor&, DType dtype);
+    };
+
+    /**
+     *  @brief Kernel table of dtype; throws for DType::UNKNOWN
+     * **/
+    const TensorKernels& KernelsFor(DType dtype);
+
+    //*
+    //@brief Runtime-typed tensor: shared storage plus NextMetadata, ops dispatched on the DType.
+    //
+    // Converts to and from NextTensor<T> without copying (both share the storage), so typed code can be
+    // used wherever the element type is known and Tensor everywhere it is only known at run time.
+    //*/
+    class Tensor {
+    private:
+        NextMetadata m_Metadata;
+        std::shared_ptr<StorageCell> m_Storage;
+
+        [[nodiscard]] const TensorKernels& Kernels() const { return KernelsFor(GetDType()); }
+
+        // DType an op on this tensor and other computes in (see PromoteTypes)
+        [[nodiscard]] DType PromotedDType(const Tensor& other) const {
+            return Next::PromoteTypes(GetDType(), other.GetDType());
+        }
+
+        // DType a math op computes in: FLOAT32 for an integer DType
+        static DType MathDType(DType dtype) { return IsFloatingDType(dtype) ? dtype : DType::FLOAT32; }
+
+        static constexpr size_t OpIndex(Simd::BinaryOp op) { return static_cast<size_t>(op); }
+
+        // Another handle on this tensor's storage cell with the given metadata
+        [[nodiscard]] Tensor MakeView(NextMetadata metadata) const {
+            Tensor view;
+            view.m_Metadata = std::move(metadata);
+            view.m_Storage = m_Storage;
+            return view;
+        }
+
+    public:
+        /**
+         *  @brief Undefined tensor (DType::UNKNOWN, no storage)
+         * **/
+        Tensor() : m_Metadata(Dims{}, DType::UNKNOWN) {}
+
+        /**
+         *  @brief Zero-filled contiguous tensor
+         * **/
+        Tensor(const Dims& shape, DType dtype) : Tensor(KernelsFor(dtype).Zeros(shape)) {}
+
+        /**
+         *  @brief Runtime-typed view of tensor: both handles reach the same elements
+         * **/
+        template<typename T>
+        Tensor(const NextTensor<T>& tensor)
+            : m_Metadata(tensor.Shape(), tensor.Strides(), tensor.GetDType(), tensor.Offset()),
+              m_Storage(tensor.m_Storage) {}
+
+        /**
+         *  @brief Copy: shares the elements of other until one of the two is written (see StorageCell)
+         * **/
+        Tensor(const Tensor& other) : m_Metadata(other.m_Metadata), m_Storage(StorageCell::Share(other.m_Storage)) {}
+
+        Tensor(Tensor&& other) noexcept = default;
+
+        Tensor& operator=(const Tensor& other) {
+            if (this != &other) {
+                m_Metadata = other.m_Metadata;
+                m_Storage = StorageCell::Share(other.m_Storage);
+            }
+            return *this;
+        }
+
+        Tensor& operator=(Tensor&& other) noexcept = default;
+
+        /**
+         *  @brief Typed view of the same storage; the DType must match T
+         * **/
+        template<typename T>
+        [[nodiscard]] NextTensor<T> As() const {
+            if (GetDType() != Next::TypeToDType<T>::value) {
+                throw std::runtime_error(std::string("Tensor holds ") + DTypeName(GetDType()) + ", requested " +
+                                         DTypeName(Next::TypeToDType<T>::value));
+            }
+            return NextTensor<T>{m_Storage, m_Metadata};
+        }
+
+        [[nodiscard]] bool Defined() const { return GetDType() != DType::UNKNOWN; }
+
+        [[nodiscard]] DType GetDType() const { return m_Metadata.GetDType(); }
+
+        [[nodiscard]] const Dims& Shape() const { return m_Metadata.Shape(); }
+
+        [[nodiscard]] const Dims& Strides() const { return m_Metadata.Strides(); }
+
+        [[nodiscard]] size_t Offset() const { return m_Metadata.Offset(); }
+
+        [[nodiscard]] size_t Size() const { return m_Metadata.Size(); }
+
+        [[nodiscard]] size_t Rank() const { return m_Metadata.Rank(); }
+
+        [[nodiscard]] bool IsContiguous() const { return m_Metadata.IsContiguous(); }
+
+        [[nodiscard]] size_t ElementSize() const { return Next::DTypeSize(GetDType()); }
+
+        /**
+         *  @brief Start of the storage (element Offset() is the first element of this tensor)
+         * **/
+        [[nodiscard]] void* RawData() const { return m_Storage ? m_Storage->Data.get() : nullptr; }
+
+        /**
+         *  @brief See NextTensor<T>::Version
+         * **/
+        [[nodiscard]] uint64_t Version() const {
+            return m_Storage ? m_Storage->ObserveVersion() : 0;
+        }
+
+        /**
+         *  @brief Value of a one-element tensor, converted to double
+         * **/
+        [[nodiscard]] double item() const {
+            if (Size() != 1) {
+                throw std::runtime_error("item() needs a tensor with exactly one element");
+            }
+            return Kernels().Item(*this);
+        }
+
+        void fill(double value) { Kernels().Fill(*this, value); }
+
+        void zeros() { fill(0.0); }
+
+        void ones() { fill(1.0); }
+
+        /**
+         *  @brief Contiguous copy converted to dtype; a view of this tensor (see alias) when it already has dtype
+         *
+         *  The view matters to the out= forms: a copy-on-write copy would make out = this clone its elements.
+         * **/
+        [[nodiscard]] Tensor to(DType dtype) const {
+            if (dtype == GetDType()) return alias();
+            return Kernels().To(*this, dtype);
+        }
+
+        //VIEW operations
+        [[nodiscard]] Tensor reshape(const Dims& shape) const { return Kernels().Reshape(*this, shape); }
+
+        /**
+         *  @brief View of all elements with this tensor's shape, see NextTensor<T>::alias
+         * **/
+        [[nodiscard]] Tensor alias() const { return MakeView(m_Metadata); }
+
+        [[nodiscard]] Tensor contiguous() const { return IsContiguous() ? alias() : clone(); }
+
+        [[nodiscard]] Tensor clone() const { return Kernels().Clone(*this); }
+
+        /**
+         *  @brief Copy src (broadcast to this shape, converted to this DType) into this tensor's elements
+         * **/
+        Tensor& copy_from(const Tensor& src) {
+            Kernels().CopyFrom(*this, src);
+            return *this;
+        }
+
+        // Views that only rewrite the metadata (see View and the NextTensor<T> methods of the same names), so
+        // they need no kernel of the DType
+        [[nodiscard]] Tensor transpose(size_t dim1, size_t dim2) const {
+            return MakeView(View::Transpose(m_Metadata, dim1, dim2));
+        }
+
+        [[nodiscard]] Tensor permute(const Dims& dims) const { return MakeView(View::Permute(m_Metadata, dims)); }
+
+        [[nodiscard]] Tensor slice(size_t dim, size_t start, size_t end, size_t step = 1) const {
+            return MakeView(View::Slice(m_Metadata, dim, start, end, step));
+        }
+
+        [[nodiscard]] Tensor narrow(size_t dim, size_t start, size_t length) const {
+            return slice(dim, start, start + length);
+        }
+
+        [[nodiscard]] Tensor expand(const Dims& shape) const { return MakeView(View::Expand(m_Metadata, shape)); }
+
+        [[nodiscard]] Tensor squeeze() const { return MakeView(View::Squeeze(m_Metadata)); }
+
+        [[nodiscard]] Tensor squeeze(size_t dim) const { return MakeView(View::Squeeze(m_Metadata, dim)); }
+
+        [[nodiscard]] Tensor unsqueeze(size_t dim) const { return MakeView(View::Unsqueeze(m_Metadata, dim)); }
+
+        [[nodiscard]] Tensor flatten(size_t startDim = 0, size_t endDim = SIZE_MAX) const {
+            return reshape(View::FlattenShape(Shape(), startDim, endDim));
+        }
+
+        [[nodiscard]] Tensor as_strided(const Dims& shape, const Dims& strides, size_t offset) const {
+            const size_t storageSize = m_Storage ? m_Storage->Bytes / ElementSize() : 0;
+            return MakeView(View::AsStrided(m_Metadata, shape, strides, offset, storageSize));
+        }
+
+        [[nodiscard]] Tensor as_strided(const Dims& shape, const Dims& strides) const {
+            return as_strided(shape, strides, Offset());
+        }
+
+        // Element-wise operations; operands of different DTypes compute in their common DType (see
+        // PromoteTypes), the narrower one converted as it is read, and a scalar takes the DType of the tensor
+        [[nodiscard]] Tensor add(const Tensor& other) const { return Binary(other, Simd::BinaryOp::ADD); }
+
+        [[nodiscard]] Tensor add(double scalar) const { return Scalar(scalar, Simd::BinaryOp::ADD, false); }
+
+        [[nodiscard]] Tensor sub(const Tensor& other) const { return Binary(other, Simd::BinaryOp::SUB); }
+
+        [[nodiscard]] Tensor sub(double scalar) const { return Scalar(scalar, Simd::BinaryOp::SUB, false); }
+
+        [[nodiscard]] Tensor rsub(double scalar) const { return Scalar(scalar, Simd::BinaryOp::SUB, true); }
+
+        [[nodiscard]] Tensor mult(const Tensor& other) const { return Binary(other, Simd::BinaryOp::MUL); }
+
+        [[nodiscard]] Tensor mult(double scalar) const { return Scalar(scalar, Simd::BinaryOp::MUL, false); }
+
+        [[nodiscard]] Tensor divide(const Tensor& other) const { return Binary(other, Simd::BinaryOp::DIV); }
+
+        [[nodiscard]] Tensor divide(double scalar) const { return Scalar(scalar, Simd::BinaryOp::DIV, false); }
+
+        [[nodiscard]] Tensor rdivide(double scalar) const { return Scalar(scalar, Simd::BinaryOp::DIV, true); }
+
+        // Output-parameter forms: out must already have the result shape and the promoted DType, the aliasing
+        // rule of NextTensor<T> applies
+        Tensor& add(const Tensor& other, Tensor& out) const { return BinaryOut(other, out, Simd::BinaryOp::ADD); }
+
+        Tensor& sub(const Tensor& other, Tensor& out) const { return BinaryOut(other, out, Simd::BinaryOp::SUB); }
+
+        Tensor& mult(const Tensor& other, Tensor& out) const { return BinaryOut(other, out, Simd::BinaryOp::MUL); }
+
+        Tensor& divide(const Tensor& other, Tensor& out) const { return BinaryOut(other, out, Simd::BinaryOp::DIV); }
+
+        Tensor& operator+=(const Tensor& other) { return BinaryInPlace(other, Simd::BinaryOp::ADD); }
+
+        Tensor& operator-=(const Tensor& other) { return BinaryInPlace(other, Simd::BinaryOp::SUB); }
+
+        Tensor& operator*=(const Tensor& other) { return BinaryInPlace(other, Simd::BinaryOp::MUL); }
+
+        Tensor& operator/=(const Tensor& other) { return BinaryInPlace(other, Simd::BinaryOp::DIV); }
+
+        // Reductions, see NextTensor<T>::sum
+        [[nodiscard]] Tensor sum(const Dims& axes = {}, bool keepdim = false) const {
+            return Kernels().Reduce[static_cast<size_t>(Reduce::Kind::SUM)](*this, axes, keepdim);
+        }
+
+        [[nodiscard]] Tensor mean(const Dims& axes = {}, bool keepdim = false) const {
+            return Kernels().Mean(*this, axes, keepdim);
+        }
+
+        [[nodiscard]] Tensor prod(const Dims& axes = {}, bool keepdim = false) const {
+            return Kernels().Reduce[static_cast<size_t>(Reduce::Kind::PROD)](*this, axes, keepdim);
+        }
+
+        [[nodiscard]] Tensor max(const Dims& axes = {}, bool keepdim = false) const {
+            return Kernels().Reduce[static_cast<size_t>(Reduce::Kind::MAX)](*this, axes, keepdim);
+        }
+
+        [[nodiscard]] Tensor min(const Dims& axes = {}, bool keepdim = false) const {
+            return Kernels().Reduce[static_cast<size_t>(Reduce::Kind::MIN)](*this, axes, keepdim);
+        }
+
+        [[nodiscard]] Tensor argmax(size_t axis, bool keepdim = false) const {
+            return Kernels().ArgReduce[1](*this, axis, keepdim);
+        }
+
+        [[nodiscard]] Tensor argmin(size_t axis, bool keepdim = false) const {
+            return Kernels().ArgReduce[0](*this, axis, keepdim);
+        }
+
+        // Indexing, see the NextTensor<T> methods of the same names; indices of any integer DType are converted
+        // to INT64, a mask of any DType to BOOL and a scatter source to this tensor's DType
+        [[nodiscard]] Tensor index_select(size_t dim, const Tensor& index) const {
+            return Kernels().IndexSelect(*this, dim, index.to(DType::INT64));
+        }
+
+        [[nodiscard]] Tensor gather(size_t dim, const Tensor& index) const {
+            return Kernels().Gather(*this, dim, index.to(DType::INT64));
+        }
+
+        Tensor& scatter(size_t dim, const Tensor& index, const Tensor& src) {
+            Kernels().Scatter[0](*this, dim, index.to(DType::INT64), src.to(GetDType()));
+            return *this;
+        }
+
+        Tensor& scatter_add(size_t dim, const Tensor& index, const Tensor& src) {
+            Kernels().Scatter[1](*this, dim, index.to(DType::INT64), src.to(GetDType()));
+            return *this;
+        }
+
+        [[nodiscard]] Tensor masked_select(const Tensor& mask) const {
+            return Kernels().MaskedSelect(*this, mask.to(DType::BOOL));
+        }
+
+        // Math and activations; integer tensors compute in FLOAT32
+        [[nodiscard]] Tensor exp() const { return Unary(Math::UnaryOp::EXP); }
+
+        [[nodiscard]] Tensor log() const { return Unary(Math::UnaryOp::LOG); }
+
+        [[nodiscard]] Tensor tanh() const { return Unary(Math::UnaryOp::TANH); }
+
+        [[nodiscard]] Tensor sigmoid() const { return Unary(Math::UnaryOp::SIGMOID); }
+
+        [[nodiscard]] Tensor gelu() const { return Unary(Math::UnaryOp::GELU); }
+
+        [[nodiscard]] Tensor relu() const { return Unary(Math::UnaryOp::RELU); }
+
+        Tensor& exp(Tensor& out) const { return UnaryOut(Math::UnaryOp::EXP, out); }
+
+        Tensor& log(Tensor& out) const { return UnaryOut(Math::UnaryOp::LOG, out); }
+
+        Tensor& tanh(Tensor& out) const { return UnaryOut(Math::UnaryOp::TANH, out); }
+
+        Tensor& sigmoid(Tensor& out) const { return UnaryOut(Math::UnaryOp::SIGMOID, out); }
+
+        Tensor& gelu(Tensor& out) const { return UnaryOut(Math::UnaryOp::GELU, out); }
+
+        Tensor& relu(Tensor& out) const { return UnaryOut(Math::UnaryOp::RELU, out); }
+
+        /**
+         *  @brief act(this + bias) in a single pass, see NextTensor<T>::bias_activation
+         * **/
+        [[nodiscard]] Tensor bias_activation(const Tensor& bias, Math::UnaryOp act) const {
+            return KernelsFor(MathDType(PromotedDType(bias))).Unary(*this, act, &bias, nullptr);
+        }
+
+        Tensor& bias_activation(const Tensor& bias, Math::UnaryOp act, Tensor& out) const {
+            const DType dtype = MathDType(PromotedDType(bias));
+            CheckOutDType(dtype, out);
+            KernelsFor(dtype).Unary(*this, act, &bias, &out);
+            return out;
+        }
+
+        // Linear algebra
+        [[nodiscard]] Tensor matmul(const Tensor& other) const {
+            return KernelsFor(PromotedDType(other)).Matmul(*this, other);
+        }
+
+        Tensor& matmul(const Tensor& other, Tensor& out) const {
+            const DType dtype = PromotedDType(other);
+            CheckOutDType(dtype, out);
+            KernelsFor(dtype).MatmulOut(*this, other, out);
+            return out;
+        }
+
+    private:
+        [[nodiscard]] Tensor Binary(const Tensor& other, Simd::BinaryOp op) const {
+            return KernelsFor(PromotedDType(other)).Binary[OpIndex(op)](*this, other);
+        }
+
+        [[nodiscard]] Tensor Scalar(double scalar, Simd::BinaryOp op, bool scalarFirst) const {
+            return Kernels().Scalar[OpIndex(op)](*this, scalar, scalarFirst);
+        }
+
+        [[nodiscard]] Tensor Unary(Math::UnaryOp op) const {
+            return KernelsFor(MathDType(GetDType())).Unary(*this, op, nullptr, nullptr);
+        }
+
+        Tensor& UnaryOut(Math::UnaryOp op, Tensor& out) const {
+            const DType dtype = MathDType(GetDType());
+            CheckOutDType(dtype, out);
+            KernelsFor(dtype).Unary(*this, op, nullptr, &out);
+            return out;
+        }
+
+        static void CheckOutDType(DType result, const Tensor& out) {
+            if (out.GetDType() != result) {
+                throw std::runtime_error(std::string("DType mismatch: cannot store ") + DTypeName(result) +
+                                         " into " + DTypeName(out.GetDType()));
+            }
+        }
+
+        Tensor& BinaryOut(const Tensor& other, Tensor& out, Simd::BinaryOp op) const {
+            const DType dtype = PromotedDType(other);
+            CheckOutDType(dtype, out);
+            KernelsFor(dtype).BinaryOut[OpIndex(op)](*this, other, out);
+            return out;
+        }
+
+        // The result is written into this tensor, so other may only promote to this tensor's DType
+        Tensor& BinaryInPlace(const Tensor& other, Simd::BinaryOp op) {
+            if (Next::PromoteTypes(GetDType(), other.GetDType()) != GetDType()) {
+                throw std::runtime_error(std::string("DType mismatch: cannot store ") + DTypeName(other.GetDType()) +
+                                         " into " + DTypeName(GetDType()) + " in place");
+            }
+            Kernels().BinaryInPlace[OpIndex(op)](*this, other);
+            return *this;
+        }
+    };
+
+    inline Tensor operator+(const Tensor& lhs, const Tensor& rhs) { return lhs.add(rhs); }
+
+    inline Tensor operator-(const Tensor& lhs, const Tensor& rhs) { return lhs.sub(rhs); }
+
+    inline Tensor operator*(const Tensor& lhs, const Tensor& rhs) { return lhs.mult(rhs); }
+
+    inline Tensor operator/(const Tensor& lhs, const Tensor& rhs) { return lhs.divide(rhs); }
+
+    inline Tensor operator+(const Tensor& lhs, double rhs) { return lhs.add(rhs); }
+
+    inline Tensor operator-(const Tensor& lhs, double rhs) { return lhs.sub(rhs); }
+
+    inline Tensor operator*(const Tensor& lhs, double rhs) { return lhs.mult(rhs); }
+
+    inline Tensor operator/(const Tensor& lhs, double rhs) { return lhs.divide(rhs); }
+
+    inline Tensor operator+(double lhs, const Tensor& rhs) { return rhs.add(lhs); }
+
+    inline Tensor operator-(double lhs, const Tensor& rhs) { return rhs.rsub(lhs); }
+
+    inline Tensor operator*(double lhs, const Tensor& rhs) { return rhs.mult(lhs); }
+
+    inline Tensor operator/(double lhs, const Tensor& rhs) { return rhs.rdivide(lhs); }
+}
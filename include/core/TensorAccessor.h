@@ -0,0 +1,106 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Element access checks: 0 none, 1 rank and bounds of operator() and TensorAccessor, 2 also rejects
+// writable access to views that repeat elements (stride 0, e.g. expand). at() and operator[] always check.
+// Defaults to 1 in debug builds and 0 under NDEBUG; the CMake cache variable of the same name overrides it.
+#ifndef NEXT_TENSOR_CHECKS
+#ifdef NDEBUG
+#define NEXT_TENSOR_CHECKS 0
+#else
+#define NEXT_TENSOR_CHECKS 1
+#endif
+#endif
+
+namespace Next {
+    namespace Detail {
+        // Separate functions so a checked access inlines to a compare and a branch; the message is built on failure
+        [[noreturn]] inline void ThrowIndexOutOfRange(size_t index, size_t dim, size_t size) {
+            throw std::out_of_range("Index error: index " + std::to_string(index) + " is out of range for dimension " +
+                                    std::to_string(dim) + " of size " + std::to_string(size));
+        }
+
+        [[noreturn]] inline void ThrowRankMismatch(size_t rank, size_t count) {
+            throw std::invalid_argument("Index error: tensor of rank " + std::to_string(rank) + " indexed with " +
+                                        std::to_string(count) + " indices");
+        }
+    }
+
+    //*
+    //@brief Unchecked view of a tensor's elements with the rank fixed at compile time, for inner loops.
+    //
+    // Holds the address of element (0, ..., 0) and the shape and strides by value, so an access is the sum of
+    // index * stride products and nothing else: no copy-on-write bookkeeping, no offset, no loop over a
+    // runtime rank. Bounds are checked only when NEXT_TENSOR_CHECKS >= 1. Obtain one from
+    // NextTensor::accessor<Rank>(); it does not keep the elements alive.
+    //
+    //   auto w = weights.accessor<2>();
+    //   for (size_t i = 0; i < w.Size(0); i++)
+    //       for (size_t j = 0; j < w.Size(1); j++) w(i, j) *= scale;
+    //*/
+    template<typename T, size_t Rank>
+    class TensorAccessor {
+        static_assert(Rank > 0, "A tensor accessor needs at least one dimension");
+
+    private:
+        T* m_Data;
+        std::array<size_t, Rank> m_Shape;
+        std::array<size_t, Rank> m_Strides;
+
+        void CheckIndex(size_t index, size_t dim) const {
+            if constexpr (NEXT_TENSOR_CHECKS >= 1) {
+                if (index >= m_Shape[dim]) Detail::ThrowIndexOutOfRange(index, dim, m_Shape[dim]);
+            }
+        }
+
+    public:
+        /**
+         *  @brief Rank elements of shape and strides are read; data points at element (0, ..., 0)
+         * **/
+        TensorAccessor(T* data, const size_t* shape, const size_t* strides) : m_Data(data) {
+            for (size_t d = 0; d < Rank; d++) {
+                m_Shape[d] = shape[d];
+                m_Strides[d] = strides[d];
+            }
+        }
+
+        template<typename... Idx>
+        T& operator()(Idx... idx) const {
+            static_assert(sizeof...(Idx) == Rank, "Accessor indexed with the wrong number of indices");
+            static_assert((std::is_convertible_v<Idx, size_t> && ...), "All Indices must be convertible to size_t");
+            const std::array<size_t, Rank> indices{static_cast<size_t>(idx)...};
+            size_t offset = 0;
+            for (size_t d = 0; d < Rank; d++) {
+                CheckIndex(indices[d], d);
+                offset += indices[d] * m_Strides[d];
+            }
+            return m_Data[offset];
+        }
+
+        /**
+         *  @brief Element i of a rank-1 accessor, otherwise the accessor of rank Rank - 1 at index i
+         * **/
+        decltype(auto) operator[](size_t i) const {
+            CheckIndex(i, 0);
+            if constexpr (Rank == 1) {
+                return static_cast<T&>(m_Data[i * m_Strides[0]]);
+            } else {
+                return TensorAccessor<T, Rank - 1>{m_Data + i * m_Strides[0], m_Shape.data() + 1, m_Strides.data() + 1};
+            }
+        }
+
+        [[nodiscard]] size_t Size(size_t dim) const { return m_Shape[dim]; }
+
+        [[nodiscard]] size_t Stride(size_t dim) const { return m_Strides[dim]; }
+
+        [[nodiscard]] T* Data() const { return m_Data; }
+    };
+}
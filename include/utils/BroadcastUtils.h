@@ -3,7 +3,79 @@
 //
 
 #pragma once
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#include "SmallVector.h"
 
 namespace Next {
+    /**
+     *  @brief Readable form of a shape for error messages, e.g. "(2, 3, 4)"
+     * **/
+    [[nodiscard]] inline std::string ShapeToString(const Dims& shape) {
+        std::string result = "(";
+        for (size_t i = 0; i < shape.size(); i++) {
+            if (i > 0) result += ", ";
+            result += std::to_string(shape[i]);
+        }
+        return result + ")";
+    }
+
+    /**
+     *  @brief NumPy rule: shapes are aligned from the last dimension and each pair must match or contain a 1
+     * **/
+    [[nodiscard]] inline bool IsBroadcastable(const Dims& lhs, const Dims& rhs) {
+        const size_t rank = std::max(lhs.size(), rhs.size());
+        for (size_t i = 0; i < rank; i++) {
+            const size_t a = i < lhs.size() ? lhs[lhs.size() - 1 - i] : 1;
+            const size_t b = i < rhs.size() ? rhs[rhs.size() - 1 - i] : 1;
+            if (a != b && a != 1 && b != 1) return false;
+        }
+        return true;
+    }
+
+    /**
+     *  @brief Result shape of broadcasting lhs against rhs
+     * **/
+    [[nodiscard]] inline Dims BroadcastShapes(const Dims& lhs, const Dims& rhs) {
+        if (!IsBroadcastable(lhs, rhs)) {
+            throw std::runtime_error("Broadcast error: shapes " + ShapeToString(lhs) + " and " +
+                                     ShapeToString(rhs) + " are not compatible");
+        }
+        const size_t rank = std::max(lhs.size(), rhs.size());
+        Dims result(rank);
+        for (size_t i = 0; i < rank; i++) {
+            const size_t a = i < lhs.size() ? lhs[lhs.size() - 1 - i] : 1;
+            const size_t b = i < rhs.size() ? rhs[rhs.size() - 1 - i] : 1;
+            result[rank - 1 - i] = a == 1 ? b : a;
+        }
+        return result;
+    }
 
-}
\ No newline at end of file
+    /**
+     *  @brief Strides that view a tensor of the given shape as the target shape without copying
+     *
+     *  Broadcast dimensions (missing leading ones and size-1 ones) get a stride of zero.
+     * **/
+    [[nodiscard]] inline Dims BroadcastStrides(const Dims& shape,
+                                                              const Dims& strides,
+                                                              const Dims& target) {
+        if (shape.size() > target.size()) {
+            throw std::runtime_error("Broadcast error: cannot broadcast shape " + ShapeToString(shape) +
+                                     " to lower rank shape " + ShapeToString(target));
+        }
+        Dims result(target.size(), 0);
+        const size_t lead = target.size() - shape.size();
+        for (size_t i = 0; i < shape.size(); i++) {
+            if (shape[i] == target[lead + i]) {
+                result[lead + i] = strides[i];
+            } else if (shape[i] != 1) {
+                throw std::runtime_error("Broadcast error: cannot broadcast shape " + ShapeToString(shape) +
+                                         " to " + ShapeToString(target));
+            }
+        }
+        return result;
+    }
+}
@@ -12,6 +12,9 @@ namespace Next {
         INT32,
         INT64,
         UINT8,
-        BOOL
+        BOOL,
+        FLOAT16,    // Appended: tensor files store the numeric value, so existing entries never move
+        BFLOAT16,
+        INT8
     };
 }
\ No newline at end of file
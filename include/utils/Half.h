@@ -0,0 +1,321 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "SimdKernels.h"
+
+namespace Next {
+    enum class FloatFormat {
+        FP16,   // IEEE 754 binary16: 1 sign, 5 exponent, 10 mantissa bits
+        BF16    // bfloat16: the upper half of a float32, 8 exponent and 7 mantissa bits
+    };
+
+    namespace Detail {
+        inline float HalfBitsToFloat(uint16_t h) {
+            const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+            const uint32_t exponent = (h >> 10) & 0x1F;
+            uint32_t mantissa = h & 0x3FF;
+            if (exponent == 0x1F) {
+                return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));     // Inf / NaN
+            }
+            if (exponent != 0) {
+                return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+            }
+            if (mantissa == 0) {
+                return std::bit_cast<float>(sign);
+            }
+            // Subnormal: mantissa * 2^-24
+            const float magnitude = static_cast<float>(mantissa) * 0x1p-24f;
+            return sign ? -magnitude : magnitude;
+        }
+
+        inline uint16_t FloatToHalfBits(float value) {
+            const uint32_t bits = std::bit_cast<uint32_t>(value);
+            const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+            const uint32_t magnitude = bits & 0x7FFFFFFF;
+            if (magnitude > 0x7F800000) {
+                return static_cast<uint16_t>(sign | 0x7E00 | ((magnitude >> 13) & 0x3FF));     // Quiet NaN
+            }
+            if (magnitude >= 0x477FF000) {
+                return static_cast<uint16_t>(sign | 0x7C00);    // Rounds past 65504 (or is Inf)
+            }
+            if (magnitude < 0x38800000) {
+                // Subnormal or zero: round magnitude / 2^-24 to nearest even
+                const float scaled = std::bit_cast<float>(magnitude) * 0x1p24f;
+                const auto truncated = static_cast<uint32_t>(scaled);
+                const float rest = scaled - static_cast<float>(truncated);
+                const uint32_t rounded = truncated + (rest > 0.5f || (rest == 0.5f && (truncated & 1)));
+                return static_cast<uint16_t>(sign | rounded);
+            }
+            // Normal: rebias the exponent and round the dropped 13 bits to nearest even
+            const uint32_t rebased = magnitude - (112u << 23);
+            const uint32_t rounded = rebased + 0xFFF + ((rebased >> 13) & 1);
+            return static_cast<uint16_t>(sign | (rounded >> 13));
+        }
+
+        inline float BFloat16BitsToFloat(uint16_t b) {
+            return std::bit_cast<float>(static_cast<uint32_t>(b) << 16);
+        }
+
+        inline uint16_t FloatToBFloat16Bits(float value) {
+            const uint32_t bits = std::bit_cast<uint32_t>(value);
+            if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+                return static_cast<uint16_t>((bits >> 16) | 0x0040);    // Keep NaNs quiet after truncation
+            }
+            return static_cast<uint16_t>((bits + 0x7FFF + ((bits >> 16) & 1)) >> 16);
+        }
+    }
+
+    //*
+    //@brief 16-bit floating point storage type; arithmetic is carried out in float and rounded back.
+    //
+    // Converts implicitly from any arithmetic type (rounding to nearest even) and explicitly to them, so
+    // generic tensor code can write T{0}, static_cast<T>(x) and a + b for it like for built-in types.
+    //*/
+    template<FloatFormat F>
+    class ReducedFloat {
+    private:
+        uint16_t m_Bits{0};
+
+    public:
+        constexpr ReducedFloat() = default;
+
+        template<typename A> requires std::is_arithmetic_v<A>
+        ReducedFloat(A value) {
+            const auto f = static_cast<float>(value);
+            if constexpr (F == FloatFormat::FP16) m_Bits = Detail::FloatToHalfBits(f);
+            else m_Bits = Detail::FloatToBFloat16Bits(f);
+        }
+
+        template<FloatFormat G> requires (G != F)
+        explicit ReducedFloat(ReducedFloat<G> other) : ReducedFloat(static_cast<float>(other)) {}
+
+        static constexpr ReducedFloat FromBits(uint16_t bits) {
+            ReducedFloat value;
+            value.m_Bits = bits;
+            return value;
+        }
+
+        [[nodiscard]] constexpr uint16_t Bits() const { return m_Bits; }
+
+        template<typename A> requires std::is_arithmetic_v<A>
+        explicit operator A() const {
+            if constexpr (F == FloatFormat::FP16) return static_cast<A>(Detail::HalfBitsToFloat(m_Bits));
+            else return static_cast<A>(Detail::BFloat16BitsToFloat(m_Bits));
+        }
+
+        friend ReducedFloat operator+(ReducedFloat a, ReducedFloat b) { return float(a) + float(b); }
+
+        friend ReducedFloat operator-(ReducedFloat a, ReducedFloat b) { return float(a) - float(b); }
+
+        friend ReducedFloat operator*(ReducedFloat a, ReducedFloat b) { return float(a) * float(b); }
+
+        friend ReducedFloat operator/(ReducedFloat a, ReducedFloat b) { return float(a) / float(b); }
+
+        friend constexpr ReducedFloat operator-(ReducedFloat a) { return FromBits(static_cast<uint16_t>(a.m_Bits ^ 0x8000)); }
+
+        ReducedFloat& operator+=(ReducedFloat other) { return *this = *this + other; }
+
+        ReducedFloat& operator-=(ReducedFloat other) { return *this = *this - other; }
+
+        ReducedFloat& operator*=(ReducedFloat other) { return *this = *this * other; }
+
+        ReducedFloat& operator/=(ReducedFloat other) { return *this = *this / other; }
+
+        friend bool operator==(ReducedFloat a, ReducedFloat b) { return float(a) == float(b); }
+
+        friend std::partial_ordering operator<=>(ReducedFloat a, ReducedFloat b) { return float(a) <=> float(b); }
+    };
+
+    using Half = ReducedFloat<FloatFormat::FP16>;
+    using BFloat16 = ReducedFloat<FloatFormat::BF16>;
+
+    template<typename T>
+    inline constexpr bool IsReducedFloat = std::is_same_v<T, Half> || std::is_same_v<T, BFloat16>;
+}
+
+template<Next::FloatFormat F>
+struct std::numeric_limits<Next::ReducedFloat<F>> {
+private:
+    using Type = Next::ReducedFloat<F>;
+    static constexpr bool IsHalf = F == Next::FloatFormat::FP16;
+
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr int digits = IsHalf ? 11 : 8;
+    static constexpr int radix = 2;
+
+    static constexpr Type min() noexcept { return Type::FromBits(IsHalf ? 0x0400 : 0x0080); }
+    static constexpr Type max() noexcept { return Type::FromBits(IsHalf ? 0x7BFF : 0x7F7F); }
+    static constexpr Type lowest() noexcept { return Type::FromBits(IsHalf ? 0xFBFF : 0xFF7F); }
+    static constexpr Type epsilon() noexcept { return Type::FromBits(IsHalf ? 0x1400 : 0x3C00); }
+    static constexpr Type infinity() noexcept { return Type::FromBits(IsHalf ? 0x7C00 : 0x7F80); }
+    static constexpr Type quiet_NaN() noexcept { return Type::FromBits(IsHalf ? 0x7E00 : 0x7FC0); }
+};
+
+namespace Next::Simd {
+    // Bulk conversions between the 16-bit float formats and float. Half uses the F16C / AVX-512 convert
+    // instructions, bfloat16 is a 16-bit shift with round-to-nearest-even done in integer lanes.
+
+#if NEXT_SIMD_X86
+    namespace Avx2 {
+        __attribute__((target("avx2,f16c")))
+        inline void HalfToFloat(const uint16_t* src, float* dst, size_t n) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+            }
+            for (; i < n; i++) dst[i] = Next::Detail::HalfBitsToFloat(src[i]);
+        }
+
+        __attribute__((target("avx2,f16c")))
+        inline void FloatToHalf(const float* src, uint16_t* dst, size_t n) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+            }
+            for (; i < n; i++) dst[i] = Next::Detail::FloatToHalfBits(src[i]);
+        }
+
+        __attribute__((target("avx2")))
+        inline void BFloat16ToFloat(const uint16_t* src, float* dst, size_t n) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                const __m256i widened = _mm256_slli_epi32(_mm256_cvtepu16_epi32(b), 16);
+                _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(widened));
+            }
+            for (; i < n; i++) dst[i] = Next::Detail::BFloat16BitsToFloat(src[i]);
+        }
+
+        __attribute__((target("avx2")))
+        inline void FloatToBFloat16(const float* src, uint16_t* dst, size_t n) {
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i bias = _mm256_set1_epi32(0x7FFF);
+            const __m256i quiet = _mm256_set1_epi32(0x00400000);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m256 x = _mm256_loadu_ps(src + i);
+                const __m256i bits = _mm256_castps_si256(x);
+                const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16), one);
+                const __m256i rounded = _mm256_add_epi32(bits, _mm256_add_epi32(bias, lsb));
+                const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+                const __m256i selected = _mm256_blendv_epi8(rounded, _mm256_or_si256(bits, quiet), nan);
+                const __m256i shifted = _mm256_srli_epi32(selected, 16);
+                // packus works per 128-bit lane; gather both halves into the low lane afterwards
+                const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(shifted, shifted), 0xD8);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(packed));
+            }
+            for (; i < n; i++) dst[i] = Next::Detail::FloatToBFloat16Bits(src[i]);
+        }
+    }
+
+    namespace Avx512 {
+        __attribute__((target("avx512f")))
+        inline void HalfToFloat(const uint16_t* src, float* dst, size_t n) {
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                const __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(h));
+            }
+            Avx2::HalfToFloat(src + i, dst + i, n - i);
+        }
+
+        __attribute__((target("avx512f")))
+        inline void FloatToHalf(const float* src, uint16_t* dst, size_t n) {
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                const __m256i h = _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), h);
+            }
+            Avx2::FloatToHalf(src + i, dst + i, n - i);
+        }
+    }
+
+    namespace Detail {
+        inline bool HasF16C() {
+            static const bool supported = __builtin_cpu_supports("f16c");
+            return supported;
+        }
+    }
+#endif
+
+    /**
+     *  @brief dst[i] = float(src[i]) for a contiguous row of Half / BFloat16
+     * **/
+    template<typename R>
+    void ToFloat(const R* src, float* dst, size_t n) {
+        static_assert(IsReducedFloat<R>);
+        const auto* bits = reinterpret_cast<const uint16_t*>(src);
+#if NEXT_SIMD_X86
+        if constexpr (std::is_same_v<R, Half>) {
+            if (GetISA() >= ISA::AVX512) return Avx512::HalfToFloat(bits, dst, n);
+            if (GetISA() >= ISA::AVX2 && Detail::HasF16C()) return Avx2::HalfToFloat(bits, dst, n);
+        } else {
+            if (GetISA() >= ISA::AVX2) return Avx2::BFloat16ToFloat(bits, dst, n);
+        }
+#endif
+        for (size_t i = 0; i < n; i++) dst[i] = static_cast<float>(src[i]);
+    }
+
+    /**
+     *  @brief dst[i] = R(src[i]) for a contiguous row, rounding to nearest even
+     * **/
+    template<typename R>
+    void FromFloat(const float* src, R* dst, size_t n) {
+        static_assert(IsReducedFloat<R>);
+        auto* bits = reinterpret_cast<uint16_t*>(dst);
+#if NEXT_SIMD_X86
+        if constexpr (std::is_same_v<R, Half>) {
+            if (GetISA() >= ISA::AVX512) return Avx512::FloatToHalf(src, bits, n);
+            if (GetISA() >= ISA::AVX2 && Detail::HasF16C()) return Avx2::FloatToHalf(src, bits, n);
+        } else {
+            if (GetISA() >= ISA::AVX2) return Avx2::FloatToBFloat16(src, bits, n);
+        }
+#endif
+        for (size_t i = 0; i < n; i++) dst[i] = R(src[i]);
+    }
+
+    /**
+     *  @brief dst[i * dstStep] = Dst(src[i * srcStep]); contiguous rows from or to a 16-bit float go through
+     *  the vector conversions (via a float block when the other side is not float)
+     * **/
+    template<typename Src, typename Dst>
+    void ConvertRow(const Src* src, size_t srcStep, Dst* dst, size_t dstStep, size_t n) {
+        if constexpr (IsReducedFloat<Src> || IsReducedFloat<Dst>) {
+            if (srcStep == 1 && dstStep == 1) {
+                if constexpr (IsReducedFloat<Src> && std::is_same_v<Dst, float>) return ToFloat(src, dst, n);
+                else if constexpr (std::is_same_v<Src, float> && IsReducedFloat<Dst>) return FromFloat(src, dst, n);
+                else if constexpr (!std::is_same_v<Src, Dst>) {
+                    constexpr size_t Block = 256;
+                    float buffer[Block];
+                    for (size_t i = 0; i < n; i += Block) {
+                        const size_t m = std::min(Block, n - i);
+                        ConvertRow(src + i, 1, buffer, 1, m);
+                        ConvertRow(buffer, 1, dst + i, 1, m);
+                    }
+                    return;
+                }
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            dst[i * dstStep] = static_cast<Dst>(src[i * srcStep]);
+        }
+    }
+}
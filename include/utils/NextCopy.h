@@ -0,0 +1,164 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "NextProfile.h"
+#include "NextUtils.h"
+#include "SimdKernels.h"
+#include "StridedIterator.h"
+#include "ThreadPool.h"
+
+namespace Next::Copy {
+    // Square tile of the blocked transpose: two 32 x 32 tiles of 8-byte elements are 16 KB and stay in L1
+    inline constexpr size_t TransposeBlock = 32;
+    inline constexpr size_t TransposePanel = 4 * TransposeBlock;
+
+    /**
+     *  @brief dst[j * ldd + i] = src[i * lds + j] for i < rows, j < cols (both sides unit stride inside a row)
+     * **/
+    template<typename T>
+    void TransposeTileGeneric(const T* src, size_t lds, T* dst, size_t ldd, size_t rows, size_t cols) {
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                dst[j * ldd + i] = src[i * lds + j];
+            }
+        }
+    }
+
+#if NEXT_SIMD_X86
+    // 8 x 8 block of 4-byte elements in registers: unpack pairs, shuffle quads, then swap 128-bit lanes.
+    // Only moves bits, so it serves float, int32 and uint32 alike
+    __attribute__((target("avx")))
+    inline void Transpose8x8(const void* srcPtr, size_t lds, void* dstPtr, size_t ldd) {
+        const auto* src = static_cast<const float*>(srcPtr);
+        auto* dst = static_cast<float*>(dstPtr);
+        __m256 r[8], t[8];
+        for (size_t i = 0; i < 8; i++) {
+            r[i] = _mm256_loadu_ps(src + i * lds);
+        }
+        for (size_t i = 0; i < 8; i += 2) {
+            t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+        }
+        for (size_t i = 0; i < 8; i += 4) {
+            r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+        for (size_t i = 0; i < 4; i++) {
+            _mm256_storeu_ps(dst + i * ldd, _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+            _mm256_storeu_ps(dst + (i + 4) * ldd, _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+        }
+    }
+
+    template<typename T>
+    __attribute__((target("avx")))
+    void TransposeTileAvx(const T* src, size_t lds, T* dst, size_t ldd, size_t rows, size_t cols) {
+        const size_t rows8 = rows / 8 * 8, cols8 = cols / 8 * 8;
+        for (size_t i = 0; i < rows8; i += 8) {
+            for (size_t j = 0; j < cols8; j += 8) {
+                Transpose8x8(src + i * lds + j, lds, dst + j * ldd + i, ldd);
+            }
+        }
+        TransposeTileGeneric(src + cols8, lds, dst + cols8 * ldd, ldd, rows, cols - cols8);
+        TransposeTileGeneric(src + rows8 * lds, lds, dst + rows8, ldd, rows - rows8, cols8);
+    }
+#endif
+
+    /**
+     *  @brief Blocked transpose of a rows x cols matrix: dst[j * ldd + i] = src[i * lds + j]
+     *
+     *  Tiles are walked so that both the reads and the writes of one tile stay inside a few cache lines per
+     *  row, instead of the naive loop striding through a whole column of one side per element.
+     * **/
+    template<typename T>
+    void Transpose2D(const T* src, size_t lds, T* dst, size_t ldd, size_t rows, size_t cols,
+                     size_t begin = 0, size_t end = SIZE_MAX) {
+        end = std::min(end, (rows + TransposeBlock - 1) / TransposeBlock);
+        auto tile = &TransposeTileGeneric<T>;
+#if NEXT_SIMD_X86
+        if constexpr (sizeof(T) == 4 && std::is_trivially_copyable_v<T>) {
+            if (Simd::GetISA() >= Simd::ISA::AVX2) tile = &TransposeTileAvx<T>;
+        }
+#endif
+        // Columns go in panels of TransposePanel, so a sweep down the rows writes to few destination pages
+        for (size_t jc = 0; jc < cols; jc += TransposePanel) {
+            const size_t jEnd = std::min(cols, jc + TransposePanel);
+            for (size_t ib = begin * TransposeBlock; ib < end * TransposeBlock; ib += TransposeBlock) {
+                const size_t rb = std::min(TransposeBlock, rows - ib);
+                for (size_t jb = jc; jb < jEnd; jb += TransposeBlock) {
+                    tile(src + ib * lds + jb, lds, dst + jb * ldd + ib, ldd, rb, std::min(TransposeBlock, jEnd - jb));
+                }
+            }
+        }
+    }
+
+    /**
+     *  @brief Copy the elements of a strided view into another view of the same shape
+     *
+     *  Rows that are contiguous on both sides are plain block copies. When the destination's unit-stride
+     *  dimension is a different one than the source's (a transposed or permuted layout), the two dimensions
+     *  are copied as a blocked 2-D transpose per remaining index instead of gathering one element at a time
+     *  with a large stride. Everything else is a strided row loop.
+     * **/
+    template<typename T>
+    void CopyStrided(const Dims& shape, T* dst, const Dims& dstStrides, size_t dstOffset,
+                     const T* src, const Dims& srcStrides, size_t srcOffset) {
+        if (Next::ComputeSize(shape) == 0) return;
+
+        // Unit-stride dimension of each side, if any
+        size_t p = shape.size(), q = shape.size();
+        for (size_t d = 0; d < shape.size(); d++) {
+            if (shape[d] < 2) continue;
+            if (srcStrides[d] == 1) p = d;
+            if (dstStrides[d] == 1) q = d;
+        }
+
+        if (p == shape.size() || q == shape.size() || p == q ||
+            shape[p] < TransposeBlock / 4 || shape[q] < TransposeBlock / 4) {
+            Next::ParallelForEachStrided<2>(shape, {&dstStrides, &srcStrides}, {dstOffset, srcOffset},
+                [&](const std::array<size_t, 2>& offsets, const std::array<size_t, 2>& steps, size_t count) {
+                    T* out = dst + offsets[0];
+                    const T* in = src + offsets[1];
+                    if (steps[0] == 1 && steps[1] == 1) {
+                        std::copy(in, in + count, out);
+                    } else {
+                        for (size_t i = 0; i < count; i++, out += steps[0], in += steps[1]) {
+                            *out = *in;
+                        }
+                    }
+                });
+            return;
+        }
+
+        // Source rows run along p, destination rows along q: one 2-D transpose for every other index
+        const size_t rows = shape[q], cols = shape[p];
+        const size_t lds = srcStrides[q], ldd = dstStrides[p];
+        auto batch = shape;
+        batch[p] = 1;
+        batch[q] = 1;
+        const size_t rowBlocks = (rows + TransposeBlock - 1) / TransposeBlock;
+        NEXT_PROFILE_WALK(Next::ComputeSize(batch) * rows, true);
+        if (Next::ComputeSize(batch) == 1) {
+            const size_t grain = std::max<size_t>(1, DefaultGrainSize / (TransposeBlock * cols));
+            Next::ParallelFor(0, rowBlocks, grain, [&](size_t begin, size_t end) {
+                Transpose2D(src + srcOffset, lds, dst + dstOffset, ldd, rows, cols, begin, end);
+            });
+            return;
+        }
+        Next::ParallelForEachStrided<2>(batch, {&dstStrides, &srcStrides}, {dstOffset, srcOffset},
+            [&](const std::array<size_t, 2>& offsets, const std::array<size_t, 2>& steps, size_t count) {
+                for (size_t i = 0; i < count; i++) {
+                    Transpose2D(src + offsets[1] + i * steps[1], lds, dst + offsets[0] + i * steps[0], ldd, rows, cols);
+                }
+            }, std::max<size_t>(1, DefaultGrainSize / (rows * cols)));
+    }
+}
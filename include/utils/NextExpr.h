@@ -0,0 +1,376 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "BroadcastUtils.h"
+#include "NextProfile.h"
+#include "SimdKernels.h"
+#include "StridedIterator.h"
+
+namespace Next {
+    template<typename T>
+    class NextTensor;
+
+    template<typename E>
+    concept TensorExpression = requires { typename std::remove_cvref_t<E>::IsTensorExpression; };
+
+    template<typename X>
+    struct IsNextTensor : std::false_type {};
+
+    template<typename T>
+    struct IsNextTensor<NextTensor<T>> : std::true_type {};
+
+    // Expression nodes are built by the operators in NextOps.h and evaluated in a single strided pass when
+    // they are assigned to a NextTensor. Every tensor leaf becomes one operand of the strided iterator; leaf
+    // I of an expression reads through ptrs[I] / steps[I], so the whole tree compiles down to one loop body.
+    // Leaves hold a view of their tensor (see NextTensor::alias), an unevaluated expression therefore sees
+    // later writes to its inputs.
+
+    /**
+     *  @brief Leaf reading a tensor, broadcast to the shape of the enclosing expression
+     * **/
+    template<typename T>
+    class TensorLeaf {
+    private:
+        NextTensor<T> m_Tensor;
+
+    public:
+        using IsTensorExpression = void;
+        using ValueType = T;
+        static constexpr size_t Leaves = 1;
+
+        explicit TensorLeaf(const NextTensor<T>& tensor) : m_Tensor(tensor.alias()) {}
+
+        // Copies of a node stay views as well (a tensor copy would allocate a storage cell)
+        TensorLeaf(const TensorLeaf& other) : m_Tensor(other.m_Tensor.alias()) {}
+
+        TensorLeaf(TensorLeaf&& other) noexcept = default;
+
+        [[nodiscard]] const Dims& Shape() const { return m_Tensor.Shape(); }
+
+        template<size_t I, size_t N>
+        void Bind(const Dims& shape, std::array<const T*, N>& data,
+                  std::array<Dims, N>& strides, std::array<size_t, N>& offsets) const {
+            data[I] = m_Tensor.Data();
+            strides[I] = Next::BroadcastStrides(m_Tensor.Shape(), m_Tensor.Strides(), shape);
+            offsets[I] = m_Tensor.Offset();
+        }
+
+        template<size_t I, bool Contiguous, size_t N>
+        T Eval(const std::array<const T*, N>& ptrs, const std::array<size_t, N>& steps, size_t i,
+               unsigned&) const {
+            if constexpr (Contiguous) return ptrs[I][i];
+            else return ptrs[I][i * steps[I]];
+        }
+    };
+
+    /**
+     *  @brief Leaf holding a scalar; it takes no iterator operand
+     * **/
+    template<typename T>
+    class ScalarLeaf {
+    private:
+        T m_Value;
+
+    public:
+        using IsTensorExpression = void;
+        using ValueType = T;
+        static constexpr size_t Leaves = 0;
+
+        explicit ScalarLeaf(const T& value) : m_Value(value) {}
+
+        [[nodiscard]] const Dims& Shape() const {
+            static const Dims scalarShape;
+            return scalarShape;
+        }
+
+        [[nodiscard]] const T& Value() const { return m_Value; }
+
+        template<size_t I, size_t N>
+        void Bind(const Dims&, std::array<const T*, N>&,
+                  std::array<Dims, N>&, std::array<size_t, N>&) const {}
+
+        template<size_t I, bool Contiguous, size_t N>
+        T Eval(const std::array<const T*, N>&, const std::array<size_t, N>&, size_t, unsigned&) const {
+            return m_Value;
+        }
+    };
+
+    /**
+     *  @brief Division with the eager divide() semantics: IEEE 754 for floating point, an error for an
+     *  integer zero divisor
+     *
+     *  The divisor of a fused expression may itself be computed, so it cannot be scanned up front like
+     *  divide() does. Instead a zero is ored into the row's zeros count (the quotient divides by one), and
+     *  Evaluate throws at the end of the row; the loop body has no branch and no throw.
+     * **/
+    struct CheckedDivide {
+        template<typename T>
+        T operator()(const T& a, const T& b, unsigned& zeros) const {
+            if constexpr (std::numeric_limits<T>::is_integer) {
+                const bool zero = b == 0;
+                zeros |= zero;
+                if constexpr (sizeof(T) <= 4 && !std::is_same_v<T, bool>) {
+                    // Through double like the int32 vector kernel, exact for 32-bit operands and the loop
+                    // vectorizes. Divisors 0 and -1 become 1 by arithmetic rather than a select, which the
+                    // vectorizer rejects; -1 then negates with wrap-around, so min / -1 stays min as in
+                    // ScalarApply and the conversion back never overflows
+                    using U = std::make_unsigned_t<T>;
+                    const bool negate = std::is_signed_v<T> & (b == T(-1));
+                    const T divisor = static_cast<T>(b + T(zero) + T(2 * negate));
+                    const T q = static_cast<T>(static_cast<double>(a) / static_cast<double>(divisor));
+                    return negate ? static_cast<T>(U(0) - static_cast<U>(q)) : q;
+                } else {
+                    return Simd::ScalarApply<Simd::BinaryOp::DIV>(a, zero ? T(1) : b);
+                }
+            } else {
+                return a / b;
+            }
+        }
+    };
+
+    /**
+     *  @brief Element-wise node combining two sub-expressions with Op
+     * **/
+    template<typename Op, typename L, typename R>
+    class BinaryExpr {
+    private:
+        L m_Lhs;
+        R m_Rhs;
+        Dims m_Shape;
+        Op m_Op;
+
+    public:
+        using IsTensorExpression = void;
+        using ValueType = typename L::ValueType;
+        static constexpr size_t Leaves = L::Leaves + R::Leaves;
+
+        static_assert(std::is_same_v<ValueType, typename R::ValueType>,
+                      "Both sides of a tensor expression must have the same element type");
+
+        /**
+         *  @brief Children are constructed in place from the operands: a tensor becomes its leaf, a scalar its
+         *  ScalarLeaf, a temporary sub-expression is moved in
+         * **/
+        template<typename A, typename B>
+        BinaryExpr(A&& lhs, B&& rhs, Op op = Op{})
+            : m_Lhs(std::forward<A>(lhs)), m_Rhs(std::forward<B>(rhs)),
+              m_Shape(Next::BroadcastShapes(m_Lhs.Shape(), m_Rhs.Shape())), m_Op(op) {}
+
+        [[nodiscard]] const Dims& Shape() const { return m_Shape; }
+
+        template<size_t I, size_t N>
+        void Bind(const Dims& shape, std::array<const ValueType*, N>& data,
+                  std::array<Dims, N>& strides, std::array<size_t, N>& offsets) const {
+            m_Lhs.template Bind<I>(shape, data, strides, offsets);
+            m_Rhs.template Bind<I + L::Leaves>(shape, data, strides, offsets);
+        }
+
+        /**
+         *  @brief Element i; a CheckedDivide below ors a zero integer divisor into zeros
+         * **/
+        template<size_t I, bool Contiguous, size_t N>
+        ValueType Eval(const std::array<const ValueType*, N>& ptrs, const std::array<size_t, N>& steps,
+                       size_t i, unsigned& zeros) const {
+            const ValueType lhs = m_Lhs.template Eval<I, Contiguous>(ptrs, steps, i, zeros);
+            const ValueType rhs = m_Rhs.template Eval<I + L::Leaves, Contiguous>(ptrs, steps, i, zeros);
+            if constexpr (std::is_same_v<Op, CheckedDivide>) return m_Op(lhs, rhs, zeros);
+            else return m_Op(lhs, rhs);
+        }
+    };
+
+    namespace Detail {
+        // Contiguous row of an expression: every operand steps by one, the destination does not overlap
+        // the inputs except element for element, so the loop carries no dependence and vectorizes. It is
+        // stamped out once per ISA like the Simd loops; the Eval calls inline into each copy. Contraction
+        // stays off so that a * b + c rounds like the eager mult and add on every ISA (AVX-512 implies FMA).
+#define NEXT_EXPR_NO_CONTRACT __attribute__((optimize("fp-contract=off")))
+#define NEXT_EXPR_DEFINE_ROW(TARGET)                                                                    \
+        template<typename T, typename E, size_t N>                                                      \
+        TARGET bool ExprRow(const E& expr, T* __restrict out, const std::array<const T*, N>& ptrs,      \
+                            size_t n) {                                                                 \
+            const std::array<size_t, N> steps{};                                                        \
+            unsigned zeros = 0;                                                                         \
+            for (size_t i = 0; i < n; i++) {                                                            \
+                out[i] = expr.template Eval<1, true>(ptrs, steps, i, zeros);                            \
+            }                                                                                           \
+            return zeros != 0;                                                                          \
+        }
+
+        namespace Scalar {
+            NEXT_EXPR_DEFINE_ROW(NEXT_EXPR_NO_CONTRACT)
+        }
+
+#if NEXT_SIMD_X86
+        namespace Avx2 {
+            NEXT_EXPR_DEFINE_ROW(NEXT_TARGET_AVX2 NEXT_EXPR_NO_CONTRACT)
+        }
+
+        namespace Avx512 {
+            NEXT_EXPR_DEFINE_ROW(NEXT_TARGET_AVX512 NEXT_EXPR_NO_CONTRACT)
+        }
+#endif
+#undef NEXT_EXPR_DEFINE_ROW
+#undef NEXT_EXPR_NO_CONTRACT
+
+        template<typename T, typename E, size_t N>
+        using ExprRowFn = bool (*)(const E&, T*, const std::array<const T*, N>&, size_t);
+
+        /**
+         *  @brief ExprRow compiled for the active ISA; it returns whether an integer divisor was zero
+         * **/
+        template<typename T, typename E, size_t N>
+        ExprRowFn<T, E, N> SelectExprRow() {
+#if NEXT_SIMD_X86
+            if (Simd::GetISA() >= Simd::ISA::AVX512) return &Avx512::ExprRow<T, E, N>;
+            if (Simd::GetISA() >= Simd::ISA::AVX2) return &Avx2::ExprRow<T, E, N>;
+#endif
+            return &Scalar::ExprRow<T, E, N>;
+        }
+    }
+
+    /**
+     *  @brief Evaluate expr into dst in one pass; dst may be any view but its shape must match exactly
+     *
+     *  Rows where every operand is contiguous run the vectorized ExprRow. A leaf broadcast along the row
+     *  (inner step zero) repeats one value, it is spread over a small block so such rows stay contiguous
+     *  loops too; only rows with a real stride take the scalar strided loop.
+     * **/
+    template<typename T, TensorExpression E>
+    void Evaluate(NextTensor<T>& dst, const E& expr) {
+        static_assert(std::is_same_v<T, typename E::ValueType>, "Expression and tensor element types differ");
+        if (dst.Shape() != expr.Shape()) {
+            throw std::runtime_error("Expression shape " + ShapeToString(expr.Shape()) +
+                                     " does not match destination shape " + ShapeToString(dst.Shape()));
+        }
+
+        // Operand 0 is the destination, operands 1..Leaves are the tensor leaves in tree order
+        constexpr size_t N = E::Leaves + 1;
+        std::array<const T*, N> data{};
+        std::array<Dims, N> strides;
+        std::array<size_t, N> offsets{};
+        strides[0] = dst.Strides();
+        offsets[0] = dst.Offset();
+        expr.template Bind<1>(dst.Shape(), data, strides, offsets);
+
+        NEXT_PROFILE_OP("expression", dst.Size(), [&] {
+            // A broadcast leaf counts each of its elements once
+            size_t elements = 0;
+            for (size_t k = 1; k < N; k++) {
+                size_t distinct = 1;
+                for (size_t d = 0; d < dst.Rank(); d++) {
+                    if (strides[k][d] != 0) distinct *= dst.Shape()[d];
+                }
+                elements += distinct;
+            }
+            return elements * sizeof(T);
+        }(), dst.Size() * sizeof(T));
+
+        T* out = dst.Data();
+        const auto row = Detail::SelectExprRow<T, E, N>();
+        auto checkedRow = [&](T* o, const std::array<const T*, N>& ptrs, size_t count) {
+            if (row(expr, o, ptrs, count)) {
+                throw std::runtime_error("Division by zero");
+            }
+        };
+
+        // Every leaf has the destination's contiguous layout: the whole tensor is one row, split only
+        // between threads, and there is no strided walk to set up
+        bool flat = dst.IsContiguous();
+        for (size_t k = 1; k < N && flat; k++) {
+            flat = strides[k] == strides[0];
+        }
+        if (flat) {
+            Next::ParallelFor(0, dst.Size(), DefaultGrainSize, [&](size_t begin, size_t end) {
+                std::array<const T*, N> ptrs{};
+                for (size_t k = 1; k < N; k++) {
+                    ptrs[k] = data[k] + offsets[k] + begin;
+                }
+                checkedRow(out + offsets[0] + begin, ptrs, end - begin);
+            });
+            return;
+        }
+
+        std::array<const Dims*, N> stridePtrs{};
+        for (size_t k = 0; k < N; k++) {
+            stridePtrs[k] = &strides[k];
+        }
+
+        Next::ParallelForEachStrided<N>(dst.Shape(), stridePtrs, offsets,
+            [&](const std::array<size_t, N>& rowOffsets, const std::array<size_t, N>& steps, size_t count) {
+                std::array<const T*, N> ptrs{};
+                bool contiguous = steps[0] == 1;
+                bool repeats = false;
+                for (size_t k = 1; k < N; k++) {
+                    ptrs[k] = data[k] + rowOffsets[k];
+                    contiguous &= steps[k] <= 1;
+                    repeats |= steps[k] == 0;
+                }
+                T* o = out + rowOffsets[0];
+                if (contiguous && !repeats) {
+                    checkedRow(o, ptrs, count);
+                } else if (contiguous) {
+                    constexpr size_t Block = 64;
+                    T repeated[N][Block];
+                    for (size_t k = 1; k < N; k++) {
+                        if (steps[k] == 0) {
+                            std::fill_n(repeated[k], std::min(Block, count), *ptrs[k]);
+                            ptrs[k] = repeated[k];
+                        }
+                    }
+                    for (size_t i = 0; i < count; i += Block) {
+                        checkedRow(o + i, ptrs, std::min(Block, count - i));
+                        for (size_t k = 1; k < N; k++) ptrs[k] += steps[k] * Block;
+                    }
+                } else {
+                    unsigned zeros = 0;
+                    for (size_t i = 0; i < count; i++) {
+                        o[i * steps[0]] = expr.template Eval<1, false>(ptrs, steps, i, zeros);
+                    }
+                    if (zeros != 0) {
+                        throw std::runtime_error("Division by zero");
+                    }
+                }
+            });
+    }
+
+    namespace Detail {
+        // Node type of an operand: tensors become leaves, expressions are taken as they are
+        template<typename X, typename V = std::remove_cvref_t<X>>
+        using ExprType = std::conditional_t<IsNextTensor<V>::value, TensorLeaf<typename V::ValueType>, V>;
+    }
+
+    template<typename X>
+    concept TensorOperand = IsNextTensor<std::remove_cvref_t<X>>::value || TensorExpression<X>;
+
+    template<typename S, typename X>
+    concept ScalarOperand = !TensorOperand<S> && std::is_convertible_v<S, typename std::remove_cvref_t<X>::ValueType>;
+
+    // The operands are forwarded into the node, so a temporary sub-expression (the usual a * b + c) is moved
+    // rather than copied and building a chain aliases every tensor once
+    template<typename Op, TensorOperand L, TensorOperand R>
+    auto MakeExpr(L&& lhs, R&& rhs) {
+        return BinaryExpr<Op, Detail::ExprType<L>, Detail::ExprType<R>>{std::forward<L>(lhs), std::forward<R>(rhs)};
+    }
+
+    template<typename Op, TensorOperand L, ScalarOperand<L> S>
+    auto MakeExpr(L&& lhs, const S& scalar) {
+        using T = typename std::remove_cvref_t<L>::ValueType;
+        return BinaryExpr<Op, Detail::ExprType<L>, ScalarLeaf<T>>{std::forward<L>(lhs), static_cast<T>(scalar)};
+    }
+
+    template<typename Op, TensorOperand R, ScalarOperand<R> S>
+    auto MakeExpr(const S& scalar, R&& rhs) {
+        using T = typename std::remove_cvref_t<R>::ValueType;
+        return BinaryExpr<Op, ScalarLeaf<T>, Detail::ExprType<R>>{static_cast<T>(scalar), std::forward<R>(rhs)};
+    }
+}
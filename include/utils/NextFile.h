@@ -0,0 +1,284 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NEXT_HAS_MMAP 1
+#else
+#define NEXT_HAS_MMAP 0
+#endif
+
+#include "../core/NextTensor.h"
+
+namespace Next {
+    // On-disk layout of a .nxt tensor file (all fields little-endian):
+    //
+    //   FileHeader                  64 bytes
+    //   uint64_t shape[Rank]
+    //   uint64_t strides[Rank]      in elements
+    //   zero padding                up to DataOffset, a multiple of Alignment
+    //   element data                DataBytes bytes, element (i...) at Offset + sum(i_d * strides[d])
+    //
+    // DType is stored as its numeric value in DType.h, so new DTypes are only ever appended to that enum.
+
+    inline constexpr char FileMagic[8] = {'N', 'E', 'X', 'T', 'T', 'N', 'S', 'R'};
+    inline constexpr uint32_t FileVersion = 1;
+
+    //*
+    //@brief Fixed-size header at the start of every tensor file.
+    //*/
+    struct FileHeader {
+        char Magic[8];
+        uint32_t Version;
+        uint32_t DataType;      // Numeric value of Next::DType
+        uint64_t Rank;
+        uint64_t Alignment;     // Alignment of DataOffset, in bytes
+        uint64_t DataOffset;    // Byte offset of the element data from the start of the file
+        uint64_t DataBytes;
+        uint64_t Offset;        // Element offset of the tensor inside the data block
+        uint64_t Reserved;
+    };
+    static_assert(sizeof(FileHeader) == 64, "FileHeader must stay 64 bytes");
+
+    namespace Detail {
+        inline void CheckLittleEndian() {
+            if constexpr (std::endian::native != std::endian::little) {
+                throw std::runtime_error("File error: tensor files are only supported on little-endian hosts");
+            }
+        }
+
+        //*
+        //@brief Header and layout of a tensor file, checked against the element type T.
+        //*/
+        struct FileLayout {
+            FileHeader m_Header{};
+            Dims m_Shape;
+            Dims m_Strides;
+        };
+
+        template<typename T>
+        FileLayout ParseFileLayout(const std::byte* bytes, size_t fileSize, const std::string& path) {
+            FileLayout layout;
+            if (fileSize < sizeof(FileHeader)) {
+                throw std::runtime_error("File error: '" + path + "' is too small to be a tensor file");
+            }
+            std::memcpy(&layout.m_Header, bytes, sizeof(FileHeader));
+            const auto& header = layout.m_Header;
+            if (std::memcmp(header.Magic, FileMagic, sizeof(FileMagic)) != 0) {
+                throw std::runtime_error("File error: '" + path + "' is not a tensor file");
+            }
+            if (header.Version != FileVersion) {
+                throw std::runtime_error("File error: '" + path + "' has unsupported version " +
+                                         std::to_string(header.Version));
+            }
+            if (header.DataType != static_cast<uint32_t>(Next::TypeToDType<T>::value)) {
+                throw std::runtime_error("File error: '" + path + "' holds DType " + std::to_string(header.DataType) +
+                                         ", expected " +
+                                         std::to_string(static_cast<uint32_t>(Next::TypeToDType<T>::value)));
+            }
+
+            const size_t dimsEnd = sizeof(FileHeader) + 2 * header.Rank * sizeof(uint64_t);
+            if (header.Rank > (fileSize - sizeof(FileHeader)) / (2 * sizeof(uint64_t)) ||
+                header.DataOffset < dimsEnd || header.DataOffset > fileSize ||
+                header.DataBytes > fileSize - header.DataOffset ||
+                header.DataOffset % alignof(T) != 0) {
+                throw std::runtime_error("File error: '" + path + "' has a corrupt header");
+            }
+
+            std::vector<uint64_t> dims(2 * header.Rank);
+            std::memcpy(dims.data(), bytes + sizeof(FileHeader), dims.size() * sizeof(uint64_t));
+            layout.m_Shape.assign(dims.begin(), dims.begin() + header.Rank);
+            layout.m_Strides.assign(dims.begin() + header.Rank, dims.end());
+
+            // Every addressable element must lie inside the data block. The element count and every offset term
+            // are computed with overflow checks: a wrapped product could otherwise pass for a small, in-range one
+            const size_t elements = header.DataBytes / sizeof(T);
+            size_t count = 1;
+            for (const size_t extent : layout.m_Shape) {
+                if (__builtin_mul_overflow(count, extent, &count)) {
+                    throw std::runtime_error("File error: '" + path + "' has a shape whose size overflows");
+                }
+            }
+            if (count > 0) {
+                size_t last = header.Offset;
+                bool overflow = false;
+                for (size_t d = 0; d < header.Rank; d++) {
+                    size_t term;
+                    overflow |= __builtin_mul_overflow(layout.m_Shape[d] - 1, layout.m_Strides[d], &term);
+                    overflow |= __builtin_add_overflow(last, term, &last);
+                }
+                if (overflow || last >= elements) {
+                    throw std::runtime_error("File error: '" + path + "' describes elements outside its data");
+                }
+            }
+            return layout;
+        }
+    }
+
+    namespace Detail {
+        /**
+         *  @brief Write the header and dims of a contiguous tensor of shape at the current position of file;
+         *  returns the byte offset of the data block, which only depends on the rank and alignment
+         * **/
+        inline size_t WriteFileHeader(std::ostream& file, DType dtype, const Dims& shape, size_t elementSize,
+                                      size_t alignment) {
+            if (alignment == 0 || !std::has_single_bit(alignment)) {
+                throw std::runtime_error("File error: alignment must be a power of two of at least alignof(T)");
+            }
+            const auto strides = Next::ComputeStrides(shape);
+            FileHeader header{};
+            std::memcpy(header.Magic, FileMagic, sizeof(FileMagic));
+            header.Version = FileVersion;
+            header.DataType = static_cast<uint32_t>(dtype);
+            header.Rank = shape.size();
+            header.Alignment = alignment;
+            const size_t dimsEnd = sizeof(FileHeader) + 2 * shape.size() * sizeof(uint64_t);
+            header.DataOffset = (dimsEnd + alignment - 1) / alignment * alignment;
+            header.DataBytes = Next::ComputeSize(shape) * elementSize;
+            header.Offset = 0;
+
+            std::vector<uint64_t> dims(shape.begin(), shape.end());
+            dims.insert(dims.end(), strides.begin(), strides.end());
+            const std::vector<char> padding(header.DataOffset - dimsEnd, 0);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(dims.data()), static_cast<std::streamsize>(dims.size() * sizeof(uint64_t)));
+            file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+            return header.DataOffset;
+        }
+
+        /**
+         *  @brief Read and check the header and dims of the tensor file open in file
+         * **/
+        template<typename T>
+        FileLayout ReadFileLayout(std::istream& file, const std::string& path) {
+            file.seekg(0, std::ios::end);
+            const auto fileSize = static_cast<size_t>(file.tellg());
+            std::vector<std::byte> head(std::min<size_t>(fileSize, sizeof(FileHeader)));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(head.data()), static_cast<std::streamsize>(head.size()));
+
+            // Header first, then everything up to the data block once the rank is known
+            FileHeader header{};
+            if (head.size() == sizeof(FileHeader)) {
+                std::memcpy(&header, head.data(), sizeof(FileHeader));
+            }
+            const size_t prefixSize = std::min<size_t>(fileSize, std::max<size_t>(header.DataOffset, sizeof(FileHeader)));
+            std::vector<std::byte> prefix(prefixSize);
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(prefix.data()), static_cast<std::streamsize>(prefixSize));
+            return ParseFileLayout<T>(prefix.data(), fileSize, path);
+        }
+    }
+
+    /**
+     *  @brief Write tensor to path; views are written compacted to a contiguous layout
+     *
+     *  alignment is the byte alignment of the data block inside the file (and therefore of the data pointer
+     *  of a mapped load); it must be a power of two.
+     * **/
+    template<typename T>
+    void SaveTensor(const NextTensor<T>& tensor, const std::string& path, size_t alignment = StorageAlignment) {
+        Detail::CheckLittleEndian();
+        if (alignment < alignof(T)) {
+            throw std::runtime_error("File error: alignment must be a power of two of at least alignof(T)");
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("File error: cannot open '" + path + "' for writing");
+        }
+        Detail::WriteFileHeader(file, tensor.GetDType(), tensor.Shape(), sizeof(T), alignment);
+
+        if (tensor.Size() > 0) {
+            const auto compact = tensor.contiguous();
+            file.write(reinterpret_cast<const char*>(compact.Data() + compact.Offset()),
+                       static_cast<std::streamsize>(tensor.Size() * sizeof(T)));
+        }
+        if (!file.flush()) {
+            throw std::runtime_error("File error: failed writing '" + path + "'");
+        }
+    }
+
+    /**
+     *  @brief Read a tensor file into freshly allocated storage
+     * **/
+    template<typename T>
+    NextTensor<T> LoadTensor(const std::string& path) {
+        Detail::CheckLittleEndian();
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("File error: cannot open '" + path + "'");
+        }
+        const auto layout = Detail::ReadFileLayout<T>(file, path);
+
+        const size_t elements = layout.m_Header.DataBytes / sizeof(T);
+        auto storage = Next::AllocateStorage<T>(elements, false);
+        file.seekg(static_cast<std::streamoff>(layout.m_Header.DataOffset));
+        file.read(reinterpret_cast<char*>(storage.get()), static_cast<std::streamsize>(elements * sizeof(T)));
+        if (!file) {
+            throw std::runtime_error("File error: failed reading '" + path + "'");
+        }
+        return NextTensor<T>{std::move(storage),
+                             NextMetadata{layout.m_Shape, layout.m_Strides, Next::TypeToDType<T>::value,
+                                          layout.m_Header.Offset}};
+    }
+
+#if NEXT_HAS_MMAP
+    /**
+     *  @brief Map a tensor file and use the mapping as storage, without copying the data
+     *
+     *  Only the header is read up front; data pages are faulted in on first touch and shared with every
+     *  other process mapping the same file. The mapping is private: writes to the tensor trigger a
+     *  copy-on-write of the touched pages and never reach the file. It is unmapped with the last tensor
+     *  (or view) sharing the storage.
+     * **/
+    template<typename T>
+    NextTensor<T> LoadTensorMapped(const std::string& path) {
+        Detail::CheckLittleEndian();
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("File error: cannot open '" + path + "'");
+        }
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("File error: cannot map '" + path + "'");
+        }
+        const auto fileSize = static_cast<size_t>(info.st_size);
+        void* base = ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            throw std::runtime_error("File error: cannot map '" + path + "'");
+        }
+
+        Detail::FileLayout layout;
+        try {
+            layout = Detail::ParseFileLayout<T>(static_cast<const std::byte*>(base), fileSize, path);
+        } catch (...) {
+            ::munmap(base, fileSize);
+            throw;
+        }
+
+        T* data = reinterpret_cast<T*>(static_cast<std::byte*>(base) + layout.m_Header.DataOffset);
+        std::shared_ptr<T[]> storage(data, [base, fileSize](T*) { ::munmap(base, fileSize); });
+        return NextTensor<T>{std::move(storage),
+                             NextMetadata{layout.m_Shape, layout.m_Strides, Next::TypeToDType<T>::value,
+                                          layout.m_Header.Offset}};
+    }
+#endif
+}
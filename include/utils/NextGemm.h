@@ -0,0 +1,281 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "NextUtils.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+namespace Next::Gemm {
+    //*
+    //@brief Blocking parameters of one element type.
+    //
+    // MR x NR is the register tile of the micro-kernel, KC x NR panels of B and MC x KC blocks of A are
+    // packed so that they stay in L1 / L2 while the micro-kernel streams over them.
+    //*/
+    template<typename T>
+    struct Config {
+        static constexpr size_t MR = 4;
+        static constexpr size_t NR = 8;
+        static constexpr size_t MC = 64;
+        static constexpr size_t KC = 256;
+        static constexpr size_t NC = 2048;
+    };
+
+    template<>
+    struct Config<float> {
+        static constexpr size_t MR = 6;
+        static constexpr size_t NR = 16;
+        static constexpr size_t MC = 72;
+        static constexpr size_t KC = 256;
+        static constexpr size_t NC = 4080;
+    };
+
+    template<>
+    struct Config<double> {
+        static constexpr size_t MR = 6;
+        static constexpr size_t NR = 8;
+        static constexpr size_t MC = 72;
+        static constexpr size_t KC = 256;
+        static constexpr size_t NC = 2048;
+    };
+
+    /**
+     *  @brief Strided view of a matrix: element (i, j) lives at Data[i * RowStride + j * ColStride]
+     * **/
+    template<typename T>
+    struct MatrixRef {
+        T* Data;
+        size_t RowStride;
+        size_t ColStride;
+    };
+
+    /**
+     *  @brief tile (MR x NR, row-major) = packed A sliver (kc x MR) * packed B sliver (kc x NR)
+     * **/
+    template<typename T, size_t MR, size_t NR>
+    void MicroKernelGeneric(size_t kc, const T* a, const T* b, T* tile) {
+        T acc[MR][NR] = {};
+        for (size_t k = 0; k < kc; k++, a += MR, b += NR) {
+            for (size_t i = 0; i < MR; i++) {
+                const T ai = a[i];
+                for (size_t j = 0; j < NR; j++) {
+                    acc[i][j] += ai * b[j];
+                }
+            }
+        }
+        for (size_t i = 0; i < MR; i++) {
+            for (size_t j = 0; j < NR; j++) {
+                tile[i * NR + j] = acc[i][j];
+            }
+        }
+    }
+
+#if NEXT_SIMD_X86
+    // 6 x 16 floats: 12 ymm accumulators, 2 loads of B and 6 broadcasts of A per k
+    __attribute__((target("avx2,fma")))
+    inline void MicroKernelAvx2(size_t kc, const float* a, const float* b, float* tile) {
+        __m256 c[6][2];
+        for (auto& row : c) {
+            row[0] = _mm256_setzero_ps();
+            row[1] = _mm256_setzero_ps();
+        }
+        for (size_t k = 0; k < kc; k++, a += 6, b += 16) {
+            const __m256 b0 = _mm256_loadu_ps(b);
+            const __m256 b1 = _mm256_loadu_ps(b + 8);
+            for (size_t i = 0; i < 6; i++) {
+                const __m256 ai = _mm256_broadcast_ss(a + i);
+                c[i][0] = _mm256_fmadd_ps(ai, b0, c[i][0]);
+                c[i][1] = _mm256_fmadd_ps(ai, b1, c[i][1]);
+            }
+        }
+        for (size_t i = 0; i < 6; i++) {
+            _mm256_storeu_ps(tile + i * 16, c[i][0]);
+            _mm256_storeu_ps(tile + i * 16 + 8, c[i][1]);
+        }
+    }
+
+    // 6 x 8 doubles: same register budget as the float kernel
+    __attribute__((target("avx2,fma")))
+    inline void MicroKernelAvx2(size_t kc, const double* a, const double* b, double* tile) {
+        __m256d c[6][2];
+        for (auto& row : c) {
+            row[0] = _mm256_setzero_pd();
+            row[1] = _mm256_setzero_pd();
+        }
+        for (size_t k = 0; k < kc; k++, a += 6, b += 8) {
+            const __m256d b0 = _mm256_loadu_pd(b);
+            const __m256d b1 = _mm256_loadu_pd(b + 4);
+            for (size_t i = 0; i < 6; i++) {
+                const __m256d ai = _mm256_broadcast_sd(a + i);
+                c[i][0] = _mm256_fmadd_pd(ai, b0, c[i][0]);
+                c[i][1] = _mm256_fmadd_pd(ai, b1, c[i][1]);
+            }
+        }
+        for (size_t i = 0; i < 6; i++) {
+            _mm256_storeu_pd(tile + i * 8, c[i][0]);
+            _mm256_storeu_pd(tile + i * 8 + 4, c[i][1]);
+        }
+    }
+#endif
+
+    template<typename T>
+    using MicroKernelFn = void (*)(size_t kc, const T* a, const T* b, T* tile);
+
+    /**
+     *  @brief Micro-kernel for the running CPU (AVX2 + FMA for float/double, portable loops otherwise)
+     * **/
+    template<typename T>
+    MicroKernelFn<T> SelectMicroKernel() {
+#if NEXT_SIMD_X86
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+            static const bool hasFma = __builtin_cpu_supports("fma");
+            if (hasFma && Simd::GetISA() >= Simd::ISA::AVX2) {
+                return static_cast<MicroKernelFn<T>>(&MicroKernelAvx2);
+            }
+        }
+#endif
+        return &MicroKernelGeneric<T, Config<T>::MR, Config<T>::NR>;
+    }
+
+    /**
+     *  @brief Pack an mc x kc block of A into MR-row slivers (k-major inside a sliver), zero padded
+     *
+     *  Elements of another type are converted to T here, one sliver column at a time, so a narrower operand
+     *  is never widened as a whole.
+     * **/
+    template<typename T, typename A>
+    void PackA(const MatrixRef<const A>& a, size_t mc, size_t kc, T* dst) {
+        constexpr size_t MR = Config<T>::MR;
+        for (size_t ir = 0; ir < mc; ir += MR) {
+            const size_t mr = std::min(MR, mc - ir);
+            for (size_t k = 0; k < kc; k++) {
+                Simd::ConvertRow(a.Data + ir * a.RowStride + k * a.ColStride, a.RowStride, dst, 1, mr);
+                for (size_t i = mr; i < MR; i++) {
+                    dst[i] = T{};
+                }
+                dst += MR;
+            }
+        }
+    }
+
+    /**
+     *  @brief Pack a kc x nc panel of B into NR-column slivers (k-major inside a sliver), zero padded,
+     *  converting elements of another type to T
+     * **/
+    template<typename T, typename B>
+    void PackB(const MatrixRef<const B>& b, size_t kc, size_t nc, T* dst) {
+        constexpr size_t NR = Config<T>::NR;
+        for (size_t jr = 0; jr < nc; jr += NR) {
+            const size_t nr = std::min(NR, nc - jr);
+            for (size_t k = 0; k < kc; k++) {
+                const B* src = b.Data + k * b.RowStride + jr * b.ColStride;
+                if (b.ColStride == 1) {
+                    Simd::ConvertRow(src, 1, dst, 1, nr);
+                } else {
+                    Simd::ConvertRow(src, b.ColStride, dst, 1, nr);
+                }
+                for (size_t j = nr; j < NR; j++) {
+                    dst[j] = T{};
+                }
+                dst += NR;
+            }
+        }
+    }
+
+    // Tags of the per-thread packing buffers (see ThreadScratch), reused by every later product
+    struct PackedA;
+    struct PackedB;
+    struct WideC;
+
+    /**
+     *  @brief C (m x n) = A (m x k) * B (k x n) for arbitrary strides; C is overwritten
+     *
+     *  The product is computed in T. A, B and C may be other element types (16-bit floats, the narrower
+     *  operand of a mixed-DType product): panels are converted while they are packed, and a C of another
+     *  type is accumulated in T and rounded once. Blocks of A are spread over the intra-op thread pool
+     *  unless parallel is false (used when the caller already parallelizes over a batch).
+     * **/
+    template<typename T, typename A = T, typename B = T, typename C = T>
+    void Gemm(size_t m, size_t n, size_t k, MatrixRef<const A> a, MatrixRef<const B> b, MatrixRef<C> c,
+              bool parallel = true) {
+        using Cfg = Config<T>;
+        if (m == 0 || n == 0) return;
+        if (k == 0) {
+            for (size_t i = 0; i < m; i++) {
+                for (size_t j = 0; j < n; j++) {
+                    c.Data[i * c.RowStride + j * c.ColStride] = C{};
+                }
+            }
+            return;
+        }
+        if constexpr (!std::is_same_v<C, T>) {
+            if (k > Cfg::KC) {
+                // Panels of k are summed into C, which would round every partial sum: sum them in T instead
+                T* wide = Next::ThreadScratch<WideC, T>(m * n);
+                Gemm<T>(m, n, k, a, b, MatrixRef<T>{wide, n, 1}, parallel);
+                for (size_t i = 0; i < m; i++) {
+                    Simd::ConvertRow(wide + i * n, 1, c.Data + i * c.RowStride, c.ColStride, n);
+                }
+                return;
+            }
+        }
+
+        const auto kernel = SelectMicroKernel<T>();
+        T* bPack = Next::ThreadScratch<PackedB, T>(
+            Cfg::KC * ((std::min(n, Cfg::NC) + Cfg::NR - 1) / Cfg::NR * Cfg::NR));
+        const size_t mBlocks = (m + Cfg::MC - 1) / Cfg::MC;
+        // One block of A is worth a thread once a block-row of C costs about a million multiply-adds
+        const size_t grain = parallel ? std::max<size_t>(1, (size_t{1} << 20) / (Cfg::MC * n * k + 1)) : mBlocks;
+
+        for (size_t jc = 0; jc < n; jc += Cfg::NC) {
+            const size_t nc = std::min(Cfg::NC, n - jc);
+            for (size_t pc = 0; pc < k; pc += Cfg::KC) {
+                const size_t kc = std::min(Cfg::KC, k - pc);
+                PackB<T, B>({b.Data + pc * b.RowStride + jc * b.ColStride, b.RowStride, b.ColStride}, kc, nc,
+                            bPack);
+
+                Next::ParallelFor(0, mBlocks, grain, [&](size_t blockBegin, size_t blockEnd) {
+                    T* aPack = Next::ThreadScratch<PackedA, T>(Cfg::MC * kc);
+                    T tile[Cfg::MR * Cfg::NR];
+                    for (size_t block = blockBegin; block < blockEnd; block++) {
+                        const size_t ic = block * Cfg::MC;
+                        const size_t mc = std::min(Cfg::MC, m - ic);
+                        PackA<T, A>({a.Data + ic * a.RowStride + pc * a.ColStride, a.RowStride, a.ColStride}, mc,
+                                    kc, aPack);
+
+                        for (size_t jr = 0; jr < nc; jr += Cfg::NR) {
+                            const size_t nr = std::min(Cfg::NR, nc - jr);
+                            for (size_t ir = 0; ir < mc; ir += Cfg::MR) {
+                                const size_t mr = std::min(Cfg::MR, mc - ir);
+                                kernel(kc, aPack + ir * kc, bPack + jr * kc, tile);
+
+                                C* dst = c.Data + (ic + ir) * c.RowStride + (jc + jr) * c.ColStride;
+                                for (size_t i = 0; i < mr; i++) {
+                                    C* row = dst + i * c.RowStride;
+                                    const T* t = tile + i * Cfg::NR;
+                                    if constexpr (std::is_same_v<C, T>) {
+                                        if (pc == 0) {
+                                            for (size_t j = 0; j < nr; j++) row[j * c.ColStride] = t[j];
+                                        } else {
+                                            for (size_t j = 0; j < nr; j++) row[j * c.ColStride] += t[j];
+                                        }
+                                    } else {
+                                        // k fits one panel here, so this is the only write of the row
+                                        Simd::ConvertRow(t, 1, row, c.ColStride, nr);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                });
+            }
+        }
+    }
+}
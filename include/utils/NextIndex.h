@@ -0,0 +1,320 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "BroadcastUtils.h"
+#include "NextProfile.h"
+#include "NextUtils.h"
+#include "StridedIterator.h"
+#include "ThreadPool.h"
+
+namespace Next::Index {
+    // Elements (or rows) ahead of the current one whose source or destination is prefetched. Indexed
+    // accesses defeat the hardware prefetcher, so the address is computed from the index that far ahead
+    inline constexpr size_t PrefetchDistance = 16;
+
+    // Shortest contiguous run index_select copies as one row instead of going through Gather
+    inline constexpr size_t MinRowCopy = 16;
+
+    inline void Prefetch(const void* address, bool forWrite = false) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (forWrite) __builtin_prefetch(address, 1);
+        else __builtin_prefetch(address, 0);
+#else
+        (void)address;
+        (void)forWrite;
+#endif
+    }
+
+    /**
+     *  @brief Throws unless every index of the view lies in [0, bound)
+     *
+     *  Checked once up front so the copy loops run without a branch per element; the scan has no early exit
+     *  so it vectorizes. Negative indices are rejected, not counted from the end.
+     * **/
+    inline void CheckIndices(const int64_t* index, const Dims& shape, const Dims& strides, size_t offset,
+                             size_t bound, size_t dim) {
+        Next::ParallelForEachStrided<1>(shape, {&strides}, {offset},
+            [&](const std::array<size_t, 1>& offsets, const std::array<size_t, 1>& steps, size_t count) {
+                const int64_t* a = index + offsets[0];
+                size_t outside = 0;
+                if (steps[0] == 1) {
+                    for (size_t i = 0; i < count; i++) outside += static_cast<uint64_t>(a[i]) >= bound;
+                } else {
+                    for (size_t i = 0; i < count; i++) outside += static_cast<uint64_t>(a[i * steps[0]]) >= bound;
+                }
+                if (outside != 0) {
+                    throw std::out_of_range("Index error: index out of range for dimension " + std::to_string(dim) +
+                                            " of size " + std::to_string(bound));
+                }
+            });
+    }
+
+    /**
+     *  @brief Throws unless index has the rank of shape and no dimension larger than it, except along dim
+     *  (shape.size() checks every dimension)
+     * **/
+    inline void CheckIndexShape(const Dims& indexShape, const Dims& shape, size_t dim, const char* what) {
+        bool fits = indexShape.size() == shape.size();
+        for (size_t d = 0; d < indexShape.size() && fits; d++) {
+            fits = d == dim || indexShape[d] <= shape[d];
+        }
+        if (!fits) {
+            throw std::runtime_error(std::string("Index error: index of shape ") + ShapeToString(indexShape) +
+                                     " does not fit " + what + " of shape " + ShapeToString(shape));
+        }
+    }
+
+    /**
+     *  @brief out[i...] = src[i with dimension dim replaced by index[i...]], out has index's shape
+     *
+     *  srcStrides must have a zero in dim and srcDimStride carries the real stride, so that one strided walk
+     *  over index's shape yields the source row start. A row whose index does not change (an index_select
+     *  index expanded along the other dimensions) is a single block copy; otherwise the source element
+     *  PrefetchDistance elements ahead is prefetched while the current one is copied.
+     * **/
+    template<typename T>
+    void Gather(T* out, const Dims& outStrides, size_t outOffset,
+                const int64_t* index, const Dims& indexShape, const Dims& indexStrides, size_t indexOffset,
+                const T* src, const Dims& srcStrides, size_t srcOffset, size_t srcDimStride) {
+        Next::ParallelForEachStrided<3>(indexShape, {&outStrides, &indexStrides, &srcStrides},
+                                        {outOffset, indexOffset, srcOffset},
+            [&](const std::array<size_t, 3>& offsets, const std::array<size_t, 3>& steps, size_t count) {
+                T* o = out + offsets[0];
+                const int64_t* ix = index + offsets[1];
+                const T* s = src + offsets[2];
+                if (steps[1] == 0) {
+                    const T* row = s + static_cast<size_t>(*ix) * srcDimStride;
+                    if (steps[0] == 1 && steps[2] == 1) {
+                        std::copy(row, row + count, o);
+                    } else {
+                        for (size_t i = 0; i < count; i++) o[i * steps[0]] = row[i * steps[2]];
+                    }
+                    return;
+                }
+                const size_t ahead = count > PrefetchDistance ? count - PrefetchDistance : 0;
+                for (size_t i = 0; i < ahead; i++) {
+                    const size_t p = i + PrefetchDistance;
+                    Prefetch(s + p * steps[2] + static_cast<size_t>(ix[p * steps[1]]) * srcDimStride);
+                    o[i * steps[0]] = s[i * steps[2] + static_cast<size_t>(ix[i * steps[1]]) * srcDimStride];
+                }
+                for (size_t i = ahead; i < count; i++) {
+                    o[i * steps[0]] = s[i * steps[2] + static_cast<size_t>(ix[i * steps[1]]) * srcDimStride];
+                }
+            });
+    }
+
+    /**
+     *  @brief Rows of src selected along dim by a 1-D index, into the contiguous out
+     *
+     *  src is read as outer x n x inner, with inner the elements after dim. When inner is a contiguous run of
+     *  at least MinRowCopy elements every (outer, index) pair is one memcpy of a row, split across the thread
+     *  pool by rows, with the row PrefetchDistance ahead prefetched; embedding lookups take this path.
+     *  Everything else goes through Gather with the index expanded to the result shape.
+     * **/
+    template<typename T>
+    void IndexSelect(T* out, const T* src, const Dims& srcShape, const Dims& srcStrides, size_t srcOffset, size_t dim,
+                     const int64_t* index, size_t indexStride, size_t indexOffset, size_t count) {
+        const Dims innerShape(srcShape.begin() + dim + 1, srcShape.end());
+        const Dims innerStrides(srcStrides.begin() + dim + 1, srcStrides.end());
+        const size_t inner = Next::ComputeSize(innerShape);
+
+        auto outShape = srcShape;
+        outShape[dim] = count;
+        if (Next::ComputeSize(outShape) == 0) return;
+
+        if (!std::is_trivially_copyable_v<T> || inner < MinRowCopy || !Next::IsContiguous(innerShape, innerStrides)) {
+            auto n_SrcStrides = srcStrides;
+            n_SrcStrides[dim] = 0;
+            Dims n_IndexStrides(srcShape.size(), 0);
+            n_IndexStrides[dim] = indexStride;
+            Gather(out, Next::ComputeStrides(outShape), 0, index, outShape, n_IndexStrides, indexOffset,
+                   src, n_SrcStrides, srcOffset, srcStrides[dim]);
+            return;
+        }
+
+        const Dims outerShape(srcShape.begin(), srcShape.begin() + dim);
+        const Dims outerStrides(srcStrides.begin(), srcStrides.begin() + dim);
+        const size_t rows = Next::ComputeSize(outerShape) * count;
+        const size_t dimStride = srcStrides[dim];
+        NEXT_PROFILE_WALK(rows, false);
+        const int64_t* ix = index + indexOffset;
+        // Source offset of outer position o, the only place the outer dimensions' strides come in
+        auto outerOffset = [&](size_t o) {
+            size_t result = srcOffset;
+            for (size_t d = outerShape.size(); d-- > 0;) {
+                result += o % outerShape[d] * outerStrides[d];
+                o /= outerShape[d];
+            }
+            return result;
+        };
+        const size_t grain = std::max<size_t>(1, Next::DefaultGrainSize / inner);
+        Next::ParallelFor(0, rows, grain, [&](size_t begin, size_t end) {
+            size_t o = begin / count, j = begin % count;
+            size_t base = outerOffset(o);
+            for (size_t r = begin; r < end; r++) {
+                if (j + PrefetchDistance < count) {
+                    Prefetch(src + base + static_cast<size_t>(ix[(j + PrefetchDistance) * indexStride]) * dimStride);
+                }
+                std::memcpy(out + r * inner, src + base + static_cast<size_t>(ix[j * indexStride]) * dimStride,
+                            inner * sizeof(T));
+                if (++j == count && r + 1 < end) {
+                    j = 0;
+                    base = outerOffset(++o);
+                }
+            }
+        });
+    }
+
+    /**
+     *  @brief dst[i with dimension dim replaced by index[i...]] = src[i...] (or += with Accumulate), for every
+     *  position i of index
+     *
+     *  dstStrides must have a zero in dim and dstDimStride carries the real stride. Positions that differ
+     *  outside dim never write the same element, so the walk over index's shape with dim collapsed is split
+     *  across threads as is, each thread running through dim in order; duplicate indices therefore resolve
+     *  deterministically (the last one wins for a plain scatter). When that walk is too small to split (a
+     *  1-D histogram, a scatter of whole rows), dim itself is split:
+     *   - Accumulate with a destination small next to the work: each chunk of dim adds into its own zeroed
+     *     partial buffer and the partials are merged in chunk order, no atomics
+     *   - otherwise: each thread owns a range of destination indices and applies only the updates that land
+     *     in it, so every thread reads all indices but writes disjoint elements
+     * **/
+    template<bool Accumulate, typename T>
+    void Scatter(T* dst, const Dims& dstShape, const Dims& dstStrides, size_t dstOffset, size_t dstDimStride,
+                 const int64_t* index, const Dims& indexShape, const Dims& indexStrides, size_t indexOffset,
+                 const T* src, const Dims& srcStrides, size_t srcOffset, size_t dim) {
+        const size_t total = Next::ComputeSize(indexShape);
+        if (total == 0) return;
+        const size_t n = indexShape[dim];
+        auto walkShape = indexShape;
+        walkShape[dim] = 1;
+        const size_t indexDimStride = indexStrides[dim];
+        const size_t srcDimStride = srcStrides[dim];
+
+        // Updates of dim entries [kBegin, kEnd) landing in destination indices [lo, hi), into target
+        auto apply = [&](T* target, const Dims& targetStrides, size_t targetOffset, size_t targetDimStride,
+                         size_t kBegin, size_t kEnd, size_t lo, size_t hi, bool parallel) {
+            auto rowFn = [&](const std::array<size_t, 3>& offsets, const std::array<size_t, 3>& steps, size_t count) {
+                T* t = target + offsets[0];
+                for (size_t k = kBegin; k < kEnd; k++) {
+                    const int64_t* ix = index + offsets[1] + k * indexDimStride;
+                    const T* s = src + offsets[2] + k * srcDimStride;
+                    for (size_t i = 0; i < count; i++) {
+                        if (steps[1] != 0 && i + PrefetchDistance < count) {
+                            const size_t p = i + PrefetchDistance;
+                            Prefetch(t + p * steps[0] + static_cast<size_t>(ix[p * steps[1]]) * targetDimStride, true);
+                        }
+                        const auto j = static_cast<size_t>(ix[i * steps[1]]);
+                        if (j < lo || j >= hi) continue;
+                        T& element = t[i * steps[0] + j * targetDimStride];
+                        if constexpr (Accumulate) element += s[i * steps[2]];
+                        else element = s[i * steps[2]];
+                    }
+                }
+            };
+            const std::array<size_t, 3> offsets{targetOffset, indexOffset, srcOffset};
+            if (parallel) {
+                Next::ParallelForEachStrided<3>(walkShape, {&targetStrides, &indexStrides, &srcStrides}, offsets,
+                                                rowFn, std::max<size_t>(1, Next::DefaultGrainSize / (kEnd - kBegin)));
+            } else {
+                Next::ForEachStrided<3>(walkShape, {&targetStrides, &indexStrides, &srcStrides}, offsets, rowFn);
+            }
+        };
+
+        // The walk only splits between its rows, so it needs a few rows per thread to be worth keeping
+        const size_t threads = Next::GetNumThreads();
+        const size_t extent = dstShape[dim];
+        const size_t walkRows = StridedIterator<3>{walkShape, {&dstStrides, &indexStrides, &srcStrides},
+                                                   {dstOffset, indexOffset, srcOffset}}.Rows();
+        if (threads == 1 || total < 2 * Next::DefaultGrainSize || walkRows >= 2 * threads) {
+            apply(dst, dstStrides, dstOffset, dstDimStride, 0, n, 0, extent, true);
+            return;
+        }
+
+        const size_t dstSize = Next::ComputeSize(dstShape);
+        const size_t chunks = std::min({threads, n, total / Next::DefaultGrainSize});
+        if (Accumulate && chunks >= 2 && (chunks - 1) * dstSize <= total) {
+            // Chunk 0 adds into dst, the others into contiguous partial buffers merged in chunk order
+            const auto partialStrides = [&] {
+                auto strides = Next::ComputeStrides(dstShape);
+                strides[dim] = 0;
+                return strides;
+            }();
+            const size_t partialDimStride = Next::ComputeStrides(dstShape)[dim];
+            auto partials = Next::MakeScratch<T>((chunks - 1) * dstSize, T{});
+            Next::ParallelFor(0, chunks, 1, [&](size_t chunkBegin, size_t chunkEnd) {
+                for (size_t c = chunkBegin; c < chunkEnd; c++) {
+                    const size_t kBegin = n * c / chunks, kEnd = n * (c + 1) / chunks;
+                    if (c == 0) {
+                        apply(dst, dstStrides, dstOffset, dstDimStride, kBegin, kEnd, 0, extent, false);
+                    } else {
+                        apply(partials.get() + (c - 1) * dstSize, partialStrides, 0, partialDimStride,
+                              kBegin, kEnd, 0, extent, false);
+                    }
+                }
+            });
+            auto fullStrides = dstStrides;
+            fullStrides[dim] = dstDimStride;
+            const auto contiguousStrides = Next::ComputeStrides(dstShape);
+            for (size_t c = 1; c < chunks; c++) {
+                const T* partial = partials.get() + (c - 1) * dstSize;
+                Next::ParallelForEachStrided<2>(dstShape, {&fullStrides, &contiguousStrides}, {dstOffset, 0},
+                    [&](const std::array<size_t, 2>& offsets, const std::array<size_t, 2>& steps, size_t count) {
+                        T* d = dst + offsets[0];
+                        const T* p = partial + offsets[1];
+                        for (size_t i = 0; i < count; i++) d[i * steps[0]] += p[i * steps[1]];
+                    });
+            }
+            return;
+        }
+
+        const size_t owners = std::min(threads, extent);
+        Next::ParallelFor(0, owners, 1, [&](size_t ownerBegin, size_t ownerEnd) {
+            for (size_t w = ownerBegin; w < ownerEnd; w++) {
+                apply(dst, dstStrides, dstOffset, dstDimStride, 0, n, extent * w / owners, extent * (w + 1) / owners, false);
+            }
+        });
+    }
+
+    /**
+     *  @brief Elements of the contiguous src whose flag in the contiguous mask is set, in order
+     *
+     *  Blocks are counted in parallel first, so each block knows where its selected elements start and is
+     *  compacted independently. allocate(count) is called once with the total and returns the destination.
+     * **/
+    template<typename T, typename AllocateFn>
+    void MaskedSelect(const T* src, const bool* mask, size_t size, AllocateFn&& allocate) {
+        const size_t blocks = std::max<size_t>(1, std::min(Next::GetNumThreads() * 4, size / Next::DefaultGrainSize));
+        auto starts = Next::MakeScratch<size_t>(blocks + 1, 0);
+        Next::ParallelFor(0, blocks, 1, [&](size_t blockBegin, size_t blockEnd) {
+            for (size_t b = blockBegin; b < blockEnd; b++) {
+                size_t selected = 0;
+                for (size_t i = size * b / blocks; i < size * (b + 1) / blocks; i++) selected += mask[i];
+                starts[b + 1] = selected;
+            }
+        });
+        for (size_t b = 0; b < blocks; b++) {
+            starts[b + 1] += starts[b];
+        }
+
+        T* out = allocate(starts[blocks]);
+        Next::ParallelFor(0, blocks, 1, [&](size_t blockBegin, size_t blockEnd) {
+            for (size_t b = blockBegin; b < blockEnd; b++) {
+                T* o = out + starts[b];
+                for (size_t i = size * b / blocks; i < size * (b + 1) / blocks; i++) {
+                    if (mask[i]) *o++ = src[i];
+                }
+            }
+        });
+    }
+}
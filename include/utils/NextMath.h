@@ -0,0 +1,334 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "Half.h"
+#include "SimdKernels.h"
+
+namespace Next::Math {
+    //*
+    //@brief Element-wise math and activation functions.
+    //
+    // float rows run vectorized polynomial approximations (AVX2 + FMA), double rows call the std:: functions,
+    // 16-bit floats are widened to float. Maximum error of the float kernels against the std:: functions
+    // evaluated in double, measured over every 37th float bit pattern (tests/test_math.cpp):
+    //   EXP      1.01 ulp   overflows to inf above 88.72, underflows gradually through the subnormals
+    //   LOG      0.8 ulp    subnormals included; log(+-0) = -inf, log(x < 0) = NaN
+    //   TANH     1.31 ulp
+    //   SIGMOID  2.32 ulp   e^x / (1 + e^x) below zero, so tiny results keep their precision
+    //   GELU     9 ulp      for x >= -2; absolute error below 6e-7 everywhere (the tanh form, see ScalarApply)
+    //   RELU     exact
+    // NaN inputs give NaN for every op (GELU(-inf) is NaN as well, like the tanh form it evaluates). Without
+    // AVX2 float rows are evaluated in double and stay within 0.5 ulp.
+    //*/
+    enum class UnaryOp {
+        EXP,
+        LOG,
+        TANH,
+        SIGMOID,
+        GELU,
+        RELU,
+        COUNT
+    };
+
+    constexpr const char* OpName(UnaryOp op) {
+        constexpr const char* names[] = {"exp", "log", "tanh", "sigmoid", "gelu", "relu"};
+        return op < UnaryOp::COUNT ? names[static_cast<size_t>(op)] : "unary";
+    }
+
+    template<typename T>
+    inline constexpr bool HasMath = std::is_floating_point_v<T> || IsReducedFloat<T>;
+
+    // Type the math is evaluated in: 16-bit floats are widened to float
+    template<typename T>
+    using ComputeType = std::conditional_t<IsReducedFloat<T>, float, T>;
+
+    inline constexpr double GeluScale = 0.7978845608028654;    // sqrt(2 / pi)
+    inline constexpr double GeluCubic = 0.044715;
+
+    /**
+     *  @brief Reference definition of op through the std:: functions
+     *
+     *  GELU is the tanh approximation 0.5 x (1 + tanh(u)), u = sqrt(2 / pi) (x + 0.044715 x^3), evaluated as
+     *  x / (1 + e^(-2u)) which is the same function without the cancellation for negative x.
+     * **/
+    template<UnaryOp Op, typename T>
+    T ScalarApply(T x) {
+        if constexpr (Op == UnaryOp::EXP) return std::exp(x);
+        else if constexpr (Op == UnaryOp::LOG) return std::log(x);
+        else if constexpr (Op == UnaryOp::TANH) return std::tanh(x);
+        else if constexpr (Op == UnaryOp::SIGMOID) {
+            // e^x / (1 + e^x) below zero, where e^-x would overflow before the result underflows
+            const T e = std::exp(-std::fabs(x));
+            return (x < T(0) ? e : T(1)) / (T(1) + e);
+        }
+        else if constexpr (Op == UnaryOp::GELU) {
+            const T u = T(GeluScale) * x * (T(1) + T(GeluCubic) * x * x);
+            return x / (T(1) + std::exp(T(-2) * u));
+        } else return x < T(0) ? T(0) : x;
+    }
+
+    //*
+    //@brief Contiguous rows of one type: out[i] = op(a[i] + bias[i * biasStep]), without the bias when it
+    // is null. biasStep is 0 (one value for the row) or 1; out may be a.
+    //*/
+    template<typename T>
+    struct MathTable {
+        using RowFn = void (*)(T* out, const T* a, const T* bias, size_t biasStep, size_t n);
+        std::array<RowFn, static_cast<size_t>(UnaryOp::COUNT)> Row;
+    };
+
+    namespace Scalar {
+        // float is evaluated in double, so the fallback stays within the error bounds of the vector kernels
+        template<UnaryOp Op, typename T>
+        void Row(T* out, const T* a, const T* bias, size_t biasStep, size_t n) {
+            using Wide = std::conditional_t<std::is_same_v<T, float>, double, T>;
+            if (bias == nullptr) {
+                for (size_t i = 0; i < n; i++) out[i] = T(ScalarApply<Op>(Wide(a[i])));
+            } else {
+                for (size_t i = 0; i < n; i++) out[i] = T(ScalarApply<Op>(Wide(T(a[i] + bias[i * biasStep]))));
+            }
+        }
+    }
+
+#if NEXT_SIMD_X86
+    namespace Avx2 {
+#define NEXT_MATH_TARGET __attribute__((target("avx2,fma")))
+
+        NEXT_MATH_TARGET inline __m256 Set(float value) { return _mm256_set1_ps(value); }
+
+        // x 2^n for integral n in [-150, 128], applied as two factors that are both normal floats
+        NEXT_MATH_TARGET inline __m256 Scale(__m256 x, __m256 n) {
+            const __m256i ni = _mm256_cvtps_epi32(n);
+            const __m256i n1 = _mm256_srai_epi32(ni, 1);
+            const __m256i n2 = _mm256_sub_epi32(ni, n1);
+            const __m256i bias = _mm256_set1_epi32(127);
+            const __m256 s1 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n1, bias), 23));
+            const __m256 s2 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n2, bias), 23));
+            return _mm256_mul_ps(_mm256_mul_ps(x, s1), s2);
+        }
+
+        // Cephes expf: e^x = 2^n e^r with n = round(x / ln 2), |r| <= ln 2 / 2 and a degree 7 polynomial for
+        // e^r. ln 2 is split in two so that r is exact. Applying 2^n as two factors keeps the results that
+        // over- or underflow (n of 128 or below -126) correct without a special case.
+        NEXT_MATH_TARGET inline __m256 Exp(__m256 x) {
+            const __m256 isNan = _mm256_cmp_ps(x, x, _CMP_UNORD_Q);
+            const __m256 c = _mm256_min_ps(_mm256_max_ps(x, Set(-104.0f)), Set(89.0f));
+            const __m256 n = _mm256_round_ps(_mm256_mul_ps(c, Set(1.44269504088896341f)),
+                                             _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            __m256 r = _mm256_fnmadd_ps(n, Set(0.693359375f), c);
+            r = _mm256_fnmadd_ps(n, Set(-2.12194440e-4f), r);
+
+            __m256 p = Set(1.9875691500e-4f);
+            p = _mm256_fmadd_ps(p, r, Set(1.3981999507e-3f));
+            p = _mm256_fmadd_ps(p, r, Set(8.3334519073e-3f));
+            p = _mm256_fmadd_ps(p, r, Set(4.1665795894e-2f));
+            p = _mm256_fmadd_ps(p, r, Set(1.6666665459e-1f));
+            p = _mm256_fmadd_ps(p, r, Set(5.0000001201e-1f));
+            p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), r);
+            p = _mm256_add_ps(p, Set(1.0f));
+            return _mm256_blendv_ps(Scale(p, n), x, isNan);
+        }
+
+        // Cephes logf: x = m 2^e with m in [sqrt(0.5), sqrt(2)), log(m) = f - f^2 / 2 + f^3 P(f) for f = m - 1,
+        // then e ln 2 is added with ln 2 split in two. Subnormals are scaled by 2^23 first.
+        NEXT_MATH_TARGET inline __m256 Log(__m256 x) {
+            const __m256 tiny = _mm256_cmp_ps(x, Set(1.17549435e-38f), _CMP_LT_OQ);
+            const __m256 scaled = _mm256_blendv_ps(x, _mm256_mul_ps(x, Set(8388608.0f)), tiny);
+            const __m256i bits = _mm256_castps_si256(scaled);
+
+            __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+            e = _mm256_sub_ps(e, _mm256_and_ps(tiny, Set(23.0f)));
+            __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                                                           _mm256_set1_epi32(0x3f000000)));
+            // m in [0.5, 1): below sqrt(0.5) use 2m - 1 and one less in the exponent, else m - 1
+            const __m256 low = _mm256_cmp_ps(m, Set(0.707106781186547524f), _CMP_LT_OQ);
+            e = _mm256_sub_ps(e, _mm256_and_ps(low, Set(1.0f)));
+            m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(low, m)), Set(1.0f));
+
+            const __m256 z = _mm256_mul_ps(m, m);
+            __m256 y = Set(7.0376836292e-2f);
+            y = _mm256_fmadd_ps(y, m, Set(-1.1514610310e-1f));
+            y = _mm256_fmadd_ps(y, m, Set(1.1676998740e-1f));
+            y = _mm256_fmadd_ps(y, m, Set(-1.2420140846e-1f));
+            y = _mm256_fmadd_ps(y, m, Set(1.4249322787e-1f));
+            y = _mm256_fmadd_ps(y, m, Set(-1.6668057665e-1f));
+            y = _mm256_fmadd_ps(y, m, Set(2.0000714765e-1f));
+            y = _mm256_fmadd_ps(y, m, Set(-2.4999993993e-1f));
+            y = _mm256_fmadd_ps(y, m, Set(3.3333331174e-1f));
+            y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+            y = _mm256_fmadd_ps(e, Set(-2.12194440e-4f), y);
+            y = _mm256_fnmadd_ps(Set(0.5f), z, y);
+            __m256 result = _mm256_add_ps(m, y);
+            result = _mm256_fmadd_ps(e, Set(0.693359375f), result);
+
+            // log(0) = -inf, log(inf) = inf, log(x < 0) and log(NaN) = NaN
+            const __m256 zero = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_EQ_OQ);
+            const __m256 inf = _mm256_cmp_ps(x, Set(INFINITY), _CMP_EQ_OQ);
+            const __m256 invalid = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_NGE_UQ);
+            result = _mm256_blendv_ps(result, Set(-INFINITY), zero);
+            result = _mm256_blendv_ps(result, x, inf);
+            return _mm256_blendv_ps(result, Set(NAN), invalid);
+        }
+
+        // Cephes tanhf: an odd polynomial below |x| = 0.625, where 1 - 2 / (e^2|x| + 1) would cancel, the
+        // exponential form with the sign of x above
+        NEXT_MATH_TARGET inline __m256 Tanh(__m256 x) {
+            const __m256 sign = _mm256_and_ps(x, Set(-0.0f));
+            const __m256 ax = _mm256_andnot_ps(Set(-0.0f), x);
+
+            const __m256 z = _mm256_mul_ps(x, x);
+            __m256 small = Set(-5.70498872745e-3f);
+            small = _mm256_fmadd_ps(small, z, Set(2.06390887954e-2f));
+            small = _mm256_fmadd_ps(small, z, Set(-5.37397155531e-2f));
+            small = _mm256_fmadd_ps(small, z, Set(1.33314422036e-1f));
+            small = _mm256_fmadd_ps(small, z, Set(-3.33332819422e-1f));
+            small = _mm256_fmadd_ps(_mm256_mul_ps(small, z), x, x);
+
+            const __m256 e = Exp(_mm256_add_ps(ax, ax));
+            __m256 large = _mm256_sub_ps(Set(1.0f), _mm256_div_ps(Set(2.0f), _mm256_add_ps(e, Set(1.0f))));
+            // The sign is put back on both (the polynomial alone would lose it for -0)
+            const __m256 result = _mm256_blendv_ps(large, small, _mm256_cmp_ps(ax, Set(0.625f), _CMP_LT_OQ));
+            return _mm256_or_ps(result, sign);
+        }
+
+        // 1 / (1 + e^-x) for positive x, e^x / (1 + e^x) for negative x, so e^-|x| never overflows and tiny
+        // results keep their precision
+        NEXT_MATH_TARGET inline __m256 Sigmoid(__m256 x) {
+            const __m256 e = Exp(_mm256_or_ps(x, Set(-0.0f)));
+            const __m256 negative = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ);
+            const __m256 num = _mm256_blendv_ps(Set(1.0f), e, negative);
+            return _mm256_div_ps(num, _mm256_add_ps(Set(1.0f), e));
+        }
+
+        // x sigmoid(2u) is the tanh form 0.5 x (1 + tanh(u)) without its cancellation for negative x
+        NEXT_MATH_TARGET inline __m256 Gelu(__m256 x) {
+            const __m256 inner = _mm256_fmadd_ps(_mm256_mul_ps(x, x), Set(float(GeluCubic)), Set(1.0f));
+            const __m256 u2 = _mm256_mul_ps(_mm256_mul_ps(x, Set(float(-2.0 * GeluScale))), inner);
+            return _mm256_div_ps(x, _mm256_add_ps(Set(1.0f), Exp(u2)));
+        }
+
+        template<UnaryOp Op>
+        NEXT_MATH_TARGET inline __m256 Apply(__m256 x) {
+            if constexpr (Op == UnaryOp::EXP) return Exp(x);
+            else if constexpr (Op == UnaryOp::LOG) return Log(x);
+            else if constexpr (Op == UnaryOp::TANH) return Tanh(x);
+            else if constexpr (Op == UnaryOp::SIGMOID) return Sigmoid(x);
+            else if constexpr (Op == UnaryOp::GELU) return Gelu(x);
+            else return _mm256_max_ps(_mm256_setzero_ps(), x);
+        }
+
+        // The tail goes through the vector code as well (zero padded), so every element of a row gets the
+        // same approximation
+        template<UnaryOp Op>
+        NEXT_MATH_TARGET void Row(float* out, const float* a, const float* bias, size_t biasStep, size_t n) {
+            size_t i = 0;
+            if (bias == nullptr) {
+                for (; i + 8 <= n; i += 8) {
+                    _mm256_storeu_ps(out + i, Apply<Op>(_mm256_loadu_ps(a + i)));
+                }
+            } else if (biasStep == 0) {
+                const __m256 b = Set(*bias);
+                for (; i + 8 <= n; i += 8) {
+                    _mm256_storeu_ps(out + i, Apply<Op>(_mm256_add_ps(_mm256_loadu_ps(a + i), b)));
+                }
+            } else {
+                for (; i + 8 <= n; i += 8) {
+                    const __m256 x = _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(bias + i));
+                    _mm256_storeu_ps(out + i, Apply<Op>(x));
+                }
+            }
+            if (i < n) {
+                alignas(32) float tail[8] = {};
+                for (size_t j = i; j < n; j++) {
+                    tail[j - i] = bias == nullptr ? a[j] : a[j] + bias[j * biasStep];
+                }
+                _mm256_store_ps(tail, Apply<Op>(_mm256_load_ps(tail)));
+                std::copy(tail, tail + (n - i), out + i);
+            }
+        }
+
+#undef NEXT_MATH_TARGET
+    }
+#endif
+
+    namespace Detail {
+        template<typename T, template<UnaryOp, typename> class Kernel>
+        constexpr MathTable<T> MakeTable() {
+            return {{&Kernel<UnaryOp::EXP, T>::Run, &Kernel<UnaryOp::LOG, T>::Run, &Kernel<UnaryOp::TANH, T>::Run,
+                     &Kernel<UnaryOp::SIGMOID, T>::Run, &Kernel<UnaryOp::GELU, T>::Run,
+                     &Kernel<UnaryOp::RELU, T>::Run}};
+        }
+
+        template<UnaryOp Op, typename T>
+        struct ScalarKernel {
+            static void Run(T* out, const T* a, const T* bias, size_t biasStep, size_t n) {
+                Scalar::Row<Op>(out, a, bias, biasStep, n);
+            }
+        };
+
+#if NEXT_SIMD_X86
+        template<UnaryOp Op, typename T>
+        struct Avx2Kernel {
+            static void Run(T* out, const T* a, const T* bias, size_t biasStep, size_t n) {
+                Avx2::Row<Op>(out, a, bias, biasStep, n);
+            }
+        };
+#endif
+    }
+
+    /**
+     *  @brief Row kernels of T for the running CPU (AVX2 + FMA for float, the std:: functions otherwise)
+     * **/
+    template<typename T>
+    const MathTable<T>& Kernels() {
+        static constexpr MathTable<T> scalar = Detail::MakeTable<T, Detail::ScalarKernel>();
+#if NEXT_SIMD_X86
+        if constexpr (std::is_same_v<T, float>) {
+            static constexpr MathTable<T> avx2 = Detail::MakeTable<T, Detail::Avx2Kernel>();
+            static const bool hasFma = __builtin_cpu_supports("fma");
+            if (hasFma && Simd::GetISA() >= Simd::ISA::AVX2) return avx2;
+        }
+#endif
+        return scalar;
+    }
+
+    /**
+     *  @brief out[i * outStep] = op(a[i * aStep] + bias[i * biasStep]) for one strided row (no bias when null)
+     *
+     *  Unit-stride rows of float and double go straight to the row kernel; strided rows, 16-bit floats and
+     *  inputs of another type than out (a and bias only need to convert to T) are gathered and converted
+     *  into blocks first. out may be a, but no other overlap.
+     * **/
+    template<typename T, typename A, typename B>
+    void UnaryRow(UnaryOp op, T* out, size_t outStep, const A* a, size_t aStep,
+                  const B* bias, size_t biasStep, size_t n) {
+        static_assert(HasMath<T>, "Math ops need a floating point element type");
+        using C = ComputeType<T>;
+        const auto kernel = Kernels<C>().Row[static_cast<size_t>(op)];
+        if constexpr (std::is_same_v<T, C> && std::is_same_v<A, T> && std::is_same_v<B, T>) {
+            if (outStep == 1 && aStep == 1 && biasStep <= 1) {
+                kernel(out, a, bias, biasStep, n);
+                return;
+            }
+        }
+        constexpr size_t Block = 256;
+        C fa[Block], fb[Block], fo[Block];
+        for (size_t i = 0; i < n; i += Block) {
+            const size_t m = std::min(Block, n - i);
+            Simd::ConvertRow(a + i * aStep, aStep, fa, 1, m);
+            if (bias != nullptr) {
+                Simd::ConvertRow(bias + i * biasStep, biasStep, fb, 1, biasStep == 0 ? 1 : m);
+            }
+            kernel(fo, fa, bias == nullptr ? nullptr : fb, biasStep == 0 ? 0 : 1, m);
+            Simd::ConvertRow(fo, 1, out + i * outStep, outStep, m);
+        }
+    }
+}
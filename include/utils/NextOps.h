@@ -4,64 +4,73 @@
 
 #pragma once
 #include "../core/NextTensor.h"
+#include "NextExpr.h"
 
 namespace Next {
-    template<typename T>
-    NextTensor<T> operator+(const NextTensor<T>& lhs, const NextTensor<T>& rhs) {
-        return lhs.add(rhs);
+    // The operators build lazy expressions instead of tensors: `a * b + c / d` allocates nothing until it is
+    // assigned to a NextTensor (or passed to NextTensor::assign), which evaluates the whole chain in one
+    // fused pass. The named methods (add, sub, mult, divide, ...) stay eager.
+
+    template<TensorOperand L, TensorOperand R>
+    auto operator+(L&& lhs, R&& rhs) {
+        return MakeExpr<Simd::Arith<Simd::BinaryOp::ADD>>(std::forward<L>(lhs), std::forward<R>(rhs));
     }
-    template<typename T>
-    NextTensor<T> operator+(const NextTensor<T>& lhs, const T& rhs) {
-        return lhs.add(rhs);
+
+    template<TensorOperand L, ScalarOperand<L> S>
+    auto operator+(L&& lhs, const S& rhs) {
+        return MakeExpr<Simd::Arith<Simd::BinaryOp::ADD>>(std::forward<L>(lhs), rhs);
     }
 
-    template<typename T>
-    NextTensor<T> operator+(const T& scalar, const NextTensor<T>& rhs) {
-        return rhs.add(scalar);
+    template<TensorOperand R, ScalarOperand<R> S>
+    auto operator+(const S& scalar, R&& rhs) {
+        return MakeExpr<Simd::Arith<Simd::BinaryOp::ADD>>(scalar, std::forward<R>(rhs));
     }
 
-    template<typename T>
-    NextTensor<T> operator-(const NextTensor<T>& lhs, const NextTensor<T>& rhs) {
-        return lhs.sub(rhs);
+    template<TensorOperand L, TensorOperand R>
+    auto operator-(L&& lhs, R&& rhs) {
+        return MakeExpr<Simd::Arith<Simd::BinaryOp::SUB>>(std::forward<L>(lhs), std::forward<R>(rhs));
     }
 
-    template<typename T>
-    NextTensor<T> operator-(const NextTensor<T>& lhs, const T& rhs) {
-        return lhs.sub(rhs);
+    template<TensorOperand L, ScalarOperand<L> S>
+    auto operator-(L&& lhs, const S& rhs) {
+        return MakeExpr<Simd::Arith<Simd::BinaryOp::SUB>>(std::forward<L>(lhs), rhs);
     }
 
-    template<typename T>
-    NextTensor<T> operator-(const T& scalar, const NextTensor<T>& rhs) {
-        return rhs.rsub(scalar);
+    template<TensorOperand R, ScalarOperand<R> S>
+    auto operator-(const S& scalar, R&& rhs) {
+        return MakeExpr<Simd::Arith<Simd::BinaryOp::SUB>>(scalar, std::forward<R>(rhs));
     }
 
-    template<typename T>
-    NextTensor<T> operator*(const NextTensor<T>& lhs, const NextTensor<T>& rhs) {
-        return lhs.mult(rhs);
+    template<TensorOperand L, TensorOperand R>
+    auto operator*(L&& lhs, R&& rhs) {
+        return MakeExpr<Simd::Arith<Simd::BinaryOp::MUL>>(std::forward<L>(lhs), std::forward<R>(rhs));
     }
 
-    template<typename T>
-    NextTensor<T> operator*(const NextTensor<T>& lhs, const T& rhs) {
-        return lhs.mult(rhs);
+    template<TensorOperand L, ScalarOperand<L> S>
+    auto operator*(L&& lhs, const S& rhs) {
+        return MakeExpr<Simd::Arith<Simd::BinaryOp::MUL>>(std::forward<L>(lhs), rhs);
     }
 
-    template<typename T>
-    NextTensor<T> operator*(const T& scalar, const NextTensor<T>& rhs) {
-        return rhs.mult(scalar);
+    template<TensorOperand R, ScalarOperand<R> S>
+    auto operator*(const S& scalar, R&& rhs) {
+        return MakeExpr<Simd::Arith<Simd::BinaryOp::MUL>>(scalar, std::forward<R>(rhs));
     }
 
-    template<typename T>
-    NextTensor<T> operator/(const NextTensor<T>& lhs, const NextTensor<T>& rhs) {
-        return lhs.divide(rhs);
+    template<TensorOperand L, TensorOperand R>
+    auto operator/(L&& lhs, R&& rhs) {
+        return MakeExpr<CheckedDivide>(std::forward<L>(lhs), std::forward<R>(rhs));
     }
 
-    template<typename T>
-    NextTensor<T> operator/(const NextTensor<T>& lhs, const T& rhs) {
-        return lhs.divide(rhs);
+    template<TensorOperand L, ScalarOperand<L> S>
+    auto operator/(L&& lhs, const S& rhs) {
+        if (std::numeric_limits<typename std::remove_cvref_t<L>::ValueType>::is_integer && rhs == 0) {
+            throw std::runtime_error("Division by zero");
+        }
+        return MakeExpr<Simd::Arith<Simd::BinaryOp::DIV>>(std::forward<L>(lhs), rhs);
     }
 
-    template<typename T>
-    NextTensor<T> operator/(const T& scalar, const NextTensor<T>& rhs) {
-        return rhs.rdivide(scalar);
+    template<TensorOperand R, ScalarOperand<R> S>
+    auto operator/(const S& scalar, R&& rhs) {
+        return MakeExpr<CheckedDivide>(scalar, std::forward<R>(rhs));
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,326 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef NEXT_TENSOR_PROFILE
+#define NEXT_TENSOR_PROFILE 0
+#endif
+
+namespace Next::Profile {
+    // Opt-in per-op profiler. Built with NEXT_TENSOR_PROFILE=1 (the CMake option of the same name), every op
+    // of NextTensor and Tensor records one Event: wall time, elements, bytes read and written, storage
+    // allocations and whether its rows ran contiguous or strided. Without it the NEXT_PROFILE_* hooks expand
+    // to nothing and their arguments are never evaluated, so a default build pays nothing. The functions
+    // reading the results exist in both builds, an unprofiled one simply has no events:
+    //
+    //   Profile::WriteChromeTrace("trace.json");   // chrome://tracing or ui.perfetto.dev
+    //   Profile::PrintSummary(std::cout);
+    //
+    // Each thread records into a log of its own, so recording threads never contend; events are kept until
+    // Reset, so a long-running process should dump and reset them periodically. Times are inclusive:
+    // an op that runs other ops (mean dividing its sum, a Half matmul converting to float) contains their
+    // events, which the trace shows nested.
+
+    enum class Path : uint8_t {
+        NONE,           // The op walked no rows through the strided iterator
+        CONTIGUOUS,     // Every row was unit-stride (or repeated one value) for every operand
+        STRIDED         // At least one operand was walked with a stride larger than one
+    };
+
+    //*
+    //@brief One recorded op; byte counts are what the kernel reads and writes, not what the allocator moves.
+    //*/
+    struct Event {
+        const char* Name{nullptr};
+        uint32_t Thread{0};         // Small id, in the order threads recorded their first event
+        uint64_t Start{0};          // Nanoseconds since the first use of the profiler
+        uint64_t Duration{0};       // Nanoseconds
+        size_t Elements{0};         // Elements of the result (of the input for in-place ops)
+        size_t BytesRead{0};
+        size_t BytesWritten{0};
+        size_t Allocations{0};      // Tensor storage allocations, copy-on-write clones included
+        size_t Rows{0};             // Inner rows walked; many short rows are a slow layout as well
+        Profile::Path Path{Profile::Path::NONE};
+    };
+
+    //*
+    //@brief Events of one op name summed up.
+    //*/
+    struct OpStats {
+        size_t Calls{0};
+        uint64_t Nanoseconds{0};
+        size_t Elements{0};
+        size_t BytesRead{0};
+        size_t BytesWritten{0};
+        size_t Allocations{0};
+        size_t ContiguousCalls{0};
+        size_t StridedCalls{0};
+    };
+
+    namespace Detail {
+        struct ThreadLog {
+            std::mutex m_Mutex;         // Only contended while the events are read or reset
+            std::vector<Event> m_Events;
+            uint32_t m_Thread{0};
+        };
+
+        struct Registry {
+            std::mutex m_Mutex;
+            std::vector<std::shared_ptr<ThreadLog>> m_Logs;     // Kept after their thread has exited
+            std::atomic<bool> m_Enabled{true};
+            const std::chrono::steady_clock::time_point m_Epoch{std::chrono::steady_clock::now()};
+        };
+
+        inline Registry& Logs() {
+            static Registry registry;
+            return registry;
+        }
+
+        inline ThreadLog& LocalLog() {
+            thread_local const std::shared_ptr<ThreadLog> log = [] {
+                auto& registry = Logs();
+                auto created = std::make_shared<ThreadLog>();
+                std::lock_guard lock{registry.m_Mutex};
+                created->m_Thread = static_cast<uint32_t>(registry.m_Logs.size() + 1);
+                registry.m_Logs.push_back(created);
+                return created;
+            }();
+            return *log;
+        }
+
+        inline uint64_t Now() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - Logs().m_Epoch).count());
+        }
+
+        // Storage allocations made by this thread, sampled at the start and end of every scope
+        inline thread_local size_t t_Allocations = 0;
+    }
+
+    /**
+     *  @brief Whether scopes record; on by default in a profiled build, for switching on around one region
+     * **/
+    [[nodiscard]] inline bool Enabled() {
+        return NEXT_TENSOR_PROFILE && Detail::Logs().m_Enabled.load(std::memory_order_relaxed);
+    }
+
+    inline void SetEnabled(bool enabled) {
+        Detail::Logs().m_Enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    //*
+    //@brief Records the op running on this thread from construction to destruction, use NEXT_PROFILE_OP.
+    //
+    // A scope opened inside a scope of the same name is merged into it, so an allocating form that runs
+    // through its output-parameter form (sum() through sum(axes, out)) counts as one call.
+    //*/
+    class Scope {
+    private:
+        static inline thread_local Scope* t_Current = nullptr;
+
+        Event m_Event;
+        size_t m_Allocations{0};
+        Scope* m_Parent{nullptr};
+        bool m_Active{false};
+
+    public:
+        Scope(const char* name, size_t elements, size_t bytesRead, size_t bytesWritten) {
+            if (!Enabled()) return;
+            if (t_Current && std::strcmp(t_Current->m_Event.Name, name) == 0) return;
+            m_Event.Name = name;
+            m_Event.Elements = elements;
+            m_Event.BytesRead = bytesRead;
+            m_Event.BytesWritten = bytesWritten;
+            m_Allocations = Detail::t_Allocations;
+            m_Parent = t_Current;
+            m_Active = true;
+            t_Current = this;
+            m_Event.Start = Detail::Now();
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope() {
+            if (!m_Active) return;
+            m_Event.Duration = Detail::Now() - m_Event.Start;
+            m_Event.Allocations = Detail::t_Allocations - m_Allocations;
+            t_Current = m_Parent;
+            auto& log = Detail::LocalLog();
+            m_Event.Thread = log.m_Thread;
+            std::lock_guard lock{log.m_Mutex};
+            log.m_Events.push_back(m_Event);
+        }
+
+        /**
+         *  @brief Rows walked by the innermost scope of this thread; one strided walk marks the whole op strided
+         * **/
+        static void NoteWalk(size_t rows, bool strided) {
+            if (!t_Current) return;
+            auto& event = t_Current->m_Event;
+            event.Rows += rows;
+            if (strided) event.Path = Path::STRIDED;
+            else if (event.Path == Path::NONE) event.Path = Path::CONTIGUOUS;
+        }
+
+        /**
+         *  @brief Bytes written by the innermost scope, for ops whose result size is only known while they run
+         * **/
+        static void NoteWritten(size_t bytes) {
+            if (t_Current) t_Current->m_Event.BytesWritten += bytes;
+        }
+    };
+
+    /**
+     *  @brief Every event recorded so far, ordered by start time
+     * **/
+    [[nodiscard]] inline std::vector<Event> Events() {
+        std::vector<Event> events;
+        auto& registry = Detail::Logs();
+        std::lock_guard lock{registry.m_Mutex};
+        for (const auto& log : registry.m_Logs) {
+            std::lock_guard logLock{log->m_Mutex};
+            events.insert(events.end(), log->m_Events.begin(), log->m_Events.end());
+        }
+        std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.Start < b.Start; });
+        return events;
+    }
+
+    /**
+     *  @brief Drop every recorded event
+     * **/
+    inline void Reset() {
+        auto& registry = Detail::Logs();
+        std::lock_guard lock{registry.m_Mutex};
+        for (const auto& log : registry.m_Logs) {
+            std::lock_guard logLock{log->m_Mutex};
+            log->m_Events.clear();
+        }
+    }
+
+    [[nodiscard]] inline std::map<std::string, OpStats> Summary() {
+        std::map<std::string, OpStats> summary;
+        for (const auto& event : Events()) {
+            auto& stats = summary[event.Name];
+            stats.Calls++;
+            stats.Nanoseconds += event.Duration;
+            stats.Elements += event.Elements;
+            stats.BytesRead += event.BytesRead;
+            stats.BytesWritten += event.BytesWritten;
+            stats.Allocations += event.Allocations;
+            stats.ContiguousCalls += event.Path == Path::CONTIGUOUS;
+            stats.StridedCalls += event.Path == Path::STRIDED;
+        }
+        return summary;
+    }
+
+    [[nodiscard]] inline const char* PathName(Path path) {
+        switch (path) {
+            case Path::CONTIGUOUS: return "contiguous";
+            case Path::STRIDED: return "strided";
+            default: return "none";
+        }
+    }
+
+    /**
+     *  @brief Events in the Chrome trace event format: one complete ("X") event per op, counters in args
+     * **/
+    inline void WriteChromeTrace(std::ostream& os) {
+        const auto events = Events();
+        const auto flags = os.flags();
+        os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        os << std::fixed << std::setprecision(3);
+        for (size_t i = 0; i < events.size(); i++) {
+            const auto& event = events[i];
+            os << (i == 0 ? "\n" : ",\n")
+               << "{\"name\":\"" << event.Name << "\",\"cat\":\"" << PathName(event.Path)
+               << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.Thread
+               << ",\"ts\":" << static_cast<double>(event.Start) / 1e3
+               << ",\"dur\":" << static_cast<double>(event.Duration) / 1e3
+               << ",\"args\":{\"elements\":" << event.Elements
+               << ",\"bytes_read\":" << event.BytesRead
+               << ",\"bytes_written\":" << event.BytesWritten
+               << ",\"allocations\":" << event.Allocations
+               << ",\"rows\":" << event.Rows
+               << ",\"path\":\"" << PathName(event.Path) << "\"}}";
+        }
+        os << "\n]}\n";
+        os.flags(flags);
+    }
+
+    inline void WriteChromeTrace(const std::string& path) {
+        std::ofstream file(path);
+        if (!file) {
+            throw std::runtime_error("Profile error: cannot open '" + path + "' for writing");
+        }
+        WriteChromeTrace(file);
+        if (!file) {
+            throw std::runtime_error("Profile error: failed writing '" + path + "'");
+        }
+    }
+
+    /**
+     *  @brief One line per op, slowest total first: calls, time, throughput, allocations and how many calls
+     *  took a strided path
+     * **/
+    inline void PrintSummary(std::ostream& os) {
+        const auto summary = Summary();
+        std::vector<std::pair<std::string, OpStats>> ops(summary.begin(), summary.end());
+        std::stable_sort(ops.begin(), ops.end(), [](const auto& a, const auto& b) {
+            return a.second.Nanoseconds > b.second.Nanoseconds;
+        });
+
+        const auto flags = os.flags();
+        os << std::left << std::setw(18) << "op" << std::right
+           << std::setw(10) << "calls" << std::setw(12) << "total ms" << std::setw(12) << "mean us"
+           << std::setw(14) << "elements" << std::setw(10) << "GB/s" << std::setw(10) << "allocs"
+           << std::setw(10) << "strided" << '\n';
+        os << std::fixed;
+        for (const auto& [name, stats] : ops) {
+            const double seconds = static_cast<double>(stats.Nanoseconds) / 1e9;
+            const double bytes = static_cast<double>(stats.BytesRead + stats.BytesWritten);
+            os << std::left << std::setw(18) << name << std::right
+               << std::setw(10) << stats.Calls
+               << std::setw(12) << std::setprecision(3) << seconds * 1e3
+               << std::setw(12) << std::setprecision(2) << seconds * 1e6 / static_cast<double>(stats.Calls)
+               << std::setw(14) << stats.Elements
+               << std::setw(10) << std::setprecision(2) << (seconds > 0 ? bytes / seconds / 1e9 : 0.0)
+               << std::setw(10) << stats.Allocations
+               << std::setw(10) << stats.StridedCalls << '\n';
+        }
+        os.flags(flags);
+    }
+}
+
+#if NEXT_TENSOR_PROFILE
+#define NEXT_PROFILE_CONCAT_IMPL(a, b) a##b
+#define NEXT_PROFILE_CONCAT(a, b) NEXT_PROFILE_CONCAT_IMPL(a, b)
+// NEXT_PROFILE_OP(name, elements, bytesRead, bytesWritten): record the rest of the enclosing block as op name
+#define NEXT_PROFILE_OP(...) const ::Next::Profile::Scope NEXT_PROFILE_CONCAT(n_ProfileScope, __LINE__){__VA_ARGS__}
+// NEXT_PROFILE_WALK(rows, strided): report the rows an op walks and whether any operand was strided
+#define NEXT_PROFILE_WALK(...) ::Next::Profile::Scope::NoteWalk(__VA_ARGS__)
+#define NEXT_PROFILE_WRITTEN(...) ::Next::Profile::Scope::NoteWritten(__VA_ARGS__)
+#define NEXT_PROFILE_ALLOCATION() (::Next::Profile::Detail::t_Allocations++)
+#else
+#define NEXT_PROFILE_OP(...) static_cast<void>(0)
+#define NEXT_PROFILE_WALK(...) static_cast<void>(0)
+#define NEXT_PROFILE_WRITTEN(...) static_cast<void>(0)
+#define NEXT_PROFILE_ALLOCATION() static_cast<void>(0)
+#endif
@@ -0,0 +1,362 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "NextGemm.h"
+#include "NextUtils.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+namespace Next::Quant {
+    // Affine int8 quantization: q = clamp(round(x / scale) + zeroPoint, -128, 127), x ~ (q - zeroPoint) * scale.
+    // Rounding is half to even everywhere, so the vector and scalar paths produce identical values.
+
+    inline constexpr int32_t QMin = -128;
+    inline constexpr int32_t QMax = 127;
+
+    namespace Detail {
+        template<typename Src>
+        int8_t QuantizeValue(Src x, float invScale, float zeroPoint) {
+            float v = std::nearbyint(static_cast<float>(x) * invScale) + zeroPoint;
+            // fmax first so that NaN lands on QMin, like the vector path
+            v = std::fmin(std::fmax(v, static_cast<float>(QMin)), static_cast<float>(QMax));
+            return static_cast<int8_t>(v);
+        }
+
+        inline float DequantizeValue(int8_t q, float scale, float zeroPoint) {
+            return (static_cast<float>(q) - zeroPoint) * scale;
+        }
+    }
+
+    namespace Scalar {
+        template<typename Src>
+        void QuantizeRow(const Src* src, int8_t* dst, size_t n, const float* invScale, const float* zeroPoint,
+                         size_t paramStep) {
+            for (size_t i = 0; i < n; i++) {
+                dst[i] = Detail::QuantizeValue(src[i], invScale[i * paramStep], zeroPoint[i * paramStep]);
+            }
+        }
+
+        inline void DequantizeRow(const int8_t* src, float* dst, size_t n, const float* scale,
+                                  const float* zeroPoint, size_t paramStep) {
+            for (size_t i = 0; i < n; i++) {
+                dst[i] = Detail::DequantizeValue(src[i], scale[i * paramStep], zeroPoint[i * paramStep]);
+            }
+        }
+    }
+
+#if NEXT_SIMD_X86
+    namespace Avx2 {
+        template<typename Src>
+        NEXT_TARGET_AVX2 __m256 LoadAsFloat(const Src* src) {
+            if constexpr (std::is_same_v<Src, float>) return _mm256_loadu_ps(src);
+            else return _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+        }
+
+        template<typename Src>
+        NEXT_TARGET_AVX2 void QuantizeRow(const Src* src, int8_t* dst, size_t n, const float* invScale,
+                                          const float* zeroPoint, size_t paramStep) {
+            const __m256 lo = _mm256_set1_ps(static_cast<float>(QMin));
+            const __m256 hi = _mm256_set1_ps(static_cast<float>(QMax));
+            // packs works inside 128-bit lanes; this gathers the 4-byte groups back into element order
+            const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                __m256i q[4];
+                for (size_t v = 0; v < 4; v++) {
+                    const size_t at = i + 8 * v;
+                    const __m256 scale = paramStep == 0 ? _mm256_broadcast_ss(invScale) : _mm256_loadu_ps(invScale + at);
+                    const __m256 zero = paramStep == 0 ? _mm256_broadcast_ss(zeroPoint) : _mm256_loadu_ps(zeroPoint + at);
+                    __m256 x = _mm256_round_ps(_mm256_mul_ps(LoadAsFloat(src + at), scale),
+                                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                    x = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(x, zero), lo), hi);
+                    q[v] = _mm256_cvtps_epi32(x);
+                }
+                const __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(q[0], q[1]), _mm256_packs_epi32(q[2], q[3]));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permutevar8x32_epi32(packed, order));
+            }
+            Scalar::QuantizeRow(src + i, dst + i, n - i, invScale + i * paramStep, zeroPoint + i * paramStep,
+                                paramStep);
+        }
+
+        NEXT_TARGET_AVX2 inline void DequantizeRow(const int8_t* src, float* dst, size_t n, const float* scale,
+                                                   const float* zeroPoint, size_t paramStep) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m256 s = paramStep == 0 ? _mm256_broadcast_ss(scale) : _mm256_loadu_ps(scale + i);
+                const __m256 z = paramStep == 0 ? _mm256_broadcast_ss(zeroPoint) : _mm256_loadu_ps(zeroPoint + i);
+                int64_t bytes;
+                std::memcpy(&bytes, src + i, sizeof(bytes));
+                const __m256 q = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_cvtsi64_si128(bytes)));
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_sub_ps(q, z), s));
+            }
+            Scalar::DequantizeRow(src + i, dst + i, n - i, scale + i * paramStep, zeroPoint + i * paramStep,
+                                  paramStep);
+        }
+    }
+#endif
+
+    /**
+     *  @brief dst[i] = quantize(src[i]) with 1 / scale invScale[i * paramStep] and zeroPoint[i * paramStep]
+     *
+     *  paramStep is 0 when the whole row shares one scale and 1 for a scale per element. Src is float, or
+     *  int32_t for requantizing accumulators. NaN quantizes to -128.
+     * **/
+    template<typename Src>
+    void QuantizeRow(const Src* src, int8_t* dst, size_t n, const float* invScale, const float* zeroPoint,
+                     size_t paramStep) {
+#if NEXT_SIMD_X86
+        if (Simd::GetISA() >= Simd::ISA::AVX2) return Avx2::QuantizeRow(src, dst, n, invScale, zeroPoint, paramStep);
+#endif
+        Scalar::QuantizeRow(src, dst, n, invScale, zeroPoint, paramStep);
+    }
+
+    /**
+     *  @brief dst[i] = (src[i] - zeroPoint[i * paramStep]) * scale[i * paramStep]
+     * **/
+    inline void DequantizeRow(const int8_t* src, float* dst, size_t n, const float* scale, const float* zeroPoint,
+                              size_t paramStep) {
+#if NEXT_SIMD_X86
+        if (Simd::GetISA() >= Simd::ISA::AVX2) return Avx2::DequantizeRow(src, dst, n, scale, zeroPoint, paramStep);
+#endif
+        Scalar::DequantizeRow(src, dst, n, scale, zeroPoint, paramStep);
+    }
+
+    //*
+    //@brief Blocking of the int8 GEMM.
+    //
+    // K is consumed in groups of four: a packed B panel stores, per group, the four int8 values of each of
+    // its NR columns next to each other (the operand layout of vpdpbusd), a packed A sliver one or two
+    // 32-bit words per row and group depending on the micro-kernel.
+    //*/
+    struct Int8Config {
+        static constexpr size_t MR = 4;
+        static constexpr size_t NR = 16;
+        static constexpr size_t MC = 96;
+        static constexpr size_t KC = 512;
+        static constexpr size_t NC = 2048;
+    };
+
+    using Int8MicroKernelFn = void (*)(size_t groups, const int32_t* a, const int8_t* b, int32_t* tile);
+
+    /**
+     *  @brief A micro-kernel and the A packing it reads
+     *
+     *  Vnni kernels take A as unsigned bytes biased by +128 (one word per row and group), the others as
+     *  two words holding the int16 pairs (k0, k2) and (k1, k3).
+     * **/
+    struct Int8MicroKernel {
+        Int8MicroKernelFn Fn;
+        bool Vnni;
+    };
+
+    inline void MicroKernelInt8Generic(size_t groups, const int32_t* a, const int8_t* b, int32_t* tile) {
+        constexpr size_t MR = Int8Config::MR, NR = Int8Config::NR;
+        int32_t acc[MR][NR] = {};
+        for (size_t g = 0; g < groups; g++, a += 2 * MR, b += 4 * NR) {
+            for (size_t i = 0; i < MR; i++) {
+                const auto even = static_cast<uint32_t>(a[2 * i]), odd = static_cast<uint32_t>(a[2 * i + 1]);
+                const int32_t a0 = static_cast<int16_t>(even), a2 = static_cast<int16_t>(even >> 16);
+                const int32_t a1 = static_cast<int16_t>(odd), a3 = static_cast<int16_t>(odd >> 16);
+                for (size_t j = 0; j < NR; j++) {
+                    const int8_t* bj = b + 4 * j;
+                    acc[i][j] += a0 * bj[0] + a1 * bj[1] + a2 * bj[2] + a3 * bj[3];
+                }
+            }
+        }
+        std::memcpy(tile, acc, sizeof(acc));
+    }
+
+#if NEXT_SIMD_X86
+    // 4 x 16 int32 in 8 ymm accumulators. vpmaddwd on the sign-extended even and odd bytes of B is exact,
+    // unlike vpmaddubsw, which saturates its int16 pair sums.
+    NEXT_TARGET_AVX2 inline void MicroKernelInt8Avx2(size_t groups, const int32_t* a, const int8_t* b, int32_t* tile) {
+        __m256i c[4][2];
+        for (auto& row : c) {
+            row[0] = _mm256_setzero_si256();
+            row[1] = _mm256_setzero_si256();
+        }
+        for (size_t g = 0; g < groups; g++, a += 8, b += 64) {
+            const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+            const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 32));
+            const __m256i b0Even = _mm256_srai_epi16(_mm256_slli_epi16(b0, 8), 8);
+            const __m256i b0Odd = _mm256_srai_epi16(b0, 8);
+            const __m256i b1Even = _mm256_srai_epi16(_mm256_slli_epi16(b1, 8), 8);
+            const __m256i b1Odd = _mm256_srai_epi16(b1, 8);
+            for (size_t i = 0; i < 4; i++) {
+                const __m256i aEven = _mm256_set1_epi32(a[2 * i]);
+                const __m256i aOdd = _mm256_set1_epi32(a[2 * i + 1]);
+                c[i][0] = _mm256_add_epi32(c[i][0], _mm256_add_epi32(_mm256_madd_epi16(aEven, b0Even),
+                                                                     _mm256_madd_epi16(aOdd, b0Odd)));
+                c[i][1] = _mm256_add_epi32(c[i][1], _mm256_add_epi32(_mm256_madd_epi16(aEven, b1Even),
+                                                                     _mm256_madd_epi16(aOdd, b1Odd)));
+            }
+        }
+        for (size_t i = 0; i < 4; i++) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(tile + i * 16), c[i][0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(tile + i * 16 + 8), c[i][1]);
+        }
+    }
+
+    // 4 x 16 int32 in 4 zmm accumulators, one vpdpbusd (64 multiply-adds) per row and group
+    __attribute__((target("avx512f,avx512vnni")))
+    inline void MicroKernelInt8Vnni(size_t groups, const int32_t* a, const int8_t* b, int32_t* tile) {
+        __m512i c[4] = {_mm512_setzero_si512(), _mm512_setzero_si512(), _mm512_setzero_si512(), _mm512_setzero_si512()};
+        for (size_t g = 0; g < groups; g++, a += 4, b += 64) {
+            const __m512i vb = _mm512_loadu_si512(b);
+            for (size_t i = 0; i < 4; i++) {
+                c[i] = _mm512_dpbusd_epi32(c[i], _mm512_set1_epi32(a[i]), vb);
+            }
+        }
+        for (size_t i = 0; i < 4; i++) {
+            _mm512_storeu_si512(tile + i * 16, c[i]);
+        }
+    }
+#endif
+
+    /**
+     *  @brief Micro-kernel for the running CPU: AVX-512 VNNI, AVX2 vpmaddwd or portable loops
+     * **/
+    inline Int8MicroKernel SelectInt8MicroKernel() {
+#if NEXT_SIMD_X86
+        static const bool hasVnni = __builtin_cpu_supports("avx512vnni");
+        if (hasVnni && Simd::GetISA() >= Simd::ISA::AVX512) return {&MicroKernelInt8Vnni, true};
+        if (Simd::GetISA() >= Simd::ISA::AVX2) return {&MicroKernelInt8Avx2, false};
+#endif
+        return {&MicroKernelInt8Generic, false};
+    }
+
+    /**
+     *  @brief Pack an mc x kc block of A into MR-row slivers in the layout of the selected micro-kernel
+     * **/
+    inline void PackInt8A(const Gemm::MatrixRef<const int8_t>& a, size_t mc, size_t kc, bool vnni, int32_t* dst) {
+        constexpr size_t MR = Int8Config::MR;
+        const size_t groups = (kc + 3) / 4;
+        for (size_t ir = 0; ir < mc; ir += MR) {
+            const size_t mr = std::min(MR, mc - ir);
+            for (size_t g = 0; g < groups; g++) {
+                for (size_t i = 0; i < MR; i++) {
+                    int32_t v[4] = {};
+                    if (i < mr) {
+                        const int8_t* src = a.Data + (ir + i) * a.RowStride + 4 * g * a.ColStride;
+                        for (size_t t = 0; t < 4 && 4 * g + t < kc; t++) v[t] = src[t * a.ColStride];
+                    }
+                    if (vnni) {
+                        uint32_t word = 0;
+                        for (size_t t = 0; t < 4; t++) word |= static_cast<uint32_t>(v[t] + 128) << (8 * t);
+                        *dst++ = static_cast<int32_t>(word);
+                    } else {
+                        *dst++ = static_cast<int32_t>((static_cast<uint32_t>(v[0]) & 0xFFFF) | static_cast<uint32_t>(v[2]) << 16);
+                        *dst++ = static_cast<int32_t>((static_cast<uint32_t>(v[1]) & 0xFFFF) | static_cast<uint32_t>(v[3]) << 16);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     *  @brief Pack a kc x nc panel of B into NR-column slivers, four consecutive k of a column per word
+     * **/
+    inline void PackInt8B(const Gemm::MatrixRef<const int8_t>& b, size_t kc, size_t nc, int8_t* dst) {
+        constexpr size_t NR = Int8Config::NR;
+        const size_t groups = (kc + 3) / 4;
+        for (size_t jr = 0; jr < nc; jr += NR) {
+            const size_t nr = std::min(NR, nc - jr);
+            for (size_t g = 0; g < groups; g++) {
+                std::fill(dst, dst + 4 * NR, int8_t{0});
+                for (size_t t = 0; t < 4 && 4 * g + t < kc; t++) {
+                    const int8_t* src = b.Data + (4 * g + t) * b.RowStride + jr * b.ColStride;
+                    for (size_t j = 0; j < nr; j++) dst[4 * j + t] = src[j * b.ColStride];
+                }
+                dst += 4 * NR;
+            }
+        }
+    }
+
+    struct ColumnBias;
+
+    /**
+     *  @brief C (m x n) = A (m x k) * B (k x n) for int8 A and B, accumulated exactly in int32
+     *
+     *  Same blocking and threading as Gemm::Gemm. The VNNI kernel multiplies A + 128; the 128 * column
+     *  sums of B this adds are taken off when the first K block is stored.
+     * **/
+    inline void GemmInt8(size_t m, size_t n, size_t k, Gemm::MatrixRef<const int8_t> a,
+                         Gemm::MatrixRef<const int8_t> b, Gemm::MatrixRef<int32_t> c, bool parallel = true) {
+        using Cfg = Int8Config;
+        if (m == 0 || n == 0) return;
+        if (k == 0) {
+            for (size_t i = 0; i < m; i++) {
+                for (size_t j = 0; j < n; j++) c.Data[i * c.RowStride + j * c.ColStride] = 0;
+            }
+            return;
+        }
+
+        const auto kernel = SelectInt8MicroKernel();
+        int32_t* bias = nullptr;
+        if (kernel.Vnni) {
+            bias = Next::ThreadScratch<ColumnBias, int32_t>(n);
+            std::fill(bias, bias + n, 0);
+            for (size_t p = 0; p < k; p++) {
+                const int8_t* row = b.Data + p * b.RowStride;
+                for (size_t j = 0; j < n; j++) bias[j] += 128 * row[j * b.ColStride];
+            }
+        }
+        const size_t aWords = kernel.Vnni ? 1 : 2;
+        const size_t maxGroups = (std::min(k, Cfg::KC) + 3) / 4;
+        int8_t* bPack = Next::ThreadScratch<Gemm::PackedB, int8_t>(
+            4 * maxGroups * ((std::min(n, Cfg::NC) + Cfg::NR - 1) / Cfg::NR * Cfg::NR));
+        const size_t mBlocks = (m + Cfg::MC - 1) / Cfg::MC;
+        const size_t grain = parallel ? std::max<size_t>(1, (size_t{1} << 20) / (Cfg::MC * n * k + 1)) : mBlocks;
+
+        for (size_t jc = 0; jc < n; jc += Cfg::NC) {
+            const size_t nc = std::min(Cfg::NC, n - jc);
+            for (size_t pc = 0; pc < k; pc += Cfg::KC) {
+                const size_t kc = std::min(Cfg::KC, k - pc);
+                const size_t groups = (kc + 3) / 4;
+                PackInt8B({b.Data + pc * b.RowStride + jc * b.ColStride, b.RowStride, b.ColStride}, kc, nc, bPack);
+
+                Next::ParallelFor(0, mBlocks, grain, [&](size_t blockBegin, size_t blockEnd) {
+                    int32_t* aPack = Next::ThreadScratch<Gemm::PackedA, int32_t>(Cfg::MC * groups * aWords);
+                    int32_t tile[Cfg::MR * Cfg::NR];
+                    for (size_t block = blockBegin; block < blockEnd; block++) {
+                        const size_t ic = block * Cfg::MC;
+                        const size_t mc = std::min(Cfg::MC, m - ic);
+                        PackInt8A({a.Data + ic * a.RowStride + pc * a.ColStride, a.RowStride, a.ColStride}, mc, kc,
+                                  kernel.Vnni, aPack);
+
+                        for (size_t jr = 0; jr < nc; jr += Cfg::NR) {
+                            const size_t nr = std::min(Cfg::NR, nc - jr);
+                            for (size_t ir = 0; ir < mc; ir += Cfg::MR) {
+                                const size_t mr = std::min(Cfg::MR, mc - ir);
+                                kernel.Fn(groups, aPack + ir * groups * aWords, bPack + 4 * jr * groups, tile);
+
+                                int32_t* dst = c.Data + (ic + ir) * c.RowStride + (jc + jr) * c.ColStride;
+                                for (size_t i = 0; i < mr; i++) {
+                                    int32_t* row = dst + i * c.RowStride;
+                                    const int32_t* t = tile + i * Cfg::NR;
+                                    if (pc != 0) {
+                                        for (size_t j = 0; j < nr; j++) row[j * c.ColStride] += t[j];
+                                    } else if (kernel.Vnni) {
+                                        for (size_t j = 0; j < nr; j++) row[j * c.ColStride] = t[j] - bias[jc + jr + j];
+                                    } else {
+                                        for (size_t j = 0; j < nr; j++) row[j * c.ColStride] = t[j];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                });
+            }
+        }
+    }
+}
@@ -0,0 +1,372 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "Half.h"
+#include "NextUtils.h"
+#include "StridedIterator.h"
+#include "ThreadPool.h"
+
+namespace Next::Reduce {
+    enum class Kind {
+        SUM,
+        PROD,
+        MAX,
+        MIN
+    };
+
+    constexpr const char* OpName(Kind kind) {
+        constexpr const char* names[] = {"sum", "prod", "max", "min"};
+        return names[static_cast<size_t>(kind)];
+    }
+
+    template<Kind K, typename T>
+    constexpr T Identity() {
+        if constexpr (K == Kind::SUM) return T{0};
+        else if constexpr (K == Kind::PROD) return T{1};
+        else if constexpr (K == Kind::MAX) {
+            if constexpr (std::numeric_limits<T>::has_infinity) return -std::numeric_limits<T>::infinity();
+            else return std::numeric_limits<T>::lowest();
+        } else {
+            if constexpr (std::numeric_limits<T>::has_infinity) return std::numeric_limits<T>::infinity();
+            else return std::numeric_limits<T>::max();
+        }
+    }
+
+    template<Kind K, typename T>
+    T Combine(const T& a, const T& b) {
+        if constexpr (K == Kind::SUM) return static_cast<T>(a + b);
+        else if constexpr (K == Kind::PROD) return static_cast<T>(a * b);
+        else if constexpr (K == Kind::MAX) return b > a ? b : a;
+        else return b < a ? b : a;
+    }
+
+    // Float sums use Kahan compensation between rows and pairwise summation inside a row
+    template<Kind K, typename T>
+    inline constexpr bool Compensated = K == Kind::SUM && std::is_floating_point_v<T>;
+
+    template<typename T>
+    void KahanAdd(T& sum, T& compensation, const T& value) {
+        const T y = value - compensation;
+        const T t = sum + y;
+        compensation = (t - sum) - y;
+        sum = t;
+    }
+
+    /**
+     *  @brief KahanAdd over contiguous rows; the buffers never alias, which lets the loop vectorize
+     * **/
+    template<typename T>
+    void AccumulateCompensated(T* __restrict sums, T* __restrict compensation, const T* __restrict values, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            KahanAdd(sums[i], compensation[i], values[i]);
+        }
+    }
+
+    /**
+     *  @brief Reduce n elements spaced step apart
+     *
+     *  Eight independent lanes let the loop vectorize without reassociating a single accumulator. Float sums
+     *  split rows longer than 128 elements in halves recursively, which keeps the rounding error at O(log n).
+     * **/
+    template<Kind K, typename T>
+    T ReduceRow(const T* p, size_t n, size_t step) {
+        constexpr size_t Lanes = 8;
+        if constexpr (Compensated<K, T>) {
+            if (n > 128) {
+                const size_t half = n / 2 / Lanes * Lanes;
+                return ReduceRow<K>(p, half, step) + ReduceRow<K>(p + half * step, n - half, step);
+            }
+        }
+
+        T lanes[Lanes];
+        for (auto& lane : lanes) {
+            lane = Identity<K, T>();
+        }
+        size_t i = 0;
+        if (step == 1) {
+            for (; i + Lanes <= n; i += Lanes) {
+                for (size_t l = 0; l < Lanes; l++) {
+                    lanes[l] = Combine<K>(lanes[l], p[i + l]);
+                }
+            }
+        } else {
+            for (; i + Lanes <= n; i += Lanes) {
+                for (size_t l = 0; l < Lanes; l++) {
+                    lanes[l] = Combine<K>(lanes[l], p[(i + l) * step]);
+                }
+            }
+        }
+        T acc = Combine<K>(Combine<K>(Combine<K>(lanes[0], lanes[1]), Combine<K>(lanes[2], lanes[3])),
+                           Combine<K>(Combine<K>(lanes[4], lanes[5]), Combine<K>(lanes[6], lanes[7])));
+        for (; i < n; i++) {
+            acc = Combine<K>(acc, p[i * step]);
+        }
+        return acc;
+    }
+
+    /**
+     *  @brief Accumulate count elements of a, step apart, into o (step oStep, zero when they reduce to one
+     *  value) and its compensation terms c
+     * **/
+    template<Kind K, typename T>
+    void AccumulateRow(const T* a, size_t step, T* o, T* c, size_t oStep, size_t count) {
+        if (oStep == 0) {
+            const T value = ReduceRow<K>(a, count, step);
+            if constexpr (Compensated<K, T>) KahanAdd(*o, *c, value);
+            else *o = Combine<K>(*o, value);
+            return;
+        }
+
+        if constexpr (Compensated<K, T>) {
+            if (step == 1 && oStep == 1) {
+                AccumulateCompensated(o, c, a, count);
+                return;
+            }
+            for (size_t i = 0; i < count; i++) {
+                KahanAdd(o[i * oStep], c[i * oStep], a[i * step]);
+            }
+        } else if (step == 1 && oStep == 1) {
+            for (size_t i = 0; i < count; i++) {
+                o[i] = Combine<K>(o[i], a[i]);
+            }
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                o[i * oStep] = Combine<K>(o[i * oStep], a[i * step]);
+            }
+        }
+    }
+
+    /**
+     *  @brief Accumulate in (shape / strides / offset) into out, whose strides are zero on reduced dimensions
+     *
+     *  The input drives the visit order, so it is read in memory order whichever axes are reduced: a reduced
+     *  inner dimension becomes ReduceRow, a kept inner dimension becomes an element-wise accumulate. An input
+     *  of another type than the accumulator Acc (16-bit floats summed in float) is converted a block of each
+     *  row at a time.
+     * **/
+    template<Kind K, typename T, typename Acc>
+    void ReduceSerial(const T* in, const Dims& shape, const Dims& strides, size_t offset,
+                      Acc* out, Acc* compensation, const Dims& outStrides, size_t outOffset) {
+        Next::ForEachStrided<2>(shape, {&strides, &outStrides}, {offset, outOffset},
+            [&](const std::array<size_t, 2>& offsets, const std::array<size_t, 2>& steps, size_t count) {
+                Acc* c = Compensated<K, Acc> ? compensation + offsets[1] : nullptr;
+                if constexpr (std::is_same_v<T, Acc>) {
+                    AccumulateRow<K>(in + offsets[0], steps[0], out + offsets[1], c, steps[1], count);
+                } else {
+                    constexpr size_t Block = 256;
+                    Acc buffer[Block];
+                    for (size_t i = 0; i < count; i += Block) {
+                        const size_t n = std::min(Block, count - i);
+                        Simd::ConvertRow(in + offsets[0] + i * steps[0], steps[0], buffer, 1, n);
+                        AccumulateRow<K>(buffer, 1, out + offsets[1] + i * steps[1], c ? c + i * steps[1] : c,
+                                         steps[1], n);
+                    }
+                }
+            });
+    }
+
+    // Tags of the per-thread scratch buffers (see ThreadScratch)
+    struct CompensationTerms;
+    struct BestValues;
+
+    /**
+     *  @brief Shape with the reduced dimensions set to one
+     * **/
+    inline Dims KeepDimShape(const Dims& shape, const AxisMask& reduced) {
+        auto result = shape;
+        for (size_t d = 0; d < shape.size(); d++) {
+            if (reduced[d]) result[d] = 1;
+        }
+        return result;
+    }
+
+    /**
+     *  @brief Strides of a contiguous keepdim-shaped output, zeroed on reduced dimensions
+     * **/
+    inline Dims OutputStrides(const Dims& shape, const AxisMask& reduced) {
+        auto result = Next::ComputeStrides(KeepDimShape(shape, reduced));
+        for (size_t d = 0; d < shape.size(); d++) {
+            if (reduced[d]) result[d] = 0;
+        }
+        return result;
+    }
+
+    /**
+     *  @brief Reduce the flagged dimensions of in into out, a contiguous buffer of the keepdim shape
+     *
+     *  Work is split across the thread pool along the largest kept dimension; when no kept dimension is large
+     *  enough (e.g. a full reduction) the largest reduced dimension is split into partial results instead.
+     *  Results are accumulated in Acc, the element type unless the caller widens it.
+     * **/
+    template<Kind K, typename T, typename Acc = T>
+    void ReduceInto(const T* in, const Dims& shape, const Dims& strides, size_t offset,
+                    const AxisMask& reduced, Acc* out) {
+        const auto outStrides = OutputStrides(shape, reduced);
+        const size_t outSize = Next::ComputeSize(KeepDimShape(shape, reduced));
+        const size_t total = Next::ComputeSize(shape);
+        std::fill(out, out + outSize, Identity<K, Acc>());
+        Acc* compensation = nullptr;
+        if constexpr (Compensated<K, Acc>) {
+            compensation = Next::ThreadScratch<CompensationTerms, Acc>(outSize);
+            std::fill(compensation, compensation + outSize, Acc{});
+        }
+        if (total == 0) return;
+
+        size_t keptDim = shape.size(), reducedDim = shape.size();
+        for (size_t d = 0; d < shape.size(); d++) {
+            size_t& best = reduced[d] ? reducedDim : keptDim;
+            if (shape[d] > 1 && (best == shape.size() || shape[d] > shape[best])) best = d;
+        }
+
+        const size_t threads = Next::GetNumThreads();
+        if (threads > 1 && total >= 2 * Next::DefaultGrainSize) {
+            if (keptDim < shape.size() && shape[keptDim] >= threads) {
+                const size_t perIndex = total / shape[keptDim];
+                const size_t grain = (Next::DefaultGrainSize + perIndex - 1) / perIndex;
+                Next::ParallelFor(0, shape[keptDim], grain, [&](size_t begin, size_t end) {
+                    auto sub = shape;
+                    sub[keptDim] = end - begin;
+                    ReduceSerial<K>(in, sub, strides, offset + begin * strides[keptDim],
+                                    out, compensation, outStrides, begin * outStrides[keptDim]);
+                });
+                return;
+            }
+
+            if (reducedDim < shape.size()) {
+                const size_t extent = shape[reducedDim];
+                const size_t chunks = std::min({threads, extent, total / Next::DefaultGrainSize});
+                if (chunks >= 2) {
+                    // Chunk 0 accumulates into out, the others into partial buffers merged in chunk order
+                    auto partials = Next::MakeScratch<Acc>((chunks - 1) * outSize, Identity<K, Acc>());
+                    auto partialCompensation = Next::MakeScratch<Acc>(Compensated<K, Acc> ? (chunks - 1) * outSize : 0);
+                    Next::ParallelFor(0, chunks, 1, [&](size_t chunkBegin, size_t chunkEnd) {
+                        for (size_t c = chunkBegin; c < chunkEnd; c++) {
+                            const size_t begin = extent * c / chunks;
+                            auto sub = shape;
+                            sub[reducedDim] = extent * (c + 1) / chunks - begin;
+                            Acc* target = c == 0 ? out : partials.get() + (c - 1) * outSize;
+                            Acc* comp = c == 0 ? compensation
+                                               : Compensated<K, Acc> ? partialCompensation.get() + (c - 1) * outSize : nullptr;
+                            ReduceSerial<K>(in, sub, strides, offset + begin * strides[reducedDim],
+                                            target, comp, outStrides, 0);
+                        }
+                    });
+                    for (size_t c = 1; c < chunks; c++) {
+                        const Acc* partial = partials.get() + (c - 1) * outSize;
+                        for (size_t i = 0; i < outSize; i++) {
+                            if constexpr (Compensated<K, Acc>) KahanAdd(out[i], compensation[i], partial[i]);
+                            else out[i] = Combine<K>(out[i], partial[i]);
+                        }
+                    }
+                    return;
+                }
+            }
+        }
+
+        ReduceSerial<K>(in, shape, strides, offset, out, compensation, outStrides, 0);
+    }
+
+    /**
+     *  @brief Index (along axis) of the first maximum (IsMax) or minimum of in, written to a keepdim-shaped buffer
+     *
+     *  When the axis is the innermost dimension in memory every output scans its own row; otherwise the axis
+     *  is walked slice by slice and each slice updates all running best values in memory order.
+     * **/
+    template<bool IsMax, typename T>
+    void ArgReduceInto(const T* in, const Dims& shape, const Dims& strides,
+                       size_t offset, size_t axis, int64_t* out) {
+        const size_t n = shape[axis];
+        if (n == 0) {
+            throw std::runtime_error("Reduction error: cannot take argmax/argmin of an empty dimension");
+        }
+        AxisMask reduced(shape.size(), false);
+        reduced[axis] = true;
+        auto outer = KeepDimShape(shape, reduced);
+        const auto outStrides = OutputStrides(shape, reduced);
+        const size_t outSize = Next::ComputeSize(outer);
+        if (outSize == 0) return;
+
+        auto better = [](const T& candidate, const T& best) {
+            if constexpr (IsMax) return candidate > best;
+            else return candidate < best;
+        };
+
+        bool axisInnermost = true;
+        for (size_t d = 0; d < shape.size(); d++) {
+            if (d != axis && shape[d] > 1 && strides[d] < strides[axis]) axisInnermost = false;
+        }
+
+        auto runSerial = [&](const Dims& sub, size_t inOffset, size_t outOffset) {
+            if (axisInnermost) {
+                const size_t axisStride = strides[axis];
+                Next::ForEachStrided<2>(sub, {&strides, &outStrides}, {inOffset, outOffset},
+                    [&](const std::array<size_t, 2>& offsets, const std::array<size_t, 2>& steps, size_t count) {
+                        for (size_t i = 0; i < count; i++) {
+                            const T* row = in + offsets[0] + i * steps[0];
+                            T best = row[0];
+                            int64_t bestIndex = 0;
+                            for (size_t k = 1; k < n; k++) {
+                                if (better(row[k * axisStride], best)) {
+                                    best = row[k * axisStride];
+                                    bestIndex = static_cast<int64_t>(k);
+                                }
+                            }
+                            out[offsets[1] + i * steps[1]] = bestIndex;
+                        }
+                    });
+                return;
+            }
+
+            T* bestValues = Next::ThreadScratch<BestValues, T>(outSize);
+            for (size_t k = 0; k < n; k++) {
+                Next::ForEachStrided<2>(sub, {&strides, &outStrides}, {inOffset + k * strides[axis], outOffset},
+                    [&](const std::array<size_t, 2>& offsets, const std::array<size_t, 2>& steps, size_t count) {
+                        const T* a = in + offsets[0];
+                        T* values = bestValues + offsets[1];
+                        int64_t* indices = out + offsets[1];
+                        const auto index = static_cast<int64_t>(k);
+                        if (k == 0) {
+                            for (size_t i = 0; i < count; i++) {
+                                values[i * steps[1]] = a[i * steps[0]];
+                                indices[i * steps[1]] = 0;
+                            }
+                            return;
+                        }
+                        // Branch-free select so the update of a whole slice row vectorizes
+                        for (size_t i = 0; i < count; i++) {
+                            const T v = a[i * steps[0]];
+                            const bool take = better(v, values[i * steps[1]]);
+                            values[i * steps[1]] = take ? v : values[i * steps[1]];
+                            indices[i * steps[1]] = take ? index : indices[i * steps[1]];
+                        }
+                    });
+            }
+        };
+
+        size_t keptDim = shape.size();
+        for (size_t d = 0; d < shape.size(); d++) {
+            if (d != axis && shape[d] > 1 && (keptDim == shape.size() || shape[d] > shape[keptDim])) keptDim = d;
+        }
+        const size_t total = Next::ComputeSize(shape);
+        if (keptDim < shape.size() && total >= 2 * Next::DefaultGrainSize) {
+            const size_t perIndex = total / shape[keptDim];
+            const size_t grain = (Next::DefaultGrainSize + perIndex - 1) / perIndex;
+            Next::ParallelFor(0, outer[keptDim], grain, [&](size_t begin, size_t end) {
+                auto sub = outer;
+                sub[keptDim] = end - begin;
+                runSerial(sub, offset + begin * strides[keptDim], begin * outStrides[keptDim]);
+            });
+            return;
+        }
+        runSerial(outer, offset, 0);
+    }
+}
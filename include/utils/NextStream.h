@@ -0,0 +1,332 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "NextFile.h"
+
+namespace Next {
+    // Streaming access to tensor files (see NextFile.h for the layout) one chunk of the leading dimension at
+    // a time, for data that does not fit in memory. Each reader and writer owns one background thread that
+    // does all of its file I/O, so reading the next chunk or writing the previous one overlaps whatever the
+    // caller computes on the current one:
+    //
+    //   TensorReader<float> reader{"features.nxt", 4096};
+    //   while (auto chunk = reader.Next()) {
+    //       total += chunk->Values.sum().Data()[0];
+    //   }
+
+    //*
+    //@brief Rows [Begin, End) of the leading dimension of a streamed tensor.
+    //*/
+    template<typename T>
+    struct TensorChunk {
+        size_t Begin;
+        size_t End;
+        NextTensor<T> Values;   // Shape and strides of file.slice(0, Begin, End), in storage of its own
+    };
+
+    //*
+    //@brief Reads a tensor file chunk by chunk, readAhead chunks ahead of the caller.
+    //
+    // A chunk owns its storage, so it stays valid (and writable without a copy) for as long as the caller
+    // keeps it; memory stays bounded by the chunks the caller holds plus readAhead. The file's own strides are
+    // kept, which bounds a chunk to its rows as long as the leading dimension has the largest stride (true
+    // for every file written by SaveTensor or TensorWriter).
+    //*/
+    template<typename T>
+    class TensorReader {
+    private:
+        std::string m_Path;
+        Detail::FileLayout m_Layout;
+        size_t m_ChunkRows;
+        size_t m_ReadAhead;
+        size_t m_ChunkCount;
+        size_t m_Handed{0};     // Chunks returned by Next, only touched by the caller
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::deque<TensorChunk<T>> m_Ready;
+        bool m_Stop{false};
+        std::exception_ptr m_Error;
+        std::thread m_Thread;   // Does all reads of the file, joined by the destructor
+
+        TensorChunk<T> ReadChunk(std::ifstream& file, size_t index) const {
+            const auto& strides = m_Layout.m_Strides;
+            const size_t rows = m_Layout.m_Shape[0];
+            const size_t begin = index * m_ChunkRows;
+            const size_t end = std::min(rows, begin + m_ChunkRows);
+            auto shape = m_Layout.m_Shape;
+            shape[0] = end - begin;
+
+            // Elements from the first one of row begin up to the last one of row end - 1
+            size_t span = 0;
+            if (Next::ComputeSize(shape) > 0) {
+                span = 1;
+                for (size_t d = 0; d < shape.size(); d++) {
+                    span += (shape[d] - 1) * strides[d];
+                }
+            }
+            const size_t first = m_Layout.m_Header.Offset + begin * strides[0];
+            auto storage = Next::AllocateStorage<T>(span, false);
+            file.seekg(static_cast<std::streamoff>(m_Layout.m_Header.DataOffset + first * sizeof(T)));
+            file.read(reinterpret_cast<char*>(storage.get()), static_cast<std::streamsize>(span * sizeof(T)));
+            if (!file) {
+                throw std::runtime_error("File error: failed reading rows " + std::to_string(begin) + " to " +
+                                         std::to_string(end) + " of '" + m_Path + "'");
+            }
+            return {begin, end, NextTensor<T>{std::move(storage),
+                                              NextMetadata{shape, strides, Next::TypeToDType<T>::value, 0}}};
+        }
+
+        void IoLoop() {
+            try {
+                std::ifstream file(m_Path, std::ios::binary);
+                if (!file) {
+                    throw std::runtime_error("File error: cannot open '" + m_Path + "'");
+                }
+                for (size_t index = 0; index < m_ChunkCount; index++) {
+                    {
+                        std::unique_lock lock{m_Mutex};
+                        m_Condition.wait(lock, [this] { return m_Stop || m_Ready.size() < m_ReadAhead; });
+                        if (m_Stop) return;
+                    }
+                    auto chunk = ReadChunk(file, index);
+                    {
+                        std::lock_guard lock{m_Mutex};
+                        m_Ready.push_back(std::move(chunk));
+                    }
+                    m_Condition.notify_all();
+                }
+            } catch (...) {
+                {
+                    std::lock_guard lock{m_Mutex};
+                    m_Error = std::current_exception();
+                }
+                m_Condition.notify_all();
+            }
+        }
+
+    public:
+        /**
+         *  @brief Stream path in chunks of chunkRows rows (the last one may be shorter)
+         *
+         *  The header is read and checked here; the first chunk is read right away in the background.
+         * **/
+        TensorReader(const std::string& path, size_t chunkRows, size_t readAhead = 1)
+            : m_Path(path), m_ChunkRows(chunkRows), m_ReadAhead(std::max<size_t>(readAhead, 1)) {
+            Detail::CheckLittleEndian();
+            {
+                std::ifstream file(path, std::ios::binary);
+                if (!file) {
+                    throw std::runtime_error("File error: cannot open '" + path + "'");
+                }
+                m_Layout = Detail::ReadFileLayout<T>(file, path);
+            }
+            if (m_Layout.m_Shape.empty()) {
+                throw std::runtime_error("File error: '" + path + "' holds a scalar, there is no dimension to stream");
+            }
+            if (chunkRows == 0) {
+                throw std::runtime_error("File error: chunks need at least one row");
+            }
+            m_ChunkCount = (m_Layout.m_Shape[0] + chunkRows - 1) / chunkRows;
+            m_Thread = std::thread([this] { IoLoop(); });
+        }
+
+        TensorReader(const TensorReader&) = delete;
+        TensorReader& operator=(const TensorReader&) = delete;
+
+        ~TensorReader() {
+            {
+                std::lock_guard lock{m_Mutex};
+                m_Stop = true;
+            }
+            m_Condition.notify_all();
+            m_Thread.join();
+        }
+
+        /**
+         *  @brief Shape of the whole tensor in the file
+         * **/
+        [[nodiscard]] const Dims& Shape() const { return m_Layout.m_Shape; }
+
+        [[nodiscard]] size_t ChunkRows() const { return m_ChunkRows; }
+
+        [[nodiscard]] size_t ChunkCount() const { return m_ChunkCount; }
+
+        /**
+         *  @brief The next chunk in file order, waiting for the I/O thread if it is not read yet; empty after
+         *  the last one. Read errors are rethrown here.
+         * **/
+        std::optional<TensorChunk<T>> Next() {
+            if (m_Handed == m_ChunkCount) return std::nullopt;
+            std::unique_lock lock{m_Mutex};
+            m_Condition.wait(lock, [this] { return !m_Ready.empty() || m_Error; });
+            if (m_Ready.empty()) {
+                std::rethrow_exception(m_Error);
+            }
+            auto chunk = std::move(m_Ready.front());
+            m_Ready.pop_front();
+            m_Handed++;
+            lock.unlock();
+            m_Condition.notify_all();
+            return chunk;
+        }
+    };
+
+    //*
+    //@brief Writes a tensor file chunk by chunk along the leading dimension, whose length is only known once
+    // the writer is closed.
+    //
+    // Write queues the chunk and returns while the I/O thread writes it; at most queueDepth chunks wait. The
+    // writer keeps a copy-on-write copy of each queued chunk, so the caller may reuse or overwrite its tensor
+    // right away (a write while the chunk is still queued clones it instead of changing the file).
+    //*/
+    template<typename T>
+    class TensorWriter {
+    private:
+        std::string m_Path;
+        Dims m_RowShape;
+        size_t m_Alignment;
+        size_t m_QueueDepth;
+        size_t m_Rows{0};       // Rows passed to Write so far
+        bool m_Closed{false};
+        std::ofstream m_File;   // Used by the I/O thread until it has been joined
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::deque<NextTensor<T>> m_Pending;
+        bool m_Closing{false};
+        std::exception_ptr m_Error;
+        std::thread m_Thread;
+
+        void IoLoop() {
+            try {
+                while (true) {
+                    std::unique_lock lock{m_Mutex};
+                    m_Condition.wait(lock, [this] { return m_Closing || !m_Pending.empty(); });
+                    if (m_Pending.empty()) return;
+                    const NextTensor<T> chunk = std::move(m_Pending.front());
+                    m_Pending.pop_front();
+                    lock.unlock();
+                    m_Condition.notify_all();
+                    m_File.write(reinterpret_cast<const char*>(chunk.Data() + chunk.Offset()),
+                                 static_cast<std::streamsize>(chunk.Size() * sizeof(T)));
+                    if (!m_File) {
+                        throw std::runtime_error("File error: failed writing '" + m_Path + "'");
+                    }
+                }
+            } catch (...) {
+                {
+                    std::lock_guard lock{m_Mutex};
+                    m_Error = std::current_exception();
+                    m_Pending.clear();
+                }
+                m_Condition.notify_all();
+            }
+        }
+
+        [[nodiscard]] Dims FileShape() const {
+            Dims shape{m_Rows};
+            for (const size_t dim : m_RowShape) {
+                shape.push_back(dim);
+            }
+            return shape;
+        }
+
+    public:
+        /**
+         *  @brief Create path for a tensor of shape {rows, rowShape...}; rows grows with every Write
+         * **/
+        TensorWriter(const std::string& path, const Dims& rowShape, size_t queueDepth = 1,
+                     size_t alignment = StorageAlignment)
+            : m_Path(path), m_RowShape(rowShape), m_Alignment(alignment), m_QueueDepth(std::max<size_t>(queueDepth, 1)) {
+            Detail::CheckLittleEndian();
+            if (alignment < alignof(T)) {
+                throw std::runtime_error("File error: alignment must be a power of two of at least alignof(T)");
+            }
+            m_File.open(path, std::ios::binary | std::ios::trunc);
+            if (!m_File) {
+                throw std::runtime_error("File error: cannot open '" + path + "' for writing");
+            }
+            // Written again by Close with the final row count; the data offset does not depend on it
+            Detail::WriteFileHeader(m_File, Next::TypeToDType<T>::value, FileShape(), sizeof(T), m_Alignment);
+            m_Thread = std::thread([this] { IoLoop(); });
+        }
+
+        TensorWriter(const TensorWriter&) = delete;
+        TensorWriter& operator=(const TensorWriter&) = delete;
+
+        /**
+         *  @brief Closes the file if Close was not called; errors are lost here, call Close to see them
+         * **/
+        ~TensorWriter() {
+            try {
+                Close();
+            } catch (...) {
+            }
+        }
+
+        [[nodiscard]] size_t Rows() const { return m_Rows; }
+
+        /**
+         *  @brief Append chunk, of shape {n, rowShape...}, as the next n rows
+         * **/
+        void Write(const NextTensor<T>& chunk) {
+            if (m_Closed) {
+                throw std::runtime_error("File error: '" + m_Path + "' is already closed");
+            }
+            if (chunk.Rank() != m_RowShape.size() + 1 ||
+                !std::equal(m_RowShape.begin(), m_RowShape.end(), chunk.Shape().begin() + 1)) {
+                throw std::runtime_error("File error: chunk of shape " + ShapeToString(chunk.Shape()) +
+                                         " does not have rows of shape " + ShapeToString(m_RowShape));
+            }
+            const auto compact = chunk.contiguous();
+            std::unique_lock lock{m_Mutex};
+            m_Condition.wait(lock, [this] { return m_Pending.size() < m_QueueDepth || m_Error; });
+            if (m_Error) {
+                std::rethrow_exception(m_Error);
+            }
+            // A copy, not the view itself: its own storage cell makes a later write by the caller clone
+            m_Pending.push_back(compact);
+            m_Rows += chunk.Shape()[0];
+            lock.unlock();
+            m_Condition.notify_all();
+        }
+
+        /**
+         *  @brief Wait for the queued chunks, record the final row count in the header and close the file
+         * **/
+        void Close() {
+            if (m_Closed) return;
+            m_Closed = true;
+            {
+                std::lock_guard lock{m_Mutex};
+                m_Closing = true;
+            }
+            m_Condition.notify_all();
+            m_Thread.join();
+            if (m_Error) {
+                std::rethrow_exception(m_Error);
+            }
+            m_File.seekp(0);
+            Detail::WriteFileHeader(m_File, Next::TypeToDType<T>::value, FileShape(), sizeof(T), m_Alignment);
+            m_File.close();
+            if (!m_File) {
+                throw std::runtime_error("File error: failed writing '" + m_Path + "'");
+            }
+        }
+    };
+}
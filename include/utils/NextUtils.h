@@ -3,20 +3,27 @@
 //
 
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <vector>
 #include <stdexcept>
 #include "DType.h"
+#include "Half.h"
+#include "SmallVector.h"
 
 namespace Next {
-    [[nodiscard]] inline  std::vector<size_t> ComputeStrides(const std::vector<size_t>& strides) {
-        std::vector<size_t> result(strides.size(), 1);
-        for (size_t i = 0; i < strides.size(); i++) {
-            result[i] = result[i] * strides[i];
+    [[nodiscard]] inline  Dims ComputeStrides(const Dims& shape) {
+        Dims result(shape.size(), 1);
+        for (int i = static_cast<int>(shape.size()) - 2; i >= 0; i--) {
+            result[i] = result[i + 1] * shape[i + 1];
         }
         return result;
     }
 
-    [[nodiscard]] inline size_t ComputeSize(const std::vector<size_t>& shape) {
+    [[nodiscard]] inline size_t ComputeSize(const Dims& shape) {
         size_t total = 1;
         for (auto& s : shape) {
             total *= s;
@@ -24,7 +31,7 @@ namespace Next {
         return total;
     }
 
-    [[nodiscard]] inline size_t FlattenIndex(const std::vector<size_t>& strides, const std::vector<size_t>& indices) {
+    [[nodiscard]] inline size_t FlattenIndex(const Dims& strides, const Dims& indices) {
         size_t FlattenIndex = 0;
         for (size_t i = 0; i < strides.size(); i++) {
             FlattenIndex += strides[i] * indices[i];
@@ -32,8 +39,8 @@ namespace Next {
         return FlattenIndex;
     }
 
-    [[nodiscard]] inline std::vector<size_t> UnflattenIndex(const std::vector<size_t>& strides, size_t index) {
-        std::vector<size_t> result(strides.size());
+    [[nodiscard]] inline Dims UnflattenIndex(const Dims& strides, size_t index) {
+        Dims result(strides.size());
         for (size_t i = 0; i < strides.size(); i++) {
             result[i] = index / strides[i];
             index %= strides[i];
@@ -41,20 +48,100 @@ namespace Next {
         return result;
     }
 
-    [[nodiscard]] inline bool IsContiguous(const std::vector<size_t>& shape, const std::vector<size_t>& strides) {
+    [[nodiscard]] inline bool IsContiguous(const Dims& shape, const Dims& strides) {
 
         if (shape.size() != strides.size()) throw std::invalid_argument("Shape and Strides Ranks must be match");
 
-        if (strides.back() != 1) throw std::invalid_argument("Last element of stride must be one.");
-
         if (shape.empty()) return true;
 
+        if (strides.back() != 1) return false;
+
         for (int i = static_cast<int>(strides.size()) - 1; i >= 1; i--) {
             if (strides[i-1] != strides[i] * shape[i]) return false;
         }
         return true;
     }
 
+    /**
+     *  @brief Strides that let a view with the given strides be read as newShape without moving data
+     *
+     *  Each run of dimensions that is contiguous in memory can be split or merged freely; std::nullopt when
+     *  newShape would have to merge dimensions across a gap (e.g. most reshapes of a transposed tensor).
+     * **/
+    [[nodiscard]] inline std::optional<Dims> ViewStrides(const Dims& shape, const Dims& strides, const Dims& newShape) {
+        const size_t size = ComputeSize(shape);
+        if (size == 0 || shape.empty()) {
+            return ComputeStrides(newShape);
+        }
+        Dims result(newShape.size(), 0);
+        int viewD = static_cast<int>(newShape.size()) - 1;
+        size_t chunkStride = strides.back();
+        size_t tensorCount = 1, viewCount = 1;
+        for (int d = static_cast<int>(shape.size()) - 1; d >= 0; d--) {
+            tensorCount *= shape[d];
+            // A chunk ends at the outermost dimension or where the next one out is not laid out after it
+            if (d == 0 || (shape[d - 1] != 1 && strides[d - 1] != tensorCount * chunkStride)) {
+                while (viewD >= 0 && (viewCount < tensorCount || newShape[viewD] == 1)) {
+                    result[viewD] = viewCount * chunkStride;
+                    viewCount *= newShape[viewD];
+                    viewD--;
+                }
+                if (viewCount != tensorCount) {
+                    return std::nullopt;
+                }
+                if (d > 0) {
+                    chunkStride = strides[d - 1];
+                    tensorCount = 1;
+                    viewCount = 1;
+                }
+            }
+        }
+        if (viewD != -1) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    /**
+     *  @brief Scratch array of count elements set to value; kernels use it instead of std::vector<T>, whose
+     *  bool specialization has no data()
+     * **/
+    template<typename T>
+    [[nodiscard]] std::unique_ptr<T[]> MakeScratch(size_t count, const T& value = T{}) {
+        auto scratch = std::make_unique_for_overwrite<T[]>(count);
+        std::fill(scratch.get(), scratch.get() + count, value);
+        return scratch;
+    }
+
+    /**
+     *  @brief Per-thread buffer of at least count elements, shared by every call with the same Tag
+     *
+     *  It only grows, so kernels calling it from a steady-state loop stop allocating after the first call.
+     *  The contents are unspecified and stay valid until the same thread asks for Tag again.
+     * **/
+    template<typename Tag, typename T>
+    [[nodiscard]] T* ThreadScratch(size_t count) {
+        thread_local std::unique_ptr<T[]> buffer;
+        thread_local size_t capacity = 0;
+        if (count > capacity) {
+            buffer = std::make_unique_for_overwrite<T[]>(count);
+            capacity = count;
+        }
+        return buffer.get();
+    }
+
+    /**
+     *  @brief Element range [first, last) a view spans inside its storage; {0, 0} when it has no elements
+     * **/
+    [[nodiscard]] inline std::array<size_t, 2> MemorySpan(const Dims& shape, const Dims& strides, size_t offset) {
+        size_t last = offset;
+        for (size_t d = 0; d < shape.size(); d++) {
+            if (shape[d] == 0) return {0, 0};
+            last += (shape[d] - 1) * strides[d];
+        }
+        return {offset, last + 1};
+    }
+
     template <typename T>
     struct TypeToDType {
         static constexpr DType value = DType::UNKNOWN;
@@ -85,8 +172,100 @@ namespace Next {
         static constexpr DType value = DType::UINT8;
     };
 
+    template<>
+    struct TypeToDType<int8_t> {
+        static constexpr DType value = DType::INT8;
+    };
+
     template<>
     struct TypeToDType<bool> {
         static constexpr DType value = DType::BOOL;
     };
+
+    template<>
+    struct TypeToDType<Half> {
+        static constexpr DType value = DType::FLOAT16;
+    };
+
+    template<>
+    struct TypeToDType<BFloat16> {
+        static constexpr DType value = DType::BFLOAT16;
+    };
+
+    template<typename T>
+    struct TypeTag {
+        using Type = T;
+    };
+
+    /**
+     *  @brief Call fn(TypeTag<T>{}) with the element type T of dtype
+     * **/
+    template<typename Fn>
+    constexpr decltype(auto) VisitDType(DType dtype, Fn&& fn) {
+        switch (dtype) {
+            case DType::FLOAT32: return fn(TypeTag<float>{});
+            case DType::FLOAT64: return fn(TypeTag<double>{});
+            case DType::INT32: return fn(TypeTag<int32_t>{});
+            case DType::INT64: return fn(TypeTag<int64_t>{});
+            case DType::UINT8: return fn(TypeTag<uint8_t>{});
+            case DType::BOOL: return fn(TypeTag<bool>{});
+            case DType::FLOAT16: return fn(TypeTag<Half>{});
+            case DType::BFLOAT16: return fn(TypeTag<BFloat16>{});
+            case DType::INT8: return fn(TypeTag<int8_t>{});
+            default: throw std::runtime_error("Unsupported DType");
+        }
+    }
+
+    /**
+     *  @brief Size in bytes of one element of dtype
+     * **/
+    [[nodiscard]] constexpr size_t DTypeSize(DType dtype) {
+        return VisitDType(dtype, []<typename Tag>(Tag) { return sizeof(typename Tag::Type); });
+    }
+
+    [[nodiscard]] inline const char* DTypeName(DType dtype) {
+        switch (dtype) {
+            case DType::FLOAT32: return "float32";
+            case DType::FLOAT64: return "float64";
+            case DType::INT32: return "int32";
+            case DType::INT64: return "int64";
+            case DType::UINT8: return "uint8";
+            case DType::BOOL: return "bool";
+            case DType::FLOAT16: return "float16";
+            case DType::BFLOAT16: return "bfloat16";
+            case DType::INT8: return "int8";
+            default: return "unknown";
+        }
+    }
+
+    [[nodiscard]] constexpr bool IsFloatingDType(DType dtype) {
+        return dtype == DType::FLOAT16 || dtype == DType::BFLOAT16 || dtype == DType::FLOAT32 || dtype == DType::FLOAT64;
+    }
+
+    /**
+     *  @brief Result DType of a binary op between a and b
+     *
+     *  bool < integers < floating point; inside a category the wider type wins (int8 / uint8 < int32 <
+     *  int64, float16 / bfloat16 < float32 < float64). float16 with bfloat16 gives float32 and int8 with
+     *  uint8 gives int32, since neither holds the other's range.
+     * **/
+    [[nodiscard]] constexpr DType PromoteTypes(DType a, DType b) {
+        if (a == DType::UNKNOWN || b == DType::UNKNOWN) {
+            throw std::runtime_error("Cannot promote an unknown DType");
+        }
+        if (a == b) return a;
+        if (a == DType::BOOL) return b;
+        if (b == DType::BOOL) return a;
+
+        const bool aFloat = IsFloatingDType(a);
+        const bool bFloat = IsFloatingDType(b);
+        if (aFloat != bFloat) return aFloat ? a : b;
+        if ((a == DType::FLOAT16 && b == DType::BFLOAT16) || (a == DType::BFLOAT16 && b == DType::FLOAT16)) {
+            return DType::FLOAT32;
+        }
+        if ((a == DType::INT8 && b == DType::UINT8) || (a == DType::UINT8 && b == DType::INT8)) {
+            return DType::INT32;
+        }
+        return DTypeSize(a) >= DTypeSize(b) ? a : b;
+    }
 }
@@ -0,0 +1,190 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "BroadcastUtils.h"
+#include "../core/NextMetadata.h"
+
+namespace Next::View {
+    // Metadata of the views NextTensor<T> and Tensor hand out. Every function only rewrites shape, strides
+    // and offset, in O(rank), and never touches the elements; the caller pairs the result with the storage
+    // cell of the tensor it was taken from.
+
+    /**
+     *  @brief Dimensions reordered: dimension d of the view is dimension dims[d] of the tensor
+     * **/
+    [[nodiscard]] inline NextMetadata Permute(const NextMetadata& metadata, const Dims& dims) {
+        const size_t rank = metadata.Rank();
+        if (dims.size() != rank) {
+            throw std::runtime_error("Permute error: " + ShapeToString(dims) + " does not list the " +
+                                     std::to_string(rank) + " dimensions of the tensor");
+        }
+        Dims n_Shape(rank), n_Strides(rank), seen(rank, 0);
+        for (size_t d = 0; d < rank; d++) {
+            if (dims[d] >= rank || seen[dims[d]]++ != 0) {
+                throw std::runtime_error("Permute error: " + ShapeToString(dims) + " is not a permutation of the " +
+                                         std::to_string(rank) + " dimensions of the tensor");
+            }
+            n_Shape[d] = metadata.Shape()[dims[d]];
+            n_Strides[d] = metadata.Strides()[dims[d]];
+        }
+        return NextMetadata{n_Shape, n_Strides, metadata.GetDType(), metadata.Offset()};
+    }
+
+    [[nodiscard]] inline NextMetadata Transpose(const NextMetadata& metadata, size_t dim1, size_t dim2) {
+        if (dim1 >= metadata.Rank() || dim2 >= metadata.Rank()) {
+            throw std::runtime_error("Transpose dimensions are out of range");
+        }
+        auto n_Shape = metadata.Shape();
+        auto n_Strides = metadata.Strides();
+        std::swap(n_Shape[dim1], n_Shape[dim2]);
+        std::swap(n_Strides[dim1], n_Strides[dim2]);
+        return NextMetadata{n_Shape, n_Strides, metadata.GetDType(), metadata.Offset()};
+    }
+
+    /**
+     *  @brief Indices start, start + step, ... below end of dimension dim
+     * **/
+    [[nodiscard]] inline NextMetadata Slice(const NextMetadata& metadata, size_t dim, size_t start, size_t end,
+                                            size_t step = 1) {
+        if (dim >= metadata.Rank()) {
+            throw std::out_of_range("Slice error: Dimension index (" + std::to_string(dim) +
+                                     ") is out of range for tensor with rank " + std::to_string(metadata.Rank()));
+        }
+
+        if (start > end) {
+            throw std::runtime_error("Slice error: 'start' index (" + std::to_string(start) +
+                                     ") cannot be greater than 'end' index (" + std::to_string(end) + ").");
+        }
+
+        if (end > metadata.Shape()[dim]) {
+            throw std::out_of_range("Slice error: 'end' index (" + std::to_string(end) +
+                                     ") is out of bounds for dimension " + std::to_string(dim) +
+                                     " (size is " + std::to_string(metadata.Shape()[dim]) + ").");
+        }
+
+        if (step == 0) {
+            throw std::runtime_error("Slice error: 'step' must be at least 1.");
+        }
+
+        auto n_Shape = metadata.Shape();
+        auto n_Strides = metadata.Strides();
+        n_Shape[dim] = (end - start + step - 1) / step;
+        n_Strides[dim] *= step;
+        const size_t n_Offset = metadata.Offset() + start * metadata.Strides()[dim];
+        return NextMetadata{n_Shape, n_Strides, metadata.GetDType(), n_Offset};
+    }
+
+    /**
+     *  @brief Broadcast: size-1 and missing leading dimensions are repeated with a zero stride
+     * **/
+    [[nodiscard]] inline NextMetadata Expand(const NextMetadata& metadata, const Dims& shape) {
+        const auto n_Strides = Next::BroadcastStrides(metadata.Shape(), metadata.Strides(), shape);
+        return NextMetadata{shape, n_Strides, metadata.GetDType(), metadata.Offset()};
+    }
+
+    /**
+     *  @brief Every dimension of size one dropped
+     * **/
+    [[nodiscard]] inline NextMetadata Squeeze(const NextMetadata& metadata) {
+        Dims n_Shape, n_Strides;
+        for (size_t d = 0; d < metadata.Rank(); d++) {
+            if (metadata.Shape()[d] == 1) continue;
+            n_Shape.push_back(metadata.Shape()[d]);
+            n_Strides.push_back(metadata.Strides()[d]);
+        }
+        return NextMetadata{n_Shape, n_Strides, metadata.GetDType(), metadata.Offset()};
+    }
+
+    /**
+     *  @brief Dimension dim, which must have size one, dropped
+     * **/
+    [[nodiscard]] inline NextMetadata Squeeze(const NextMetadata& metadata, size_t dim) {
+        if (dim >= metadata.Rank() || metadata.Shape()[dim] != 1) {
+            throw std::runtime_error("Squeeze error: dimension " + std::to_string(dim) + " of shape " +
+                                     ShapeToString(metadata.Shape()) + " is not of size 1");
+        }
+        Dims n_Shape, n_Strides;
+        for (size_t d = 0; d < metadata.Rank(); d++) {
+            if (d == dim) continue;
+            n_Shape.push_back(metadata.Shape()[d]);
+            n_Strides.push_back(metadata.Strides()[d]);
+        }
+        return NextMetadata{n_Shape, n_Strides, metadata.GetDType(), metadata.Offset()};
+    }
+
+    /**
+     *  @brief Dimension of size one inserted before dimension dim (dim == Rank() appends it)
+     *
+     *  Its stride is the one a contiguous tensor would have there, so contiguity is kept.
+     * **/
+    [[nodiscard]] inline NextMetadata Unsqueeze(const NextMetadata& metadata, size_t dim) {
+        if (dim > metadata.Rank()) {
+            throw std::runtime_error("Unsqueeze error: dimension " + std::to_string(dim) +
+                                     " is out of range for tensor with rank " + std::to_string(metadata.Rank()));
+        }
+        Dims n_Shape, n_Strides;
+        for (size_t d = 0; d <= metadata.Rank(); d++) {
+            if (d == dim) {
+                n_Shape.push_back(1);
+                n_Strides.push_back(d < metadata.Rank() ? metadata.Strides()[d] * metadata.Shape()[d] : 1);
+            }
+            if (d < metadata.Rank()) {
+                n_Shape.push_back(metadata.Shape()[d]);
+                n_Strides.push_back(metadata.Strides()[d]);
+            }
+        }
+        return NextMetadata{n_Shape, n_Strides, metadata.GetDType(), metadata.Offset()};
+    }
+
+    /**
+     *  @brief Shape with dimensions startDim..endDim (inclusive, clamped to the last one) merged into one
+     * **/
+    [[nodiscard]] inline Dims FlattenShape(const Dims& shape, size_t startDim, size_t endDim) {
+        if (shape.empty()) return Dims{1};
+        endDim = std::min(endDim, shape.size() - 1);
+        if (startDim > endDim) {
+            throw std::runtime_error("Flatten error: dimensions " + std::to_string(startDim) + " to " +
+                                     std::to_string(endDim) + " are not a range of shape " + ShapeToString(shape));
+        }
+        Dims n_Shape;
+        for (size_t d = 0; d < startDim; d++) {
+            n_Shape.push_back(shape[d]);
+        }
+        size_t merged = 1;
+        for (size_t d = startDim; d <= endDim; d++) {
+            merged *= shape[d];
+        }
+        n_Shape.push_back(merged);
+        for (size_t d = endDim + 1; d < shape.size(); d++) {
+            n_Shape.push_back(shape[d]);
+        }
+        return n_Shape;
+    }
+
+    /**
+     *  @brief Arbitrary shape, strides and offset over a storage of storageSize elements
+     *
+     *  Only checked to stay inside the storage; elements may repeat or overlap, which makes the view
+     *  read-only in practice (element-wise ops reject such destinations).
+     * **/
+    [[nodiscard]] inline NextMetadata AsStrided(const NextMetadata& metadata, const Dims& shape, const Dims& strides,
+                                                size_t offset, size_t storageSize) {
+        if (shape.size() != strides.size()) {
+            throw std::runtime_error("As strided error: shape " + ShapeToString(shape) + " and strides " +
+                                     ShapeToString(strides) + " differ in rank");
+        }
+        const auto span = Next::MemorySpan(shape, strides, offset);
+        if (span[1] > storageSize) {
+            throw std::out_of_range("As strided error: view of shape " + ShapeToString(shape) + ", strides " +
+                                    ShapeToString(strides) + " and offset " + std::to_string(offset) +
+                                    " reaches past the " + std::to_string(storageSize) + " elements of the storage");
+        }
+        return NextMetadata{shape, strides, metadata.GetDType(), offset};
+    }
+}
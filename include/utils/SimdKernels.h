@@ -0,0 +1,395 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define NEXT_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define NEXT_SIMD_X86 0
+#endif
+
+namespace Next::Simd {
+    enum class ISA {
+        SCALAR,
+        SSE41,
+        AVX2,
+        AVX512
+    };
+
+    enum class BinaryOp {
+        ADD,
+        SUB,
+        MUL,
+        DIV,
+        COUNT
+    };
+
+    /**
+     *  @brief Name of the NextTensor method running op, as the profiler reports it
+     * **/
+    constexpr const char* OpName(BinaryOp op) {
+        constexpr const char* names[] = {"add", "sub", "mult", "divide"};
+        return op < BinaryOp::COUNT ? names[static_cast<size_t>(op)] : "binary";
+    }
+
+    //*
+    //@brief Contiguous element-wise kernels of one type: out = a op b, with either side possibly a scalar.
+    //*/
+    template<typename T>
+    struct KernelTable {
+        using BinaryFn = void (*)(T* out, const T* a, const T* b, size_t n);
+        using ScalarFn = void (*)(T* out, const T* a, T b, size_t n);
+        using RScalarFn = void (*)(T* out, T a, const T* b, size_t n);
+
+        std::array<BinaryFn, static_cast<size_t>(BinaryOp::COUNT)> Binary{};
+        std::array<ScalarFn, static_cast<size_t>(BinaryOp::COUNT)> Scalar{};
+        std::array<RScalarFn, static_cast<size_t>(BinaryOp::COUNT)> RScalar{};
+    };
+
+    template<typename T>
+    inline constexpr bool HasKernels = std::is_same_v<T, float> || std::is_same_v<T, double> ||
+                                       std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+                                       std::is_same_v<T, uint8_t>;
+
+    template<BinaryOp Op, typename T>
+    T ScalarApply(const T& a, const T& b) {
+        if constexpr (Op == BinaryOp::ADD) return static_cast<T>(a + b);
+        else if constexpr (Op == BinaryOp::SUB) return static_cast<T>(a - b);
+        else if constexpr (Op == BinaryOp::MUL) return static_cast<T>(a * b);
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            // min / -1 wraps like the other integer ops instead of trapping
+            using U = std::make_unsigned_t<T>;
+            return b == T(-1) ? static_cast<T>(U(0) - static_cast<U>(a)) : static_cast<T>(a / b);
+        } else return static_cast<T>(a / b);
+    }
+
+    /**
+     *  @brief Element-wise functor that the tensor drivers recognise and route to the kernel table
+     * **/
+    template<BinaryOp Op>
+    struct Arith {
+        static constexpr BinaryOp Kind = Op;
+
+        template<typename T>
+        T operator()(const T& a, const T& b) const { return ScalarApply<Op>(a, b); }
+    };
+
+    namespace Scalar {
+        template<typename T, BinaryOp Op>
+        void BinaryLoop(T* out, const T* a, const T* b, size_t n) {
+            for (size_t i = 0; i < n; i++) out[i] = ScalarApply<Op>(a[i], b[i]);
+        }
+
+        template<typename T, BinaryOp Op>
+        void ScalarLoop(T* out, const T* a, T b, size_t n) {
+            for (size_t i = 0; i < n; i++) out[i] = ScalarApply<Op>(a[i], b);
+        }
+
+        template<typename T, BinaryOp Op>
+        void RScalarLoop(T* out, T a, const T* b, size_t n) {
+            for (size_t i = 0; i < n; i++) out[i] = ScalarApply<Op>(a, b[i]);
+        }
+    }
+
+    // The vector loops are identical for every ISA apart from the target attribute, so they are stamped
+    // out once per ISA namespace. Vec<T> of that namespace supplies Load/Store/Set1 and Apply<Op> for the
+    // operations the ISA has an instruction for; the rest of the table falls back to the scalar loops.
+#define NEXT_SIMD_DEFINE_LOOPS(TARGET)                                                                  \
+    template<typename T, BinaryOp Op>                                                                   \
+    TARGET void BinaryLoop(T* out, const T* a, const T* b, size_t n) {                                  \
+        using V = Vec<T>;                                                                               \
+        size_t i = 0;                                                                                   \
+        for (; i + V::Width <= n; i += V::Width) {                                                      \
+            V::Store(out + i, V::template Apply<Op>(V::Load(a + i), V::Load(b + i)));                   \
+        }                                                                                               \
+        for (; i < n; i++) out[i] = ScalarApply<Op>(a[i], b[i]);                                        \
+    }                                                                                                   \
+                                                                                                        \
+    template<typename T, BinaryOp Op>                                                                   \
+    TARGET void ScalarLoop(T* out, const T* a, T b, size_t n) {                                         \
+        using V = Vec<T>;                                                                               \
+        const auto vb = V::Set1(b);                                                                     \
+        size_t i = 0;                                                                                   \
+        for (; i + V::Width <= n; i += V::Width) {                                                      \
+            V::Store(out + i, V::template Apply<Op>(V::Load(a + i), vb));                               \
+        }                                                                                               \
+        for (; i < n; i++) out[i] = ScalarApply<Op>(a[i], b);                                           \
+    }                                                                                                   \
+                                                                                                        \
+    template<typename T, BinaryOp Op>                                                                   \
+    TARGET void RScalarLoop(T* out, T a, const T* b, size_t n) {                                        \
+        using V = Vec<T>;                                                                               \
+        const auto va = V::Set1(a);                                                                     \
+        size_t i = 0;                                                                                   \
+        for (; i + V::Width <= n; i += V::Width) {                                                      \
+            V::Store(out + i, V::template Apply<Op>(va, V::Load(b + i)));                               \
+        }                                                                                               \
+        for (; i < n; i++) out[i] = ScalarApply<Op>(a, b[i]);                                           \
+    }                                                                                                   \
+                                                                                                        \
+    template<typename T, BinaryOp Op>                                                                   \
+    void Fill(KernelTable<T>& table) {                                                                  \
+        constexpr auto idx = static_cast<size_t>(Op);                                                   \
+        if constexpr (Vec<T>::template Has<Op>) {                                                       \
+            table.Binary[idx] = &BinaryLoop<T, Op>;                                                     \
+            table.Scalar[idx] = &ScalarLoop<T, Op>;                                                     \
+            table.RScalar[idx] = &RScalarLoop<T, Op>;                                                   \
+        } else {                                                                                        \
+            table.Binary[idx] = &Scalar::BinaryLoop<T, Op>;                                             \
+            table.Scalar[idx] = &Scalar::ScalarLoop<T, Op>;                                             \
+            table.RScalar[idx] = &Scalar::RScalarLoop<T, Op>;                                           \
+        }                                                                                               \
+    }                                                                                                   \
+                                                                                                        \
+    template<typename T>                                                                                \
+    KernelTable<T> MakeTable() {                                                                        \
+        KernelTable<T> table;                                                                           \
+        Fill<T, BinaryOp::ADD>(table);                                                                  \
+        Fill<T, BinaryOp::SUB>(table);                                                                  \
+        Fill<T, BinaryOp::MUL>(table);                                                                  \
+        Fill<T, BinaryOp::DIV>(table);                                                                  \
+        return table;                                                                                   \
+    }
+
+    // Float-like vector types: every op has an instruction
+#define NEXT_SIMD_FLOAT_VEC(TARGET, TYPE, REG, WIDTH, PREFIX, SUFFIX)                                   \
+    template<>                                                                                          \
+    struct Vec<TYPE> {                                                                                  \
+        using Reg = REG;                                                                                \
+        static constexpr size_t Width = WIDTH;                                                          \
+        template<BinaryOp Op>                                                                           \
+        static constexpr bool Has = true;                                                               \
+        TARGET static Reg Load(const TYPE* p) { return PREFIX##_loadu_##SUFFIX(p); }                    \
+        TARGET static void Store(TYPE* p, Reg v) { PREFIX##_storeu_##SUFFIX(p, v); }                    \
+        TARGET static Reg Set1(TYPE v) { return PREFIX##_set1_##SUFFIX(v); }                            \
+        template<BinaryOp Op>                                                                           \
+        TARGET static Reg Apply(Reg a, Reg b) {                                                         \
+            if constexpr (Op == BinaryOp::ADD) return PREFIX##_add_##SUFFIX(a, b);                      \
+            else if constexpr (Op == BinaryOp::SUB) return PREFIX##_sub_##SUFFIX(a, b);                 \
+            else if constexpr (Op == BinaryOp::MUL) return PREFIX##_mul_##SUFFIX(a, b);                 \
+            else return PREFIX##_div_##SUFFIX(a, b);                                                    \
+        }                                                                                               \
+    };
+
+    // Integer vector types: add/sub always, multiply only when MULLO names an instruction, divide only when
+    // DIVIDE is set (int32 through double, where the truncated quotient always is the integer one and
+    // min / -1 converts to min, the same wrap as the scalar path)
+#define NEXT_SIMD_INT_VEC(TARGET, TYPE, REG, WIDTH, PREFIX, BITS, SET1, CAST, MULLO, DIVIDE)            \
+    template<>                                                                                          \
+    struct Vec<TYPE> {                                                                                  \
+        using Reg = REG;                                                                                \
+        static constexpr size_t Width = WIDTH;                                                          \
+        template<BinaryOp Op>                                                                           \
+        static constexpr bool Has = Op == BinaryOp::ADD || Op == BinaryOp::SUB ||                       \
+                                    (Op == BinaryOp::MUL && MULLO) || (Op == BinaryOp::DIV && DIVIDE);  \
+        TARGET static Reg Load(const TYPE* p) {                                                         \
+            return PREFIX##_loadu_si##BITS(reinterpret_cast<const Reg*>(p));                            \
+        }                                                                                               \
+        TARGET static void Store(TYPE* p, Reg v) {                                                      \
+            PREFIX##_storeu_si##BITS(reinterpret_cast<Reg*>(p), v);                                     \
+        }                                                                                               \
+        TARGET static Reg Set1(TYPE v) { return PREFIX##_##SET1(static_cast<CAST>(v)); }                \
+        template<BinaryOp Op>                                                                           \
+        TARGET static Reg Apply(Reg a, Reg b);                                                          \
+    };
+
+#if NEXT_SIMD_X86
+#define NEXT_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define NEXT_TARGET_AVX2 __attribute__((target("avx2")))
+#define NEXT_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq")))
+
+    namespace Sse41 {
+        template<typename T>
+        struct Vec;
+
+        NEXT_SIMD_FLOAT_VEC(NEXT_TARGET_SSE41, float, __m128, 4, _mm, ps)
+        NEXT_SIMD_FLOAT_VEC(NEXT_TARGET_SSE41, double, __m128d, 2, _mm, pd)
+        NEXT_SIMD_INT_VEC(NEXT_TARGET_SSE41, int32_t, __m128i, 4, _mm, 128, set1_epi32, int32_t, true, true)
+        NEXT_SIMD_INT_VEC(NEXT_TARGET_SSE41, int64_t, __m128i, 2, _mm, 128, set1_epi64x, int64_t, false, false)
+        NEXT_SIMD_INT_VEC(NEXT_TARGET_SSE41, uint8_t, __m128i, 16, _mm, 128, set1_epi8, char, false, false)
+
+        template<BinaryOp Op>
+        NEXT_TARGET_SSE41 __m128i Vec<int32_t>::Apply(__m128i a, __m128i b) {
+            if constexpr (Op == BinaryOp::ADD) return _mm_add_epi32(a, b);
+            else if constexpr (Op == BinaryOp::SUB) return _mm_sub_epi32(a, b);
+            else if constexpr (Op == BinaryOp::MUL) return _mm_mullo_epi32(a, b);
+            else {
+                const __m128d lo = _mm_div_pd(_mm_cvtepi32_pd(a), _mm_cvtepi32_pd(b));
+                const __m128d hi = _mm_div_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(a, a)),
+                                              _mm_cvtepi32_pd(_mm_unpackhi_epi64(b, b)));
+                return _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+            }
+        }
+
+        template<BinaryOp Op>
+        NEXT_TARGET_SSE41 __m128i Vec<int64_t>::Apply(__m128i a, __m128i b) {
+            if constexpr (Op == BinaryOp::ADD) return _mm_add_epi64(a, b);
+            else return _mm_sub_epi64(a, b);
+        }
+
+        template<BinaryOp Op>
+        NEXT_TARGET_SSE41 __m128i Vec<uint8_t>::Apply(__m128i a, __m128i b) {
+            if constexpr (Op == BinaryOp::ADD) return _mm_add_epi8(a, b);
+            else return _mm_sub_epi8(a, b);
+        }
+
+        NEXT_SIMD_DEFINE_LOOPS(NEXT_TARGET_SSE41)
+    }
+
+    namespace Avx2 {
+        template<typename T>
+        struct Vec;
+
+        NEXT_SIMD_FLOAT_VEC(NEXT_TARGET_AVX2, float, __m256, 8, _mm256, ps)
+        NEXT_SIMD_FLOAT_VEC(NEXT_TARGET_AVX2, double, __m256d, 4, _mm256, pd)
+        NEXT_SIMD_INT_VEC(NEXT_TARGET_AVX2, int32_t, __m256i, 8, _mm256, 256, set1_epi32, int32_t, true, true)
+        NEXT_SIMD_INT_VEC(NEXT_TARGET_AVX2, int64_t, __m256i, 4, _mm256, 256, set1_epi64x, int64_t, false, false)
+        NEXT_SIMD_INT_VEC(NEXT_TARGET_AVX2, uint8_t, __m256i, 32, _mm256, 256, set1_epi8, char, false, false)
+
+        template<BinaryOp Op>
+        NEXT_TARGET_AVX2 __m256i Vec<int32_t>::Apply(__m256i a, __m256i b) {
+            if constexpr (Op == BinaryOp::ADD) return _mm256_add_epi32(a, b);
+            else if constexpr (Op == BinaryOp::SUB) return _mm256_sub_epi32(a, b);
+            else if constexpr (Op == BinaryOp::MUL) return _mm256_mullo_epi32(a, b);
+            else {
+                const __m256d lo = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(a)),
+                                                 _mm256_cvtepi32_pd(_mm256_castsi256_si128(b)));
+                const __m256d hi = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)),
+                                                 _mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1)));
+                return _mm256_set_m128i(_mm256_cvttpd_epi32(hi), _mm256_cvttpd_epi32(lo));
+            }
+        }
+
+        template<BinaryOp Op>
+        NEXT_TARGET_AVX2 __m256i Vec<int64_t>::Apply(__m256i a, __m256i b) {
+            if constexpr (Op == BinaryOp::ADD) return _mm256_add_epi64(a, b);
+            else return _mm256_sub_epi64(a, b);
+        }
+
+        template<BinaryOp Op>
+        NEXT_TARGET_AVX2 __m256i Vec<uint8_t>::Apply(__m256i a, __m256i b) {
+            if constexpr (Op == BinaryOp::ADD) return _mm256_add_epi8(a, b);
+            else return _mm256_sub_epi8(a, b);
+        }
+
+        NEXT_SIMD_DEFINE_LOOPS(NEXT_TARGET_AVX2)
+    }
+
+    namespace Avx512 {
+        template<typename T>
+        struct Vec;
+
+        NEXT_SIMD_FLOAT_VEC(NEXT_TARGET_AVX512, float, __m512, 16, _mm512, ps)
+        NEXT_SIMD_FLOAT_VEC(NEXT_TARGET_AVX512, double, __m512d, 8, _mm512, pd)
+        NEXT_SIMD_INT_VEC(NEXT_TARGET_AVX512, int32_t, __m512i, 16, _mm512, 512, set1_epi32, int32_t, true, true)
+        NEXT_SIMD_INT_VEC(NEXT_TARGET_AVX512, int64_t, __m512i, 8, _mm512, 512, set1_epi64, int64_t, true, false)
+        NEXT_SIMD_INT_VEC(NEXT_TARGET_AVX512, uint8_t, __m512i, 64, _mm512, 512, set1_epi8, char, false, false)
+
+        template<BinaryOp Op>
+        NEXT_TARGET_AVX512 __m512i Vec<int32_t>::Apply(__m512i a, __m512i b) {
+            if constexpr (Op == BinaryOp::ADD) return _mm512_add_epi32(a, b);
+            else if constexpr (Op == BinaryOp::SUB) return _mm512_sub_epi32(a, b);
+            else if constexpr (Op == BinaryOp::MUL) return _mm512_mullo_epi32(a, b);
+            else {
+                const __m512d lo = _mm512_div_pd(_mm512_cvtepi32_pd(_mm512_castsi512_si256(a)),
+                                                 _mm512_cvtepi32_pd(_mm512_castsi512_si256(b)));
+                const __m512d hi = _mm512_div_pd(_mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(a, 1)),
+                                                 _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(b, 1)));
+                return _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvttpd_epi32(lo)), _mm512_cvttpd_epi32(hi), 1);
+            }
+        }
+
+        template<BinaryOp Op>
+        NEXT_TARGET_AVX512 __m512i Vec<int64_t>::Apply(__m512i a, __m512i b) {
+            if constexpr (Op == BinaryOp::ADD) return _mm512_add_epi64(a, b);
+            else if constexpr (Op == BinaryOp::SUB) return _mm512_sub_epi64(a, b);
+            else return _mm512_mullo_epi64(a, b);
+        }
+
+        template<BinaryOp Op>
+        NEXT_TARGET_AVX512 __m512i Vec<uint8_t>::Apply(__m512i a, __m512i b) {
+            if constexpr (Op == BinaryOp::ADD) return _mm512_add_epi8(a, b);
+            else return _mm512_sub_epi8(a, b);
+        }
+
+        NEXT_SIMD_DEFINE_LOOPS(NEXT_TARGET_AVX512)
+    }
+#endif
+
+    namespace Scalar {
+        template<typename T>
+        KernelTable<T> MakeTable() {
+            KernelTable<T> table;
+            auto fill = [&table]<BinaryOp Op>() {
+                constexpr auto idx = static_cast<size_t>(Op);
+                table.Binary[idx] = &BinaryLoop<T, Op>;
+                table.Scalar[idx] = &ScalarLoop<T, Op>;
+                table.RScalar[idx] = &RScalarLoop<T, Op>;
+            };
+            fill.template operator()<BinaryOp::ADD>();
+            fill.template operator()<BinaryOp::SUB>();
+            fill.template operator()<BinaryOp::MUL>();
+            fill.template operator()<BinaryOp::DIV>();
+            return table;
+        }
+    }
+
+    /**
+     *  @brief Best instruction set the running CPU supports
+     * **/
+    inline ISA DetectISA() {
+#if NEXT_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+            __builtin_cpu_supports("avx512dq")) {
+            return ISA::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) return ISA::AVX2;
+        if (__builtin_cpu_supports("sse4.1")) return ISA::SSE41;
+#endif
+        return ISA::SCALAR;
+    }
+
+    namespace Detail {
+        inline std::atomic<ISA>& ActiveISA() {
+            static std::atomic<ISA> isa{DetectISA()};
+            return isa;
+        }
+    }
+
+    [[nodiscard]] inline ISA GetISA() { return Detail::ActiveISA().load(std::memory_order_relaxed); }
+
+    /**
+     *  @brief Restrict dispatch to a lower instruction set (benchmarks, debugging); clamped to what the CPU has
+     * **/
+    inline void SetISA(ISA isa) {
+        const ISA best = DetectISA();
+        Detail::ActiveISA().store(isa > best ? best : isa, std::memory_order_relaxed);
+    }
+
+    /**
+     *  @brief Kernel table for the currently selected instruction set
+     * **/
+    template<typename T>
+    const KernelTable<T>& Kernels() {
+        static_assert(HasKernels<T>, "No SIMD kernels for this type");
+#if NEXT_SIMD_X86
+        static const std::array<KernelTable<T>, 4> tables = {
+            Scalar::MakeTable<T>(), Sse41::MakeTable<T>(), Avx2::MakeTable<T>(), Avx512::MakeTable<T>()
+        };
+#else
+        static const std::array<KernelTable<T>, 4> tables = {
+            Scalar::MakeTable<T>(), Scalar::MakeTable<T>(), Scalar::MakeTable<T>(), Scalar::MakeTable<T>()
+        };
+#endif
+        return tables[static_cast<size_t>(GetISA())];
+    }
+}
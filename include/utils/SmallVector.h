@@ -0,0 +1,221 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace Next {
+    //*
+    //@brief Vector with inline room for N elements; it only touches the heap once it grows past N.
+    //
+    // Restricted to trivially copyable elements, which is all shapes and strides need and keeps copies a
+    // memcpy of the inline buffer.
+    //*/
+    template<typename T, size_t N>
+    class SmallVector {
+        static_assert(std::is_trivially_copyable_v<T>, "SmallVector holds trivially copyable elements only");
+
+    private:
+        T* m_Data;
+        size_t m_Size{0};
+        size_t m_Capacity{N};
+        T m_Inline[N];
+
+        [[nodiscard]] bool IsInline() const { return m_Data == m_Inline; }
+
+        void Release() {
+            if (!IsInline()) delete[] m_Data;
+            m_Data = m_Inline;
+            m_Capacity = N;
+        }
+
+        void Grow(size_t capacity) {
+            capacity = std::max(capacity, m_Capacity * 2);
+            T* data = new T[capacity];
+            std::copy(m_Data, m_Data + m_Size, data);
+            if (!IsInline()) delete[] m_Data;
+            m_Data = data;
+            m_Capacity = capacity;
+        }
+
+        void CopyFrom(const T* first, size_t count) {
+            if (count > m_Capacity) Grow(count);
+            std::copy(first, first + count, m_Data);
+            m_Size = count;
+        }
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using reverse_iterator = std::reverse_iterator<T*>;
+        using const_reverse_iterator = std::reverse_iterator<const T*>;
+
+        SmallVector() : m_Data(m_Inline) {}
+
+        explicit SmallVector(size_t count, const T& value = T{}) : m_Data(m_Inline) {
+            resize(count, value);
+        }
+
+        SmallVector(std::initializer_list<T> values) : m_Data(m_Inline) {
+            CopyFrom(values.begin(), values.size());
+        }
+
+        template<std::input_iterator It>
+        SmallVector(It first, It last) : m_Data(m_Inline) {
+            assign(first, last);
+        }
+
+        // Implicit so existing code passing a std::vector keeps working
+        SmallVector(const std::vector<T>& values) : m_Data(m_Inline) {
+            CopyFrom(values.data(), values.size());
+        }
+
+        SmallVector(const SmallVector& other) : m_Data(m_Inline) {
+            CopyFrom(other.m_Data, other.m_Size);
+        }
+
+        SmallVector(SmallVector&& other) noexcept : m_Data(m_Inline) {
+            *this = std::move(other);
+        }
+
+        SmallVector& operator=(const SmallVector& other) {
+            if (this != &other) CopyFrom(other.m_Data, other.m_Size);
+            return *this;
+        }
+
+        SmallVector& operator=(SmallVector&& other) noexcept {
+            if (this == &other) return *this;
+            if (other.IsInline()) {
+                std::copy(other.m_Data, other.m_Data + other.m_Size, m_Inline);
+                Release();
+            } else {
+                Release();
+                m_Data = other.m_Data;
+                m_Capacity = other.m_Capacity;
+                other.m_Data = other.m_Inline;
+                other.m_Capacity = N;
+            }
+            m_Size = other.m_Size;
+            other.m_Size = 0;
+            return *this;
+        }
+
+        ~SmallVector() {
+            if (!IsInline()) delete[] m_Data;
+        }
+
+        template<std::input_iterator It>
+        void assign(It first, It last) {
+            m_Size = 0;
+            for (; first != last; ++first) {
+                push_back(static_cast<T>(*first));
+            }
+        }
+
+        void assign(size_t count, const T& value) {
+            m_Size = 0;
+            resize(count, value);
+        }
+
+        [[nodiscard]] size_t size() const { return m_Size; }
+
+        [[nodiscard]] bool empty() const { return m_Size == 0; }
+
+        [[nodiscard]] size_t capacity() const { return m_Capacity; }
+
+        [[nodiscard]] T* data() { return m_Data; }
+
+        [[nodiscard]] const T* data() const { return m_Data; }
+
+        T* begin() { return m_Data; }
+
+        T* end() { return m_Data + m_Size; }
+
+        [[nodiscard]] const T* begin() const { return m_Data; }
+
+        [[nodiscard]] const T* end() const { return m_Data + m_Size; }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+
+        [[nodiscard]] const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+        [[nodiscard]] const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        T& operator[](size_t i) { return m_Data[i]; }
+
+        const T& operator[](size_t i) const { return m_Data[i]; }
+
+        T& front() { return m_Data[0]; }
+
+        [[nodiscard]] const T& front() const { return m_Data[0]; }
+
+        T& back() { return m_Data[m_Size - 1]; }
+
+        [[nodiscard]] const T& back() const { return m_Data[m_Size - 1]; }
+
+        void reserve(size_t capacity) {
+            if (capacity > m_Capacity) Grow(capacity);
+        }
+
+        void resize(size_t count, const T& value = T{}) {
+            reserve(count);
+            if (count > m_Size) std::fill(m_Data + m_Size, m_Data + count, value);
+            m_Size = count;
+        }
+
+        void clear() { m_Size = 0; }
+
+        void push_back(const T& value) {
+            if (m_Size == m_Capacity) Grow(m_Size + 1);
+            m_Data[m_Size++] = value;
+        }
+
+        void pop_back() { m_Size--; }
+
+        T* insert(const T* pos, const T& value) {
+            const auto index = static_cast<size_t>(pos - m_Data);
+            const T copy = value;
+            if (m_Size == m_Capacity) Grow(m_Size + 1);
+            std::copy_backward(m_Data + index, m_Data + m_Size, m_Data + m_Size + 1);
+            m_Data[index] = copy;
+            m_Size++;
+            return m_Data + index;
+        }
+
+        T* erase(const T* pos) {
+            const auto index = static_cast<size_t>(pos - m_Data);
+            std::copy(m_Data + index + 1, m_Data + m_Size, m_Data + index);
+            m_Size--;
+            return m_Data + index;
+        }
+
+        [[nodiscard]] std::vector<T> ToVector() const { return std::vector<T>(begin(), end()); }
+
+        friend bool operator==(const SmallVector& a, const SmallVector& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+    };
+
+    inline constexpr size_t MaxInlineRank = 8;
+
+    /**
+     *  @brief Shape / strides / index list; ranks up to MaxInlineRank never allocate
+     * **/
+    using Dims = SmallVector<size_t, MaxInlineRank>;
+
+    /**
+     *  @brief One flag per dimension (e.g. the reduced axes); as allocation-free as Dims
+     * **/
+    using AxisMask = SmallVector<bool, MaxInlineRank>;
+}
@@ -0,0 +1,314 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+#include "NextProfile.h"
+#include "SmallVector.h"
+#include "ThreadPool.h"
+
+namespace Next {
+    //*
+    //@brief Walks N operands that share one logical shape but have their own strides and offsets.
+    //
+    // Dimensions of size one are dropped, the rest are ordered by stride and neighbouring dimensions that
+    // are contiguous for every operand are merged, so the walk happens one inner row at a time: callers
+    // receive the row start offsets and the inner stride of each operand and can run a plain incremental
+    // pointer loop. Rows are visited in memory order, not in logical index order.
+    //*/
+    template<size_t N>
+    class StridedIterator {
+    private:
+        Dims m_Shape;                    // Coalesced outer shape (innermost dimension removed)
+        std::array<Dims, N> m_Strides;   // Coalesced outer strides of each operand
+        std::array<size_t, N> m_BaseOffsets{};          // Offsets of the first element of each operand
+        std::array<size_t, N> m_Offsets{};              // Offsets of the current row of each operand
+        std::array<size_t, N> m_InnerStrides{};         // Innermost stride of each operand
+        Dims m_Index;                    // Odometer over the outer dimensions
+        size_t m_InnerSize{0};                          // Number of elements in a row
+        size_t m_Rows{0};                               // Number of rows
+
+    public:
+        StridedIterator(const Dims& shape,
+                        const std::array<const Dims*, N>& strides,
+                        const std::array<size_t, N>& offsets)
+            : m_BaseOffsets(offsets), m_Offsets(offsets) {
+            for (auto s : shape) {
+                if (s == 0) return; // Empty tensor, nothing to walk
+            }
+
+            // Visit order: insertion sort so the dimension with the smallest stride goes innermost. The first
+            // operand (the destination) decides, later operands only break ties, so writes stay in memory
+            // order even when the inputs are transposed
+            Dims order;
+            for (size_t d = 0; d < shape.size(); d++) {
+                if (shape[d] != 1) order.push_back(d);
+            }
+            auto shouldSwap = [&strides](size_t outer, size_t inner) {
+                for (size_t k = 0; k < N; k++) {
+                    const size_t so = (*strides[k])[outer];
+                    const size_t si = (*strides[k])[inner];
+                    if (so != 0 && si != 0 && so != si) return si > so;
+                }
+                return false;
+            };
+            for (size_t i = 1; i < order.size(); i++) {
+                for (size_t j = i; j > 0 && shouldSwap(order[j - 1], order[j]); --j) {
+                    std::swap(order[j - 1], order[j]);
+                }
+            }
+
+            // Collect dimensions from innermost to outermost, merging the ones that can be walked as one
+            Dims n_Shape;
+            std::array<Dims, N> n_Strides;
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                const size_t d = *it;
+
+                bool collapsible = !n_Shape.empty();
+                for (size_t k = 0; k < N && collapsible; k++) {
+                    collapsible = (*strides[k])[d] == n_Strides[k].back() * n_Shape.back();
+                }
+
+                if (collapsible) {
+                    n_Shape.back() *= shape[d];
+                } else {
+                    n_Shape.push_back(shape[d]);
+                    for (size_t k = 0; k < N; k++) {
+                        n_Strides[k].push_back((*strides[k])[d]);
+                    }
+                }
+            }
+
+            if (n_Shape.empty()) { // Every dimension is one: a single element
+                m_InnerSize = 1;
+                m_Rows = 1;
+                return;
+            }
+
+            m_InnerSize = n_Shape.front();
+            for (size_t k = 0; k < N; k++) {
+                m_InnerStrides[k] = n_Strides[k].front();
+                m_Strides[k].assign(n_Strides[k].rbegin(), n_Strides[k].rend() - 1);
+            }
+            m_Shape.assign(n_Shape.rbegin(), n_Shape.rend() - 1);
+            m_Index.assign(m_Shape.size(), 0);
+
+            m_Rows = 1;
+            for (auto s : m_Shape) {
+                m_Rows *= s;
+            }
+        }
+
+        [[nodiscard]] size_t Rows() const { return m_Rows; }
+
+        [[nodiscard]] size_t InnerSize() const { return m_InnerSize; }
+
+        [[nodiscard]] const std::array<size_t, N>& InnerStrides() const { return m_InnerStrides; }
+
+        [[nodiscard]] const std::array<size_t, N>& Offsets() const { return m_Offsets; }
+
+        /**
+         *  @brief Move to the given row index (0 <= row < Rows())
+         * **/
+        void Seek(size_t row) {
+            m_Offsets = m_BaseOffsets;
+            for (int d = static_cast<int>(m_Shape.size()) - 1; d >= 0; --d) {
+                m_Index[d] = row % m_Shape[d];
+                row /= m_Shape[d];
+                for (size_t k = 0; k < N; k++) {
+                    m_Offsets[k] += m_Index[d] * m_Strides[k][d];
+                }
+            }
+        }
+
+        /**
+         *  @brief Move to the next row
+         * **/
+        void Advance() {
+            for (int d = static_cast<int>(m_Shape.size()) - 1; d >= 0; --d) {
+                for (size_t k = 0; k < N; k++) {
+                    m_Offsets[k] += m_Strides[k][d];
+                }
+                if (++m_Index[d] < m_Shape[d]) {
+                    return;
+                }
+                for (size_t k = 0; k < N; k++) {
+                    m_Offsets[k] -= m_Strides[k][d] * m_Shape[d];
+                }
+                m_Index[d] = 0;
+            }
+        }
+
+        /**
+         *  @brief Prepare a tiled walk: the outer dimension along which a gathering operand (one stepping
+         *  further inside a row than to a neighbouring row) moves the least becomes the last one, so that the
+         *  rows of a tile are neighbours in that operand's memory. Renumbers the rows, call it before Seek.
+         * **/
+        void OrderForTiles() {
+            for (size_t k = 0; k < N; k++) {
+                if (m_InnerStrides[k] <= 1) continue;
+                size_t best = m_Shape.size();
+                for (size_t d = 0; d < m_Shape.size(); d++) {
+                    const size_t stride = m_Strides[k][d];
+                    if (stride != 0 && stride < m_InnerStrides[k] &&
+                        (best == m_Shape.size() || stride < m_Strides[k][best])) {
+                        best = d;
+                    }
+                }
+                if (best == m_Shape.size()) continue;
+                std::rotate(m_Shape.begin() + best, m_Shape.begin() + best + 1, m_Shape.end());
+                for (auto& strides : m_Strides) {
+                    std::rotate(strides.begin() + best, strides.begin() + best + 1, strides.end());
+                }
+                return;
+            }
+        }
+
+        /**
+         *  @brief Calls rowFn(offsets, innerStrides, count) for the rows [begin, end), without moving the iterator
+         *
+         *  Up to three outer dimensions, which covers every tensor of rank four or less, the walk runs a
+         *  specialization for that exact count; deeper shapes fall back to Seek and Advance. With tiled set a
+         *  rank-specialized walk may hand over a row in pieces (see WalkRows).
+         * **/
+        template<typename RowFn>
+        void ForRows(size_t begin, size_t end, RowFn&& rowFn, bool tiled = false) const {
+            switch (m_Shape.size()) {
+                case 0: WalkRows<0>(begin, end, rowFn, false); return;
+                case 1: WalkRows<1>(begin, end, rowFn, tiled); return;
+                case 2: WalkRows<2>(begin, end, rowFn, tiled); return;
+                case 3: WalkRows<3>(begin, end, rowFn, tiled); return;
+                default: break;
+            }
+            StridedIterator local = *this;
+            local.Seek(begin);
+            for (size_t r = begin; r < end; r++) {
+                rowFn(local.Offsets(), local.InnerStrides(), local.InnerSize());
+                local.Advance();
+            }
+        }
+
+    private:
+        // Tile of a tiled walk: TileRows neighbouring rows, TileColumns elements of each at a time
+        static constexpr size_t TileRows = 16;
+        static constexpr size_t TileColumns = 64;
+
+        /**
+         *  @brief ForRows for exactly R outer dimensions
+         *
+         *  Shape, strides and the rewind of every dimension are copied into fixed-size locals, so the loops
+         *  over d and k unroll and the odometer step is a few register compares and adds instead of Advance's
+         *  loops over runtime-sized Dims.
+         *
+         *  When tiled is set and an operand steps further inside a row than to the next row (a transposed
+         *  input read along a contiguous destination), TileRows rows are walked TileColumns elements at a
+         *  time: each cache line and page of that operand is then used by all rows of the tile while it is
+         *  still cached, instead of once per row.
+         * **/
+        template<size_t R, typename RowFn>
+        void WalkRows(size_t begin, size_t end, RowFn& rowFn, bool tiled) const {
+            std::array<size_t, R> shape{}, index{};
+            std::array<std::array<size_t, N>, R> strides{}, rewind{};
+            std::array<size_t, N> offsets = m_BaseOffsets;
+            const std::array<size_t, N> steps = m_InnerStrides;
+            const size_t count = m_InnerSize;
+
+            size_t row = begin;
+            for (size_t d = R; d-- > 0;) {
+                shape[d] = m_Shape[d];
+                index[d] = row % shape[d];
+                row /= shape[d];
+                for (size_t k = 0; k < N; k++) {
+                    strides[d][k] = m_Strides[k][d];
+                    rewind[d][k] = strides[d][k] * (shape[d] - 1);
+                    offsets[k] += index[d] * strides[d][k];
+                }
+            }
+
+            if constexpr (R > 0) {
+                bool gathers = false;
+                for (size_t k = 0; k < N; k++) {
+                    gathers |= steps[k] > 1 && strides[R - 1][k] < steps[k];
+                }
+                tiled = tiled && gathers && count > TileColumns;
+            }
+
+            for (size_t r = begin; r < end;) {
+                size_t block = 1;
+                if constexpr (R > 0) {
+                    if (tiled) block = std::min({TileRows, end - r, shape[R - 1] - index[R - 1]});
+                }
+                if (block == 1) {
+                    rowFn(std::as_const(offsets), steps, count);
+                } else {
+                    // Rows of the block differ only in the last outer index, which stays inside its dimension
+                    for (size_t c = 0; c < count; c += TileColumns) {
+                        const size_t n = std::min(TileColumns, count - c);
+                        for (size_t i = 0; i < block; i++) {
+                            std::array<size_t, N> pieces;
+                            for (size_t k = 0; k < N; k++) {
+                                pieces[k] = offsets[k] + c * steps[k] + i * strides[R - 1][k];
+                            }
+                            rowFn(std::as_const(pieces), steps, n);
+                        }
+                    }
+                    index[R - 1] += block - 1;
+                    for (size_t k = 0; k < N; k++) offsets[k] += (block - 1) * strides[R - 1][k];
+                }
+                r += block;
+
+                for (size_t d = R; d-- > 0;) {
+                    if (++index[d] < shape[d]) {
+                        for (size_t k = 0; k < N; k++) offsets[k] += strides[d][k];
+                        break;
+                    }
+                    index[d] = 0;
+                    for (size_t k = 0; k < N; k++) offsets[k] -= rewind[d][k];
+                }
+            }
+        }
+    };
+
+    /**
+     *  @brief Calls rowFn(offsets, innerStrides, count) for every inner row of the N operands
+     * **/
+    template<size_t N, typename RowFn>
+    void ForEachStrided(const Dims& shape,
+                        const std::array<const Dims*, N>& strides,
+                        const std::array<size_t, N>& offsets,
+                        RowFn&& rowFn) {
+        const StridedIterator<N> it{shape, strides, offsets};
+        it.ForRows(0, it.Rows(), rowFn);
+    }
+
+    /**
+     *  @brief ForEachStrided split across the intra-op thread pool
+     *
+     *  Rows are handed out in ranges of at least grain elements, so rowFn must only touch the elements of
+     *  the row it is given. Small tensors stay on the calling thread. Rows that gather from a transposed
+     *  operand may arrive in several pieces, each with the offsets of its first element.
+     * **/
+    template<size_t N, typename RowFn>
+    void ParallelForEachStrided(const Dims& shape,
+                                const std::array<const Dims*, N>& strides,
+                                const std::array<size_t, N>& offsets,
+                                RowFn&& rowFn,
+                                size_t grain = DefaultGrainSize) {
+        StridedIterator<N> it{shape, strides, offsets};
+        if (it.Rows() == 0) return;
+        NEXT_PROFILE_WALK(it.Rows(), std::any_of(it.InnerStrides().begin(), it.InnerStrides().end(),
+                                                 [](size_t stride) { return stride > 1; }));
+        it.OrderForTiles();
+        const size_t rowGrain = (grain + it.InnerSize() - 1) / it.InnerSize();
+
+        Next::ParallelFor(0, it.Rows(), rowGrain, [&it, &rowFn](size_t begin, size_t end) {
+            it.ForRows(begin, end, rowFn, true);
+        });
+    }
+}
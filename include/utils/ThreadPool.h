@@ -0,0 +1,248 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Next {
+    //*
+    //@brief Intra-op thread pool: one deque per worker, owners pop from the back and idle workers steal from the front.
+    //*/
+    class ThreadPool {
+    private:
+        using Task = std::function<void()>;
+
+        struct Queue {
+            std::mutex m_Mutex;
+            std::deque<Task> m_Tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> m_Queues;   // One queue per worker
+        std::vector<std::thread> m_Workers;
+        std::mutex m_WakeMutex;
+        std::condition_variable m_WakeCondition;
+        std::atomic<size_t> m_Pending{0};               // Tasks pushed but not yet taken
+        std::atomic<size_t> m_NextQueue{0};             // Round-robin target for external pushes
+        bool m_Stop{false};
+
+        static size_t& WorkerIndex() {
+            static thread_local size_t index = SIZE_MAX;
+            return index;
+        }
+
+        bool TryPop(size_t self, Task& task) {
+            {
+                auto& own = *m_Queues[self];
+                std::lock_guard lock{own.m_Mutex};
+                if (!own.m_Tasks.empty()) {
+                    task = std::move(own.m_Tasks.back());
+                    own.m_Tasks.pop_back();
+                    return true;
+                }
+            }
+            for (size_t i = 1; i < m_Queues.size(); i++) {
+                auto& victim = *m_Queues[(self + i) % m_Queues.size()];
+                std::lock_guard lock{victim.m_Mutex};
+                if (!victim.m_Tasks.empty()) {
+                    task = std::move(victim.m_Tasks.front());
+                    victim.m_Tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void WorkerLoop(size_t self) {
+            WorkerIndex() = self;
+            while (true) {
+                Task task;
+                if (TryPop(self, task)) {
+                    m_Pending.fetch_sub(1, std::memory_order_relaxed);
+                    task();
+                    continue;
+                }
+                std::unique_lock lock{m_WakeMutex};
+                m_WakeCondition.wait(lock, [this] { return m_Stop || m_Pending.load() > 0; });
+                if (m_Stop && m_Pending.load() == 0) return;
+            }
+        }
+
+    public:
+        explicit ThreadPool(size_t threads) {
+            threads = std::max<size_t>(threads, 1);
+            for (size_t i = 0; i < threads; i++) {
+                m_Queues.push_back(std::make_unique<Queue>());
+            }
+            for (size_t i = 0; i < threads; i++) {
+                m_Workers.emplace_back([this, i] { WorkerLoop(i); });
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard lock{m_WakeMutex};
+                m_Stop = true;
+            }
+            m_WakeCondition.notify_all();
+            for (auto& worker : m_Workers) {
+                worker.join();
+            }
+        }
+
+        [[nodiscard]] size_t Size() const { return m_Workers.size(); }
+
+        /**
+         *  @brief Whether the calling thread is one of this pool's workers
+         * **/
+        [[nodiscard]] bool InWorker() const { return WorkerIndex() < m_Queues.size(); }
+
+        void Submit(Task task) {
+            const size_t target = InWorker() ? WorkerIndex()
+                                             : m_NextQueue.fetch_add(1, std::memory_order_relaxed) % m_Queues.size();
+            {
+                auto& queue = *m_Queues[target];
+                std::lock_guard lock{queue.m_Mutex};
+                queue.m_Tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard lock{m_WakeMutex};
+                m_Pending.fetch_add(1);
+            }
+            m_WakeCondition.notify_one();
+        }
+    };
+
+    namespace Detail {
+        struct ParallelState {
+            std::mutex m_Mutex;
+            std::shared_ptr<ThreadPool> m_Pool;
+            size_t m_Threads{std::max<size_t>(std::thread::hardware_concurrency(), 1)};
+        };
+
+        inline ParallelState& Parallel() {
+            static ParallelState state;
+            return state;
+        }
+
+        inline thread_local bool t_InParallelRegion = false;
+    }
+
+    /**
+     *  @brief Number of threads intra-op parallel loops may use (default: hardware concurrency)
+     * **/
+    inline size_t GetNumThreads() {
+        auto& state = Detail::Parallel();
+        std::lock_guard lock{state.m_Mutex};
+        return state.m_Threads;
+    }
+
+    /**
+     *  @brief Set the intra-op thread count; 1 makes every op serial. The pool is rebuilt lazily, loops that
+     *  are already running keep the old one until they finish
+     * **/
+    inline void SetNumThreads(size_t threads) {
+        auto& state = Detail::Parallel();
+        std::lock_guard lock{state.m_Mutex};
+        state.m_Threads = std::max<size_t>(threads, 1);
+        state.m_Pool.reset();
+    }
+
+    /**
+     *  @brief Minimum number of elements worth handing to another thread
+     * **/
+    inline constexpr size_t DefaultGrainSize = 32768;
+
+    /**
+     *  @brief Run fn(begin, end) over [begin, end) split into chunks of at least grain iterations
+     *
+     *  Ranges smaller than two grains, nested calls and SetNumThreads(1) run inline on the caller. The
+     *  caller works on chunks too and the first exception thrown by any chunk is rethrown here.
+     * **/
+    template<typename Fn>
+    void ParallelFor(size_t begin, size_t end, size_t grain, Fn&& fn) {
+        if (begin >= end) return;
+        const size_t total = end - begin;
+        grain = std::max<size_t>(grain, 1);
+
+        std::shared_ptr<ThreadPool> pool;
+        size_t threads = 1;
+        if (total >= 2 * grain && !Detail::t_InParallelRegion) {
+            auto& state = Detail::Parallel();
+            std::lock_guard lock{state.m_Mutex};
+            if (state.m_Threads > 1) {
+                if (!state.m_Pool) {
+                    // The caller takes part in the work, so the pool holds one thread less
+                    state.m_Pool = std::make_shared<ThreadPool>(state.m_Threads - 1);
+                }
+                pool = state.m_Pool;
+                threads = state.m_Threads;
+            }
+        }
+        if (pool == nullptr) {
+            fn(begin, end);
+            return;
+        }
+
+        // A few chunks per thread so stealing can even out uneven chunks
+        const size_t chunks = std::min(total / grain, threads * 4);
+        const size_t chunkSize = (total + chunks - 1) / chunks;
+
+        struct Shared {
+            std::atomic<size_t> m_Next{0};
+            std::atomic<size_t> m_Done{0};
+            std::mutex m_Mutex;
+            std::condition_variable m_Finished;
+            std::exception_ptr m_Error;
+        };
+        auto shared = std::make_shared<Shared>();
+
+        auto work = [shared, &fn, begin, end, chunks, chunkSize] {
+            const bool wasInRegion = Detail::t_InParallelRegion;
+            Detail::t_InParallelRegion = true;
+            size_t chunk;
+            while ((chunk = shared->m_Next.fetch_add(1)) < chunks) {
+                const size_t from = begin + chunk * chunkSize;
+                const size_t to = std::min(end, from + chunkSize);
+                if (from < to) {
+                    try {
+                        fn(from, to);
+                    } catch (...) {
+                        std::lock_guard lock{shared->m_Mutex};
+                        if (!shared->m_Error) shared->m_Error = std::current_exception();
+                    }
+                }
+                if (shared->m_Done.fetch_add(1) + 1 == chunks) {
+                    std::lock_guard lock{shared->m_Mutex};
+                    shared->m_Finished.notify_all();
+                }
+            }
+            Detail::t_InParallelRegion = wasInRegion;
+        };
+
+        const size_t helpers = std::min(threads - 1, chunks - 1);
+        for (size_t i = 0; i < helpers; i++) {
+            pool->Submit(work);
+        }
+        work();
+
+        std::unique_lock lock{shared->m_Mutex};
+        shared->m_Finished.wait(lock, [&shared, chunks] { return shared->m_Done.load() == chunks; });
+        if (shared->m_Error) {
+            std::rethrow_exception(shared->m_Error);
+        }
+    }
+}
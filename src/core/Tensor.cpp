@@ -0,0 +1,186 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#include "../../include/core/Tensor.h"
+
+namespace Next {
+    namespace {
+        using Simd::BinaryOp;
+
+        /**
+         *  @brief Whether operands of types A and B compute in T, see PromoteTypes (math ops continue from an
+         *  integer DType to FLOAT32)
+         * **/
+        template<typename A, typename B, typename T, bool IsMath>
+        constexpr bool PromotesTo() {
+            DType common = PromoteTypes(TypeToDType<A>::value, TypeToDType<B>::value);
+            if (IsMath && !IsFloatingDType(common)) common = DType::FLOAT32;
+            return common == TypeToDType<T>::value;
+        }
+
+        /**
+         *  @brief fn(a.As<A>(), b.As<B>()) with the element types of a and b, which must compute in T
+         *
+         *  Only the pairs that promote to T reach fn, so the mixed-DType kernels are instantiated once per
+         *  pair in total and not once per pair and table.
+         * **/
+        template<typename T, typename Result, bool IsMath = false, typename Fn>
+        Result VisitPromoted(const Tensor& a, const Tensor& b, Fn&& fn) {
+            return VisitDType(a.GetDType(), [&]<typename TagA>(TagA) -> Result {
+                return VisitDType(b.GetDType(), [&]<typename TagB>(TagB) -> Result {
+                    using A = typename TagA::Type;
+                    using B = typename TagB::Type;
+                    if constexpr (PromotesTo<A, B, T, IsMath>()) {
+                        return fn(a.As<A>(), b.As<B>());
+                    } else {
+                        throw std::runtime_error(std::string("DType mismatch: ") + DTypeName(a.GetDType()) +
+                                                 " and " + DTypeName(b.GetDType()) + " do not promote to " +
+                                                 DTypeName(TypeToDType<T>::value));
+                    }
+                });
+            });
+        }
+
+        template<typename T, BinaryOp Op>
+        Tensor BinaryKernel(const Tensor& a, const Tensor& b) {
+            return VisitPromoted<T, Tensor>(a, b, [](const auto& lhs, const auto& rhs) -> Tensor {
+                return NextTensor<T>::template promoted_binary<Op>(lhs, rhs);
+            });
+        }
+
+        template<typename T, BinaryOp Op>
+        Tensor ScalarKernel(const Tensor& a, double scalar, bool scalarFirst) {
+            const auto lhs = a.As<T>();
+            const auto value = static_cast<T>(scalar);
+            if constexpr (Op == BinaryOp::ADD) return lhs.add(value);
+            else if constexpr (Op == BinaryOp::SUB) return scalarFirst ? lhs.rsub(value) : lhs.sub(value);
+            else if constexpr (Op == BinaryOp::MUL) return lhs.mult(value);
+            else return scalarFirst ? lhs.rdivide(value) : lhs.divide(value);
+        }
+
+        template<typename T, BinaryOp Op>
+        void BinaryInPlaceKernel(Tensor& a, const Tensor& b) {
+            auto lhs = a.As<T>();
+            VisitPromoted<T, void>(a, b, [&](const auto&, const auto& rhs) {
+                NextTensor<T>::template promoted_binary<Op>(lhs, rhs, lhs);
+            });
+        }
+
+        template<typename T, BinaryOp Op>
+        void BinaryOutKernel(const Tensor& a, const Tensor& b, Tensor& out) {
+            auto dst = out.As<T>();
+            VisitPromoted<T, void>(a, b, [&](const auto& lhs, const auto& rhs) {
+                NextTensor<T>::template promoted_binary<Op>(lhs, rhs, dst);
+            });
+        }
+
+        template<typename T, Reduce::Kind K>
+        Tensor ReduceKernel(const Tensor& a, const Dims& axes, bool keepdim) {
+            const auto t = a.As<T>();
+            if constexpr (K == Reduce::Kind::SUM) return t.sum(axes, keepdim);
+            else if constexpr (K == Reduce::Kind::PROD) return t.prod(axes, keepdim);
+            else if constexpr (K == Reduce::Kind::MAX) return t.max(axes, keepdim);
+            else return t.min(axes, keepdim);
+        }
+
+        template<typename T, bool IsMax>
+        Tensor ArgReduceKernel(const Tensor& a, size_t axis, bool keepdim) {
+            const auto t = a.As<T>();
+            if constexpr (IsMax) return t.argmax(axis, keepdim);
+            else return t.argmin(axis, keepdim);
+        }
+
+        template<typename T, bool Accumulate>
+        void ScatterKernel(Tensor& dst, size_t dim, const Tensor& index, const Tensor& src) {
+            auto n_Dst = dst.As<T>();
+            if constexpr (Accumulate) n_Dst.scatter_add(dim, index.As<int64_t>(), src.As<T>());
+            else n_Dst.scatter(dim, index.As<int64_t>(), src.As<T>());
+        }
+
+        template<typename T>
+        Tensor UnaryKernel(const Tensor& a, Math::UnaryOp op, const Tensor* bias, Tensor* out) {
+            if constexpr (Math::HasMath<T>) {
+                // Without a bias a stands in for it, so that both operands are visited the same way
+                return VisitPromoted<T, Tensor, true>(a, bias ? *bias : a, [&](const auto& t, const auto& n_Bias) -> Tensor {
+                    const auto* biasTensor = bias ? &n_Bias : nullptr;
+                    if (out == nullptr) return NextTensor<T>::promoted_activation(t, op, biasTensor);
+                    auto dst = out->As<T>();
+                    NextTensor<T>::promoted_activation(t, op, biasTensor, dst);
+                    return *out;
+                });
+            } else {
+                throw std::runtime_error(std::string("Math error: ") + DTypeName(TypeToDType<T>::value) +
+                                         " is not a floating point DType");
+            }
+        }
+
+        template<typename T>
+        TensorKernels MakeKernels() {
+            TensorKernels kernels{};
+            kernels.Zeros = [](const Dims& shape) -> Tensor { return NextTensor<T>{shape}; };
+            kernels.Binary = {&BinaryKernel<T, BinaryOp::ADD>, &BinaryKernel<T, BinaryOp::SUB>,
+                              &BinaryKernel<T, BinaryOp::MUL>, &BinaryKernel<T, BinaryOp::DIV>};
+            kernels.Scalar = {&ScalarKernel<T, BinaryOp::ADD>, &ScalarKernel<T, BinaryOp::SUB>,
+                              &ScalarKernel<T, BinaryOp::MUL>, &ScalarKernel<T, BinaryOp::DIV>};
+            kernels.BinaryInPlace = {&BinaryInPlaceKernel<T, BinaryOp::ADD>, &BinaryInPlaceKernel<T, BinaryOp::SUB>,
+                                     &BinaryInPlaceKernel<T, BinaryOp::MUL>, &BinaryInPlaceKernel<T, BinaryOp::DIV>};
+            kernels.BinaryOut = {&BinaryOutKernel<T, BinaryOp::ADD>, &BinaryOutKernel<T, BinaryOp::SUB>,
+                                 &BinaryOutKernel<T, BinaryOp::MUL>, &BinaryOutKernel<T, BinaryOp::DIV>};
+            kernels.Fill = [](Tensor& a, double value) { a.As<T>().fill(static_cast<T>(value)); };
+            kernels.Reduce = {&ReduceKernel<T, Reduce::Kind::SUM>, &ReduceKernel<T, Reduce::Kind::PROD>,
+                              &ReduceKernel<T, Reduce::Kind::MAX>, &ReduceKernel<T, Reduce::Kind::MIN>};
+            kernels.Mean = [](const Tensor& a, const Dims& axes, bool keepdim) -> Tensor {
+                return a.As<T>().mean(axes, keepdim);
+            };
+            kernels.ArgReduce = {&ArgReduceKernel<T, false>, &ArgReduceKernel<T, true>};
+            kernels.IndexSelect = [](const Tensor& a, size_t dim, const Tensor& index) -> Tensor {
+                return a.As<T>().index_select(dim, index.As<int64_t>());
+            };
+            kernels.Gather = [](const Tensor& a, size_t dim, const Tensor& index) -> Tensor {
+                return a.As<T>().gather(dim, index.As<int64_t>());
+            };
+            kernels.Scatter = {&ScatterKernel<T, false>, &ScatterKernel<T, true>};
+            kernels.MaskedSelect = [](const Tensor& a, const Tensor& mask) -> Tensor {
+                return a.As<T>().masked_select(mask.As<bool>());
+            };
+            kernels.Matmul = [](const Tensor& a, const Tensor& b) -> Tensor {
+                return VisitPromoted<T, Tensor>(a, b, [](const auto& lhs, const auto& rhs) -> Tensor {
+                    return NextTensor<T>::promoted_matmul(lhs, rhs);
+                });
+            };
+            kernels.MatmulOut = [](const Tensor& a, const Tensor& b, Tensor& out) {
+                auto dst = out.As<T>();
+                VisitPromoted<T, void>(a, b, [&](const auto& lhs, const auto& rhs) {
+                    NextTensor<T>::promoted_matmul(lhs, rhs, dst);
+                });
+            };
+            kernels.Unary = &UnaryKernel<T>;
+            kernels.Reshape = [](const Tensor& a, const Dims& shape) -> Tensor { return a.As<T>().reshape(shape); };
+            kernels.Clone = [](const Tensor& a) -> Tensor { return a.As<T>().clone(); };
+            kernels.CopyFrom = [](Tensor& dst, const Tensor& src) {
+                auto n_Dst = dst.As<T>();
+                VisitDType(src.GetDType(), [&]<typename Tag>(Tag) {
+                    n_Dst.copy_from(src.As<typename Tag::Type>());
+                });
+            };
+            kernels.Item = [](const Tensor& a) {
+                const auto t = a.As<T>();
+                return static_cast<double>(t.Data()[t.Offset()]);
+            };
+            kernels.To = [](const Tensor& a, DType dtype) -> Tensor {
+                return VisitDType(dtype, [&]<typename Tag>(Tag) -> Tensor {
+                    return a.As<T>().template to<typename Tag::Type>();
+                });
+            };
+            return kernels;
+        }
+    }
+
+    const TensorKernels& KernelsFor(DType dtype) {
+        return VisitDType(dtype, []<typename Tag>(Tag) -> const TensorKernels& {
+            static const TensorKernels kernels = MakeKernels<typename Tag::Type>();
+            return kernels;
+        });
+    }
+}
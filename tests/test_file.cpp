@@ -0,0 +1,94 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/NextFile.h"
+#include "utils/NextStream.h"
+
+namespace {
+    // A float tensor file of 4 elements whose header claims the given shape and strides
+    std::string WriteCraftedFile(const std::string& name, const std::vector<uint64_t>& shape,
+                                 const std::vector<uint64_t>& strides) {
+        const std::string path = testing::TempDir() + name;
+        Next::FileHeader header{};
+        std::memcpy(header.Magic, Next::FileMagic, sizeof(Next::FileMagic));
+        header.Version = Next::FileVersion;
+        header.DataType = static_cast<uint32_t>(Next::TypeToDType<float>::value);
+        header.Rank = shape.size();
+        header.Alignment = 64;
+        const size_t dimsEnd = sizeof(header) + 2 * shape.size() * sizeof(uint64_t);
+        header.DataOffset = (dimsEnd + 63) / 64 * 64;
+        header.DataBytes = 4 * sizeof(float);
+
+        std::vector<uint64_t> dims(shape);
+        dims.insert(dims.end(), strides.begin(), strides.end());
+        const std::vector<char> padding(header.DataOffset - dimsEnd, 0);
+        const float data[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(dims.data()), static_cast<std::streamsize>(dims.size() * sizeof(uint64_t)));
+        file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        file.write(reinterpret_cast<const char*>(data), sizeof(data));
+        return path;
+    }
+
+    void ExpectRejectedByEveryLoader(const std::string& path) {
+        EXPECT_THROW(Next::LoadTensor<float>(path), std::runtime_error);
+#if NEXT_HAS_MMAP
+        EXPECT_THROW(Next::LoadTensorMapped<float>(path), std::runtime_error);
+#endif
+        EXPECT_THROW(Next::TensorReader<float>(path, 1), std::runtime_error);
+    }
+
+    TEST(TensorFile, RoundTrip) {
+        const std::string path = testing::TempDir() + "round_trip.nxt";
+        Next::NextTensor<float> tensor{{2, 3}};
+        for (size_t i = 0; i < tensor.Size(); i++) tensor[i] = static_cast<float>(i);
+        Next::SaveTensor(std::as_const(tensor).transpose(0, 1), path);
+        const auto loaded = Next::LoadTensor<float>(path);
+        ASSERT_EQ(loaded.Shape(), (Next::Dims{3, 2}));
+        for (size_t i = 0; i < 3; i++) {
+            for (size_t j = 0; j < 2; j++) EXPECT_EQ(loaded(i, j), tensor(j, i));
+        }
+    }
+
+    TEST(TensorFile, InRangeStridesAreAccepted) {
+        // Two rows of two elements with stride 2: the last element is element 3 of 4
+        const auto path = WriteCraftedFile("in_range.nxt", {2, 2}, {2, 1});
+        const auto loaded = Next::LoadTensor<float>(path);
+        EXPECT_EQ(loaded(1, 1), 4.0f);
+    }
+
+    TEST(TensorFile, OffsetTermOverflowIsRejected) {
+        // (2^32 + 1 - 1) * 2^32 wraps to 0, which would put every element at offset 0
+        const auto path = WriteCraftedFile("offset_overflow.nxt", {(1ull << 32) + 1}, {1ull << 32});
+        ExpectRejectedByEveryLoader(path);
+    }
+
+    TEST(TensorFile, OffsetSumOverflowIsRejected) {
+        // Each term fits, their sum wraps around to 1
+        const auto path = WriteCraftedFile("sum_overflow.nxt", {2, 3}, {UINT64_MAX, 1});
+        ExpectRejectedByEveryLoader(path);
+    }
+
+    TEST(TensorFile, SizeOverflowIsRejected) {
+        // 2^32 * 2^32 elements wraps to an empty tensor
+        const auto path = WriteCraftedFile("size_overflow.nxt", {1ull << 32, 1ull << 32}, {0, 0});
+        ExpectRejectedByEveryLoader(path);
+    }
+
+    TEST(TensorFile, OutOfRangeElementIsRejected) {
+        const auto path = WriteCraftedFile("out_of_range.nxt", {5}, {1});
+        ExpectRejectedByEveryLoader(path);
+    }
+}
@@ -0,0 +1,212 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "utils/NextMath.h"
+
+namespace {
+    using Next::Math::UnaryOp;
+
+    /**
+     *  @brief Selects an ISA for one test and restores the previous one afterwards
+     * **/
+    class IsaScope {
+    private:
+        Next::Simd::ISA m_Previous;
+
+    public:
+        explicit IsaScope(Next::Simd::ISA isa) : m_Previous(Next::Simd::GetISA()) { Next::Simd::SetISA(isa); }
+
+        ~IsaScope() { Next::Simd::SetISA(m_Previous); }
+    };
+
+    bool HasVectorMath() {
+#if NEXT_SIMD_X86
+        return Next::Simd::DetectISA() >= Next::Simd::ISA::AVX2 && __builtin_cpu_supports("fma");
+#else
+        return false;
+#endif
+    }
+
+    float FromBits(uint32_t bits) {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    uint32_t ToBits(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    double Reference(UnaryOp op, double x) {
+        switch (op) {
+            case UnaryOp::EXP: return Next::Math::ScalarApply<UnaryOp::EXP>(x);
+            case UnaryOp::LOG: return Next::Math::ScalarApply<UnaryOp::LOG>(x);
+            case UnaryOp::TANH: return Next::Math::ScalarApply<UnaryOp::TANH>(x);
+            case UnaryOp::SIGMOID: return Next::Math::ScalarApply<UnaryOp::SIGMOID>(x);
+            case UnaryOp::GELU: return Next::Math::ScalarApply<UnaryOp::GELU>(x);
+            default: return Next::Math::ScalarApply<UnaryOp::RELU>(x);
+        }
+    }
+
+    // Error of got in units of the float spacing at the reference rounded to float (2^-149 for the
+    // subnormals); a reference that rounds to inf is only matched by inf itself
+    double UlpError(float got, double reference) {
+        const auto rounded = static_cast<float>(reference);
+        if (std::isinf(got) || std::isinf(rounded)) return got == rounded ? 0.0 : std::numeric_limits<double>::infinity();
+        const int exponent = rounded == 0.0f ? -126 : std::max(std::ilogb(rounded), -126);
+        return std::fabs(static_cast<double>(got) - reference) / std::ldexp(1.0, exponent - 23);
+    }
+
+    void Apply(UnaryOp op, float* out, const float* a, size_t n) {
+        Next::Math::Kernels<float>().Row[static_cast<size_t>(op)](out, a, nullptr, 0, n);
+    }
+
+    struct SweepResult {
+        double MaxUlp{0.0};
+        double MaxAbsBelowGeluRange{0.0};
+        size_t NanMismatches{0};
+    };
+
+    // Every step-th float bit pattern; a step of 37 is the measurement behind the bounds documented in
+    // NextMath.h
+    SweepResult Sweep(UnaryOp op, uint64_t step) {
+        constexpr size_t Block = 4096;
+        std::vector<float> in(Block), out(Block);
+        SweepResult result;
+        for (uint64_t bits = 0; bits <= UINT32_MAX;) {
+            size_t n = 0;
+            for (; n < Block && bits <= UINT32_MAX; n++, bits += step) in[n] = FromBits(static_cast<uint32_t>(bits));
+            Apply(op, out.data(), in.data(), n);
+            for (size_t i = 0; i < n; i++) {
+                const double reference = Reference(op, in[i]);
+                if (std::isnan(reference) || std::isnan(out[i])) {
+                    result.NanMismatches += std::isnan(reference) != std::isnan(out[i]);
+                } else if (op == UnaryOp::GELU && in[i] < -2.0f) {
+                    const double error = std::fabs(static_cast<double>(out[i]) - reference);
+                    result.MaxAbsBelowGeluRange = std::max(result.MaxAbsBelowGeluRange, error);
+                } else {
+                    result.MaxUlp = std::max(result.MaxUlp, UlpError(out[i], reference));
+                }
+            }
+        }
+        return result;
+    }
+
+    void ExpectAccurate(UnaryOp op, double maxUlp, uint64_t step) {
+        const SweepResult result = Sweep(op, step);
+        EXPECT_EQ(result.NanMismatches, 0u) << Next::Math::OpName(op);
+        EXPECT_LE(result.MaxUlp, maxUlp) << Next::Math::OpName(op);
+        if (op == UnaryOp::GELU) {
+            EXPECT_LT(result.MaxAbsBelowGeluRange, 6e-7);
+        }
+    }
+
+    const std::vector<float>& SpecialValues() {
+        static const std::vector<float> values = {
+            0.0f, -0.0f, INFINITY, -INFINITY, NAN, -NAN,
+            FLT_TRUE_MIN, -FLT_TRUE_MIN, FLT_MIN - FLT_TRUE_MIN, -(FLT_MIN - FLT_TRUE_MIN), FLT_MIN, -FLT_MIN,
+            FLT_MAX, -FLT_MAX, 1.0f, -1.0f, 88.72f, 88.73f, -87.0f, -103.0f, -104.5f, 0.625f, -0.625f};
+        return values;
+    }
+
+    // Special values must come out as std:: gives them: NaN for NaN, zeros and infinities with their sign,
+    // everything else within the documented error
+    void ExpectSpecialValues(UnaryOp op, double maxUlp) {
+        const auto& in = SpecialValues();
+        std::vector<float> out(in.size());
+        Apply(op, out.data(), in.data(), in.size());
+        for (size_t i = 0; i < in.size(); i++) {
+            const double reference = Reference(op, in[i]);
+            const auto expected = static_cast<float>(reference);
+            if (std::isnan(reference)) {
+                EXPECT_TRUE(std::isnan(out[i])) << Next::Math::OpName(op) << "(" << in[i] << ") = " << out[i];
+            } else if (expected == 0.0f || std::isinf(expected)) {
+                EXPECT_EQ(ToBits(out[i]), ToBits(expected))
+                    << Next::Math::OpName(op) << "(" << in[i] << ") = " << out[i] << ", expected " << expected;
+            } else {
+                EXPECT_LE(UlpError(out[i], reference), maxUlp)
+                    << Next::Math::OpName(op) << "(" << in[i] << ") = " << out[i] << ", expected " << reference;
+            }
+        }
+    }
+
+    struct Bound {
+        UnaryOp Op;
+        double MaxUlp;
+    };
+
+    constexpr Bound Bounds[] = {{UnaryOp::EXP, 1.01}, {UnaryOp::LOG, 0.8}, {UnaryOp::TANH, 1.31},
+                                {UnaryOp::SIGMOID, 2.32}, {UnaryOp::GELU, 9.0}, {UnaryOp::RELU, 0.0}};
+
+    class MathSweep : public testing::TestWithParam<Bound> {};
+
+    TEST_P(MathSweep, VectorWithinDocumentedBound) {
+        if (!HasVectorMath()) GTEST_SKIP() << "AVX2 + FMA not available";
+        IsaScope isa{Next::Simd::ISA::AVX2};
+        ExpectAccurate(GetParam().Op, GetParam().MaxUlp, 37);
+    }
+
+    // The fallback evaluates float in double; a coarser sweep keeps the test short
+    TEST_P(MathSweep, ScalarWithinDocumentedBound) {
+        IsaScope isa{Next::Simd::ISA::SCALAR};
+        ExpectAccurate(GetParam().Op, GetParam().MaxUlp, 997);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(Ops, MathSweep, testing::ValuesIn(Bounds),
+                             [](const testing::TestParamInfo<Bound>& info) {
+                                 return std::string(Next::Math::OpName(info.param.Op));
+                             });
+
+    TEST(MathAccuracy, SpecialValues) {
+        for (const auto isa : {Next::Simd::ISA::SCALAR, Next::Simd::ISA::AVX2}) {
+            if (isa == Next::Simd::ISA::AVX2 && !HasVectorMath()) continue;
+            IsaScope scope{isa};
+            for (const auto& bound : Bounds) ExpectSpecialValues(bound.Op, bound.MaxUlp);
+        }
+    }
+
+    // The AVX2 rows finish with a zero-padded vector; every tail length must give exactly what the same
+    // element gets inside the 8-wide body, with and without a bias
+    TEST(MathAccuracy, VectorTailMatchesBody) {
+        if (!HasVectorMath()) GTEST_SKIP() << "AVX2 + FMA not available";
+        IsaScope isa{Next::Simd::ISA::AVX2};
+        constexpr size_t Width = 8;
+        std::vector<float> in(2 * Width), bias(2 * Width);
+        for (size_t i = 0; i < in.size(); i++) {
+            in[i] = -9.5f + 1.37f * static_cast<float>(i);
+            bias[i] = 0.25f - 0.03f * static_cast<float>(i);
+        }
+        const auto& kernels = Next::Math::Kernels<float>();
+        for (const auto& bound : Bounds) {
+            const auto row = kernels.Row[static_cast<size_t>(bound.Op)];
+            for (size_t biasStep = 0; biasStep <= 2; biasStep++) {
+                // biasStep 2 stands for no bias
+                const float* b = biasStep == 2 ? nullptr : bias.data();
+                const size_t step = biasStep == 2 ? 0 : biasStep;
+                std::vector<float> body(2 * Width);
+                row(body.data(), in.data(), b, step, body.size());
+                for (size_t n = Width + 1; n < 2 * Width; n++) {
+                    std::vector<float> tail(n);
+                    row(tail.data(), in.data(), b, step, n);
+                    for (size_t i = 0; i < n; i++) {
+                        EXPECT_EQ(ToBits(tail[i]), ToBits(body[i]))
+                            << Next::Math::OpName(bound.Op) << " n = " << n << " i = " << i;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "core/Tensor.h"
+
+namespace {
+    /**
+     *  @brief Routes tensor storage to a fresh SystemAllocator for one test and restores the previous one
+     * **/
+    class CountingScope {
+    private:
+        std::shared_ptr<Next::Allocator> m_Previous;
+        std::shared_ptr<Next::SystemAllocator> m_Counting;
+
+    public:
+        CountingScope() : m_Previous(Next::GetAllocator()), m_Counting(std::make_shared<Next::SystemAllocator>()) {
+            Next::SetAllocator(m_Counting);
+        }
+
+        ~CountingScope() { Next::SetAllocator(m_Previous); }
+
+        [[nodiscard]] size_t Allocations() const { return m_Counting->Stats().Allocations; }
+    };
+
+    TEST(OutputForms, RuntimeTypedInPlaceOutFormDoesNotAllocate) {
+        CountingScope allocations;
+        Next::Tensor x{{512, 512}, Next::DType::FLOAT32};
+        Next::Tensor y{{512, 512}, Next::DType::FLOAT32};
+        x.ones();
+        y.ones();
+        x.add(y, x);
+        const size_t warm = allocations.Allocations();
+        for (int i = 0; i < 10; i++) {
+            x.add(y, x);
+            x.mult(y, x);
+            x += y;
+        }
+        EXPECT_EQ(allocations.Allocations(), warm);
+        EXPECT_EQ(x.As<float>()(3, 4), 22.0f);
+    }
+
+    TEST(OutputForms, TypedInPlaceOutFormDoesNotAllocate) {
+        CountingScope allocations;
+        Next::NextTensor<float> a{{512, 512}};
+        Next::NextTensor<float> b{{512, 512}};
+        a.fill(1.0f);
+        b.fill(2.0f);
+        a.add(b, a);
+        const size_t warm = allocations.Allocations();
+        for (int i = 0; i < 10; i++) a.add(b, a);
+        EXPECT_EQ(allocations.Allocations(), warm);
+        EXPECT_EQ(std::as_const(a)(0, 0), 23.0f);
+    }
+}
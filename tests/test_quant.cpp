@@ -0,0 +1,130 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/QuantizedTensor.h"
+
+namespace {
+    using Next::Simd::ISA;
+
+    /**
+     *  @brief Selects an ISA for one block of a test and restores the previous one afterwards
+     * **/
+    class IsaScope {
+    private:
+        ISA m_Previous;
+
+    public:
+        explicit IsaScope(ISA isa) : m_Previous(Next::Simd::GetISA()) { Next::Simd::SetISA(isa); }
+
+        ~IsaScope() { Next::Simd::SetISA(m_Previous); }
+    };
+
+    // Every level the CPU has, each one selecting a different int8 micro-kernel where one exists
+    std::vector<ISA> AvailableIsas() {
+        std::vector<ISA> isas;
+        for (const auto isa : {ISA::SCALAR, ISA::SSE41, ISA::AVX2, ISA::AVX512}) {
+            if (isa <= Next::Simd::DetectISA()) isas.push_back(isa);
+        }
+        return isas;
+    }
+
+    // Uniform over the whole int8 range, -128 included
+    Next::NextTensor<int8_t> RandomInt8(const Next::Dims& shape, uint32_t seed) {
+        Next::NextTensor<int8_t> tensor{shape};
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(-128, 127);
+        for (size_t i = 0; i < tensor.Size(); i++) tensor[i] = static_cast<int8_t>(dist(rng));
+        return tensor;
+    }
+
+    Next::NextTensor<float> RandomFloat(const Next::Dims& shape, uint32_t seed, float low, float high) {
+        Next::NextTensor<float> tensor{shape};
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(low, high);
+        for (size_t i = 0; i < tensor.Size(); i++) tensor[i] = dist(rng);
+        return tensor;
+    }
+
+    void ExpectMatchesNaive(const Next::NextTensor<int8_t>& a, const Next::NextTensor<int8_t>& b) {
+        const size_t m = a.Shape()[0], k = a.Shape()[1], n = b.Shape()[1];
+        const auto c = Next::MatmulInt32(a, b);
+        ASSERT_EQ(c.Shape(), (Next::Dims{m, n}));
+        size_t mismatches = 0;
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) {
+                int32_t expected = 0;
+                for (size_t p = 0; p < k; p++) expected += int32_t{a(i, p)} * int32_t{b(p, j)};
+                if (c(i, j) != expected && mismatches++ < 5) {
+                    ADD_FAILURE() << "c(" << i << ", " << j << ") = " << c(i, j) << ", expected " << expected
+                                  << " for m = " << m << " k = " << k << " n = " << n;
+                }
+            }
+        }
+        EXPECT_EQ(mismatches, 0u);
+    }
+
+    struct GemmShape {
+        size_t M, K, N;
+    };
+
+    // k below, at and off multiples of 4, k across two KC (512) blocks, n across two NC (2048) blocks and
+    // m across two MC (96) blocks, each with partial MR x NR tiles
+    constexpr GemmShape Shapes[] = {{1, 1, 1},    {5, 7, 3},     {4, 16, 16},  {13, 3, 17},
+                                    {37, 515, 19}, {6, 9, 2050}, {100, 13, 33}, {3, 1030, 2053}};
+
+    TEST(GemmInt8, MatchesNaiveLoopAtEveryIsa) {
+        for (const auto isa : AvailableIsas()) {
+            IsaScope scope{isa};
+            SCOPED_TRACE("ISA " + std::to_string(static_cast<int>(isa)));
+            for (const auto& shape : Shapes) {
+                ExpectMatchesNaive(RandomInt8({shape.M, shape.K}, 1), RandomInt8({shape.K, shape.N}, 2));
+            }
+        }
+    }
+
+    TEST(GemmInt8, StridedOperands) {
+        for (const auto isa : AvailableIsas()) {
+            IsaScope scope{isa};
+            SCOPED_TRACE("ISA " + std::to_string(static_cast<int>(isa)));
+            const auto a = RandomInt8({21, 40}, 3).slice(1, 3, 38);
+            const auto b = RandomInt8({18, 35}, 4).transpose(0, 1);
+            ExpectMatchesNaive(a, b);
+        }
+    }
+
+    // The requantized product must be the float product of the dequantized operands rounded to the output
+    // grid: within half an output step, plus float rounding of the reference
+    void ExpectMatchesDequantized(const Next::QuantizedTensor& a, const Next::QuantizedTensor& b) {
+        const auto reference = a.dequantize().matmul(b.dequantize());
+        const auto output = Next::ChooseQuantParams(reference);
+        const auto product = a.matmul(b, output).dequantize();
+        const float step = output.Scales[0];
+        float worst = 0.0f;
+        for (size_t i = 0; i < reference.Size(); i++) {
+            worst = std::max(worst, std::fabs(product[i] - reference[i]));
+        }
+        EXPECT_LE(worst, 0.5f * step * (1.0f + 1e-3f)) << "output step " << step;
+    }
+
+    TEST(QuantizedMatmul, MatchesDequantizedProduct) {
+        const auto lhs = RandomFloat({37, 515}, 5, -1.5f, 2.5f);
+        const auto rhs = RandomFloat({515, 40}, 6, -0.8f, 0.6f);
+        for (const auto isa : AvailableIsas()) {
+            IsaScope scope{isa};
+            SCOPED_TRACE("ISA " + std::to_string(static_cast<int>(isa)));
+            const auto a = Next::Quantize(lhs);
+            ExpectMatchesDequantized(a, Next::Quantize(rhs));
+            ExpectMatchesDequantized(a, Next::Quantize(rhs, std::nullopt, true));
+            ExpectMatchesDequantized(a, Next::Quantize(rhs, size_t{1}, true));
+            ExpectMatchesDequantized(a, Next::Quantize(rhs, size_t{1}));
+        }
+    }
+}
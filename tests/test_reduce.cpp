@@ -0,0 +1,77 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include "core/NextTensor.h"
+
+namespace {
+    template<typename T>
+    Next::NextTensor<T> Filled(const Next::Dims& shape, T value) {
+        Next::NextTensor<T> tensor{shape};
+        tensor.fill(value);
+        return tensor;
+    }
+
+    TEST(Mean, IntegerSumDoesNotWrap) {
+        Next::NextTensor<uint8_t> a{{2}};
+        a[0] = 200;
+        a[1] = 100;
+        EXPECT_EQ(a.mean()[0], 150);
+    }
+
+    TEST(Mean, IntegerCountDoesNotWrap) {
+        // 256 elements: a count converted to uint8_t would be 0
+        const auto a = Filled<uint8_t>({256}, 7);
+        EXPECT_EQ(a.mean()[0], 7);
+        const auto b = Filled<int8_t>({2, 300}, -3);
+        EXPECT_EQ(b.mean({1})[1], -3);
+    }
+
+    TEST(Mean, IntegerTruncatesTowardZero) {
+        Next::NextTensor<int32_t> a{{3}};
+        a[0] = -1;
+        a[1] = -1;
+        a[2] = 0;
+        EXPECT_EQ(a.mean()[0], 0);
+        a[2] = 5;
+        EXPECT_EQ(a.mean()[0], 1);
+    }
+
+    TEST(Mean, HalfAccumulatesInFloat) {
+        // 70000 exceeds the Half range, a sum held in Half overflows to inf
+        const auto a = Filled<Next::Half>({70000}, Next::Half(1.0f));
+        EXPECT_EQ(static_cast<float>(a.mean()[0]), 1.0f);
+        const auto b = Filled<Next::BFloat16>({70000}, Next::BFloat16(0.5f));
+        EXPECT_EQ(static_cast<float>(b.mean()[0]), 0.5f);
+    }
+
+    TEST(Mean, AxesKeepdimAndOut) {
+        Next::NextTensor<uint8_t> a{{2, 3}};
+        for (size_t i = 0; i < a.Size(); i++) a[i] = static_cast<uint8_t>(250 + i);
+        const auto rows = a.mean({1}, true);
+        ASSERT_EQ(rows.Shape(), (Next::Dims{2, 1}));
+        EXPECT_EQ(rows[0], 251);
+        EXPECT_EQ(rows[1], 254);
+
+        Next::NextTensor<uint8_t> cols{{3}};
+        a.mean({0}, cols);
+        EXPECT_EQ(cols[0], 251);
+        EXPECT_EQ(cols[2], 253);
+
+        Next::NextTensor<uint8_t> wrong{{2}};
+        EXPECT_THROW(a.mean({0}, wrong), std::runtime_error);
+    }
+
+    TEST(Mean, FloatUnchanged) {
+        Next::NextTensor<float> a{{4}};
+        for (size_t i = 0; i < a.Size(); i++) a[i] = static_cast<float>(i);
+        EXPECT_FLOAT_EQ(a.mean()[0], 1.5f);
+    }
+
+    TEST(Mean, EmptySelectionThrows) {
+        const Next::NextTensor<int32_t> a{{0, 3}};
+        EXPECT_THROW(a.mean({0}), std::runtime_error);
+    }
+}
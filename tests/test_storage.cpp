@@ -0,0 +1,85 @@
+//
+// Created by eren on 10/17/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <utility>
+
+#include "core/NextTensor.h"
+
+namespace {
+    Next::NextTensor<float> Iota(size_t n) {
+        Next::NextTensor<float> tensor{{n}};
+        for (size_t i = 0; i < n; i++) tensor[i] = static_cast<float>(i);
+        return tensor;
+    }
+
+    TEST(CopyOnWrite, ElementWriteAfterCopyDetaches) {
+        auto a = Iota(4);
+        a(0) = 10.0f;
+        const auto b = a;
+        a(1) = 20.0f;
+        a.at(2) = 30.0f;
+        EXPECT_EQ(b[0], 10.0f);
+        EXPECT_EQ(b[1], 1.0f);
+        EXPECT_EQ(b[2], 2.0f);
+        EXPECT_EQ(std::as_const(a)[1], 20.0f);
+        EXPECT_EQ(std::as_const(a)[2], 30.0f);
+        EXPECT_FALSE(a.IsShared());
+    }
+
+    TEST(CopyOnWrite, CopyWritesBeforeOriginal) {
+        auto a = Iota(4);
+        a[0] = 5.0f;
+        auto b = a;
+        b[0] = 7.0f;
+        a[0] = 6.0f;
+        EXPECT_EQ(std::as_const(a)[0], 6.0f);
+        EXPECT_EQ(std::as_const(b)[0], 7.0f);
+    }
+
+    TEST(CopyOnWrite, ViewsFollowTheDetach) {
+        auto a = Iota(6).reshape({2, 3});
+        auto row = a.slice(0, 1, 2);
+        const auto copy = a;
+        row(0, 0) = 42.0f;
+        EXPECT_EQ(std::as_const(a)(1, 0), 42.0f);
+        EXPECT_EQ(copy(1, 0), 3.0f);
+    }
+
+    TEST(CopyOnWrite, VersionCountsWritesAfterEachRead) {
+        auto a = Iota(4);
+        const uint64_t v0 = a.Version();
+        a[0] = 1.0f;
+        a[1] = 1.0f;
+        const uint64_t v1 = a.Version();
+        EXPECT_GT(v1, v0);
+        EXPECT_EQ(a.Version(), v1);
+        a(2) = 1.0f;
+        EXPECT_GT(a.Version(), v1);
+    }
+
+    TEST(CopyOnWrite, CopyIsNotAnOverlappingDestination) {
+        const auto a = Iota(4).reshape({2, 2});
+        const auto b = Iota(4).reshape({2, 2});
+        auto c = a;
+        a.matmul(b, c);
+        EXPECT_EQ(std::as_const(c)(1, 1), 11.0f);
+        EXPECT_EQ(a(1, 1), 3.0f);
+
+        auto d = a;
+        a.transpose(0, 1).add(b, d);
+        EXPECT_EQ(std::as_const(d)(0, 1), 3.0f);
+        EXPECT_EQ(std::as_const(d)(1, 0), 3.0f);
+        EXPECT_EQ(a(0, 1), 1.0f);
+    }
+
+    TEST(CopyOnWrite, ViewIsStillAnOverlappingDestination) {
+        auto a = Iota(4).reshape({2, 2});
+        const auto b = Iota(4).reshape({2, 2});
+        auto view = a.alias();
+        EXPECT_THROW(a.matmul(b, view), std::runtime_error);
+        EXPECT_THROW(a.transpose(0, 1).add(b, view), std::runtime_error);
+    }
+}